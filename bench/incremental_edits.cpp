@@ -0,0 +1,122 @@
+// Incremental repair of small edit batches against a full recompute, behind
+// the patch/recompute decision in src/DynamicHyperbolicity.cpp
+// (PATCH_TRIPLE_COST). Graphs are a ring plus n/2 random chords with integer
+// weights 1..10; every batch inserts, reweights or removes 1-3 chords and is
+// checked against a fresh engine. Build and run from the repository root:
+//   g++ -std=c++17 -O3 -fopenmp -Iinclude bench/incremental_edits.cpp src/DynamicHyperbolicity.cpp \
+//       src/Hyperbolicity.cpp src/MaxMinProduct.cpp src/MatrixMemory.cpp src/ShortestPath.cpp -o incremental_edits
+//   ./incremental_edits [n ...]          (default 200 400; 20 batches each)
+#include "DynamicHyperbolicity.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+using AdjacencyList = std::vector<std::vector<std::pair<int, double>>>;
+
+constexpr int BATCHES = 20;
+
+AdjacencyList ring_with_chords(int n, std::mt19937& rng, std::vector<std::pair<int, int>>& chords) {
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::uniform_int_distribution<int> weight(1, 10);
+    AdjacencyList adj_list(n);
+    auto add = [&](int u, int v) {
+        const double w = weight(rng);
+        adj_list[u].emplace_back(v, w);
+        adj_list[v].emplace_back(u, w);
+    };
+    for (int v = 0; v < n; ++v) add(v, (v + 1) % n);
+    for (int c = 0; c < n / 2; ++c) {
+        const int u = vertex(rng), v = vertex(rng);
+        if (u == v || std::abs(u - v) == 1 || std::abs(u - v) == n - 1) continue;
+        add(u, v);
+        chords.emplace_back(u, v);
+    }
+    return adj_list;
+}
+
+double milliseconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+// Runs the batches on one set of tracked bases; false if a result disagrees
+bool run(int n, const std::vector<int>& bases, const char* name) {
+    std::mt19937 rng(n);
+    std::vector<std::pair<int, int>> chords;
+    AdjacencyList adj_list = ring_with_chords(n, rng, chords);
+
+    auto start = std::chrono::steady_clock::now();
+    DynamicHyperbolicity engine(adj_list, bases);
+    engine.initialize(MaxMinBackend::Dense);
+    const double full_ms = milliseconds_since(start);
+
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::uniform_int_distribution<int> weight(1, 10);
+    std::uniform_int_distribution<int> edits(1, 3);
+    std::vector<double> batch_ms;
+    size_t changed = 0;
+    int patched = 0, recomputed = 0, bounded = 0, full = 0;
+    for (int b = 0; b < BATCHES; ++b) {
+        std::vector<EdgeUpdate> batch;
+        for (int e = edits(rng); e > 0; --e) {
+            const int kind = rng() % 3;
+            if (kind == 0 || chords.empty()) {
+                const int u = vertex(rng), v = vertex(rng);
+                if (u == v) continue;
+                batch.push_back({u, v, static_cast<double>(weight(rng))});
+                chords.emplace_back(u, v);
+            } else {
+                const size_t c = rng() % chords.size();
+                batch.push_back({chords[c].first, chords[c].second,
+                                 kind == 1 ? static_cast<double>(weight(rng)) : INFINITY});
+                if (kind == 2) chords.erase(chords.begin() + c);
+            }
+        }
+        const DynamicUpdateStats stats = engine.apply(batch);
+        batch_ms.push_back(stats.elapsed_ms);
+        changed += stats.changed_pairs;
+        patched += stats.bases_patched;
+        recomputed += stats.bases_recomputed;
+        bounded += stats.bases_bounded;
+        full += stats.full_recompute;
+
+        DynamicHyperbolicity fresh(engine.adjacency_list(), bases);
+        fresh.initialize(MaxMinBackend::Dense);
+        if (fresh.distance_matrix() != engine.distance_matrix() ||
+            std::abs(fresh.max_base_delta() - engine.max_base_delta()) > 1e-9) {
+            std::fprintf(stderr, "%s, n = %d, batch %d: %g incrementally vs %g fresh\n", name, n, b,
+                         engine.max_base_delta(), fresh.max_base_delta());
+            return false;
+        }
+    }
+    std::printf("%-9s %5d %10.1f %10.1f %10.1f %9.0f %8.1f %8.1f %8.1f %5d\n", name, n, full_ms, median(batch_ms),
+                *std::max_element(batch_ms.begin(), batch_ms.end()), static_cast<double>(changed) / BATCHES,
+                static_cast<double>(patched) / BATCHES, static_cast<double>(recomputed) / BATCHES,
+                static_cast<double>(bounded) / BATCHES, full);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<int> sizes;
+    for (int a = 1; a < argc; ++a) sizes.push_back(std::atoi(argv[a]));
+    if (sizes.empty()) sizes = {200, 400};
+
+    std::printf("%-9s %5s %10s %10s %10s %9s %8s %8s %8s %5s\n", "bases", "n", "full ms", "median ms", "max ms",
+                "changed", "patched", "rerun", "bounded", "full");
+    for (int n : sizes) {
+        if (!run(n, {}, "all") || !run(n, {0}, "one")) return 1;
+    }
+    return 0;
+}
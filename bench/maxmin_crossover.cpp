@@ -0,0 +1,91 @@
+// Single-base timings of the two max-min product kernels, behind the Auto
+// crossover in src/MaxMinProduct.cpp (AUTO_CROSSOVER_N, AUTO_MAX_LEVELS).
+// Graphs are a ring plus n/2 random chords with hop-count, integer 1..10 or
+// real weights. Build and run from the repository root:
+//   g++ -std=c++17 -O3 -fopenmp -Iinclude bench/maxmin_crossover.cpp src/Hyperbolicity.cpp \
+//       src/MaxMinProduct.cpp src/MatrixMemory.cpp src/ShortestPath.cpp -o maxmin_crossover
+//   ./maxmin_crossover [n ...]          (default 100 200 400 800 1600)
+#include "Hyperbolicity.h"
+#include "ShortestPath.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+enum class Weights { Hops, Integer, Real };
+
+std::vector<std::vector<std::pair<int, double>>> ring_with_chords(int n, Weights weights, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::uniform_int_distribution<int> integer(1, 10);
+    std::uniform_real_distribution<double> real(1.0, 10.0);
+    auto weight = [&]() {
+        switch (weights) {
+        case Weights::Hops: return 1.0;
+        case Weights::Integer: return static_cast<double>(integer(rng));
+        case Weights::Real: return real(rng);
+        }
+        return 1.0;
+    };
+    std::vector<std::vector<std::pair<int, double>>> adj_list(n);
+    auto add = [&](int u, int v) {
+        const double w = weight();
+        adj_list[u].emplace_back(v, w);
+        adj_list[v].emplace_back(u, w);
+    };
+    for (int v = 0; v < n; ++v) add(v, (v + 1) % n);
+    for (int c = 0; c < n / 2; ++c) {
+        const int u = vertex(rng), v = vertex(rng);
+        if (u != v) add(u, v);
+    }
+    return adj_list;
+}
+
+double seconds_for_base(const std::vector<std::vector<double>>& distances, MaxMinBackend backend, double& delta) {
+    HyperbolicityCalculator calc(distances);
+    calc.set_max_min_backend(backend);
+    auto start = std::chrono::steady_clock::now();
+    delta = calc.compute_for_base(0);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Distinct finite Gromov products of base 0: the threshold levels (capped)
+int gromov_levels(const std::vector<std::vector<double>>& d, int cap) {
+    std::set<double> seen;
+    const int n = d.size();
+    for (int i = 0; i < n && static_cast<int>(seen.size()) <= cap; ++i) {
+        for (int j = 0; j < n; ++j) seen.insert(0.5 * (d[0][i] + d[0][j] - d[i][j]));
+    }
+    return seen.size();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<int> sizes;
+    for (int a = 1; a < argc; ++a) sizes.push_back(std::atoi(argv[a]));
+    if (sizes.empty()) sizes = {100, 200, 400, 800, 1600};
+
+    const struct { Weights weights; const char* name; } kinds[] = {
+        {Weights::Hops, "hops"}, {Weights::Integer, "int 1..10"}, {Weights::Real, "real"}};
+    std::printf("%-10s %6s %7s %10s %10s %8s\n", "weights", "n", "levels", "dense s", "bitset s", "ratio");
+    for (const auto& kind : kinds) {
+        for (int n : sizes) {
+            const auto distances = ShortestPath(ring_with_chords(n, kind.weights, 1)).compute_all_pairs();
+            double dense_delta = 0.0, bitset_delta = 0.0;
+            const double dense = seconds_for_base(distances, MaxMinBackend::Dense, dense_delta);
+            const double bitset = seconds_for_base(distances, MaxMinBackend::ThresholdBitset, bitset_delta);
+            if (dense_delta != bitset_delta) {
+                std::fprintf(stderr, "Kernels disagree at n = %d: %g vs %g\n", n, dense_delta, bitset_delta);
+                return 1;
+            }
+            std::printf("%-10s %6d %7d %10.3f %10.3f %8.2f\n", kind.name, n, gromov_levels(distances, 9999), dense,
+                        bitset, dense / bitset);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Single-core timings behind the cost model constants in src/Planner.cpp
+// (SSSP_NS, DENSE_NS, BITSET_NS, HEURISTIC_NS, LOG_NS, LABEL_*). Every engine
+// runs once per graph on one thread; each constant is the least-squares fit
+// through the origin of the measured times against its model term. Build and
+// run from the repository root:
+//   g++ -std=c++17 -O3 -fopenmp -Iinclude bench/planner_calibration.cpp src/GraphParser.cpp \
+//       src/ShortestPath.cpp src/Hyperbolicity.cpp src/MaxMinProduct.cpp src/MatrixMemory.cpp \
+//       src/2Factor.cpp src/Eccentricity.cpp src/LogApproximation.cpp src/DistanceOracle.cpp src/MappedFile.cpp \
+//       -o planner_calibration
+//   ./planner_calibration [graph.csv ...]
+// (default: the cyclic_graph_{100,1000}_nodes.csv evaluation graphs; the
+// 10000-vertex one adds about ten minutes for its dense base)
+#include "GraphParser.h"
+#include "ShortestPath.h"
+#include "Hyperbolicity.h"
+#include "2Factor.h"
+#include "LogApproximation.h"
+#include "DistanceOracle.h"
+#include <omp.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double nanoseconds_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// Measured time and model term of one constant over all graphs
+struct Fit {
+    const char* name;
+    double current;
+    double sum_tx = 0.0;
+    double sum_xx = 0.0;
+    void add(double ns, double term) {
+        if (term <= 0) return;
+        sum_tx += ns * term;
+        sum_xx += term * term;
+        std::printf("  %-22s %10.3f\n", name, ns / term);
+    }
+    double value() const { return sum_xx > 0 ? sum_tx / sum_xx : 0.0; }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    for (int a = 1; a < argc; ++a) files.push_back(argv[a]);
+    if (files.empty()) {
+        files = {"Evaluation Datasets/cyclic_graph_100_nodes.csv", "Evaluation Datasets/cyclic_graph_1000_nodes.csv"};
+    }
+    omp_set_num_threads(1);
+
+    Fit sssp{"SSSP_NS", 5.2}, dense{"DENSE_NS", 0.67}, bitset{"BITSET_NS", 0.52}, heuristic{"HEURISTIC_NS", 2.0},
+        log{"LOG_NS", 10.0}, label_ns{"LABEL_NS", 350.0}, label_pair{"LABEL_PAIR_NS", 8.0},
+        label_entries{"LABEL_ENTRIES_PER_ROOT", 1.5};
+
+    for (const std::string& file : files) {
+        GraphParser parser;
+        parser.parse(file);
+        const auto& adj_list = parser.get_adjacency_list();
+        const double n = adj_list.size();
+        double entries = 0;
+        for (const auto& neighbours : adj_list) entries += neighbours.size();
+        std::printf("%s: n = %.0f, %.0f adjacency entries\n", file.c_str(), n, entries);
+
+        auto start = Clock::now();
+        const auto distances = ShortestPath(adj_list).compute_all_pairs();
+        sssp.add(nanoseconds_since(start), n * (n + entries) * std::log2(std::max(2.0, n)));
+
+        // Levels as the planner counts them: diameter + 1 for integral weights
+        double diameter = 0.0;
+        for (const auto& row : distances) {
+            for (double d : row) {
+                if (std::isfinite(d)) diameter = std::max(diameter, d);
+            }
+        }
+        const double levels = diameter + 1;
+
+        HyperbolicityCalculator dense_calc(distances);
+        start = Clock::now();
+        dense_calc.compute_for_base(0);
+        dense.add(nanoseconds_since(start), n * n * n);
+
+        HyperbolicityCalculator bitset_calc(distances);
+        bitset_calc.set_max_min_backend(MaxMinBackend::ThresholdBitset);
+        start = Clock::now();
+        bitset_calc.compute_for_base(0);
+        bitset.add(nanoseconds_since(start), n * n * n * levels / 64.0);
+
+        // Base heuristic: eccentricity ranking with no base evaluated
+        start = Clock::now();
+        TwoFactorApproximation(distances).compute_multi_base(0, BaseSelection::Eccentricity);
+        heuristic.add(nanoseconds_since(start), n * n);
+
+        start = Clock::now();
+        LogApproxHyperbolicity(distances, adj_list).compute_approximate_hyperbolicity();
+        log.add(nanoseconds_since(start), n * n);
+
+        DistanceOracle oracle(adj_list);
+        start = Clock::now();
+        if (!oracle.build_labels()) {
+            std::printf("  labels exceed the size cap; oracle constants skipped\n");
+            continue;
+        }
+        const double label_build_ns = nanoseconds_since(start);
+        const double label = oracle.label_entries() / n;
+        label_entries.add(label, std::sqrt(n));
+        label_ns.add(label_build_ns, label * n);
+        start = Clock::now();
+        LogApproxHyperbolicity(oracle, adj_list).compute_approximate_hyperbolicity();
+        label_pair.add(nanoseconds_since(start), n * n / 2);
+    }
+
+    std::printf("\n%-24s %10s %10s\n", "constant", "fitted", "in use");
+    for (const Fit* fit : {&sssp, &dense, &bitset, &heuristic, &log, &label_ns, &label_pair, &label_entries}) {
+        std::printf("%-24s %10.3f %10.3f\n", fit->name, fit->value(), fit->current);
+    }
+    return 0;
+}
@@ -1,15 +1,59 @@
 #pragma once
 #include <vector>
+#include <utility>
+#include "MaxMinProduct.h"
+#include "Hyperbolicity.h"
+
+class EccentricityEngine;
+
+// How the bases of a multi-base run are picked
+enum class BaseSelection {
+    Eccentricity,   // largest eccentricity first (same heuristic as the single-base mode)
+    Centrality,     // smallest total distance (closeness) first
+    Random
+};
+
+struct MultiBaseResult {
+    std::vector<int> bases;
+    std::vector<double> base_deltas;  // delta_r for each entry of bases
+    double lower_bound = 0.0;         // max_r delta_r  (delta >= delta_r for every r)
+    double upper_bound = 0.0;         // 2 * min_r delta_r  (delta <= 2 * delta_r for every r)
+    BaseWitness witness;              // Quadruple of the base giving the lower bound
+};
 
 class TwoFactorApproximation {
 public:
     explicit TwoFactorApproximation(const std::vector<std::vector<double>>& dist_matrix);
+    // With an eccentricity engine on the same graph, bases are chosen from its
+    // bounds instead of a matrix scan; searches it has already run are reused
+    TwoFactorApproximation(const std::vector<std::vector<double>>& dist_matrix, EccentricityEngine& eccentricity);
     double compute_approximate_hyperbolicity();
 
+    // Evaluates k bases in one batched pass and returns the tightest bounds
+    MultiBaseResult compute_multi_base(int k, BaseSelection selection, unsigned int seed = 0);
+
+    // Bounds from the given bases. known_deltas holds delta_r per vertex (NaN =
+    // not yet evaluated); only the missing bases are run, and they are stored,
+    // with their witnesses in known_witnesses if given (one per vertex).
+    MultiBaseResult evaluate_bases(const std::vector<int>& bases, std::vector<double>& known_deltas,
+                                   std::vector<BaseWitness>* known_witnesses = nullptr);
+
+    void set_max_min_backend(MaxMinBackend backend) { max_min_backend = backend; }
+    void set_matrix_memory(const MatrixMemoryConfig& config) { memory_config = config; }
+
+    // Base choices of the single- and multi-base modes, without evaluating them.
+    // ids, if given, is an original id per vertex of a renumbered matrix:
+    // candidates are then ranked in that order, so ties and random draws pick
+    // the same vertices as on the matrix in original order.
+    int select_base_heuristic() const;
+    std::vector<int> select_bases(int k, BaseSelection selection, unsigned int seed,
+                                  const std::vector<int>& ids = {}) const;
+
 private:
     const std::vector<std::vector<double>>& distances;
+    EccentricityEngine* eccentricity_engine = nullptr;
+    MaxMinBackend max_min_backend = MaxMinBackend::Dense;
+    MatrixMemoryConfig memory_config;
     
-    // Eccentricity-based heuristic
-    int select_base_heuristic() const;
-    std::vector<double> compute_eccentricities() const;  // O(n^2) time
-};
\ No newline at end of file
+    std::vector<double> compute_eccentricities() const;  // O(n^2) time without an engine, else bounded searches
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+#include <utility>
+
+// One connected component with its own compact (local) adjacency list
+struct GraphComponent {
+    std::vector<int> vertices;  // Global vertex ids, ascending; local id = position
+    std::vector<std::vector<std::pair<int, double>>> adj_list;
+};
+
+// Splits a graph into connected components, largest first
+class ConnectedComponents {
+public:
+    explicit ConnectedComponents(const std::vector<std::vector<std::pair<int, double>>>& adj_list);
+
+    const std::vector<GraphComponent>& components() const { return parts; }
+    int component_of(int v) const { return membership[v]; }
+    int count() const { return parts.size(); }
+
+private:
+    std::vector<GraphComponent> parts;
+    std::vector<int> membership;  // Global vertex id -> index into parts
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// Random-access shortest-path distances without a dense n x n matrix.
+//
+// Exact mode builds a pruned landmark labeling (Akiba et al.): vertices are
+// processed as hubs in decreasing degree order, each running a Dijkstra that
+// is pruned wherever the labels built so far already certify the distance.
+// A query is a merge of two short sorted hub lists.
+//
+// Landmark mode keeps full single-source rows for k landmarks only and
+// answers with triangle-inequality bounds; it is the cheap fallback when the
+// labels would grow too large (dense or expander-like graphs).
+class DistanceOracle {
+public:
+    explicit DistanceOracle(const std::vector<std::vector<std::pair<int, double>>>& adj_list);
+
+    // Exact pruned landmark labels. Returns false (and leaves the labels
+    // empty) if the average label size exceeds max_avg_label.
+    bool build_labels(int max_avg_label = 1024);
+
+    // k landmarks, chosen farthest-first starting from the highest degree vertex
+    void build_landmarks(int k);
+
+    // Exact distance if labels are built, otherwise the landmark upper bound
+    double query(int u, int v) const;
+
+    // Landmark bounds lower <= d(u, v) <= upper (requires build_landmarks)
+    std::pair<double, double> bounds(int u, int v) const;
+
+    bool has_labels() const { return labels_built; }
+    int size() const { return n; }
+
+    // --- Reporting ---
+    double build_ms() const { return build_time_ms; }
+    size_t label_entries() const;
+    size_t memory_bytes() const;
+    // Average latency over random query pairs, in nanoseconds
+    double measure_query_ns(int samples = 100000, unsigned int seed = 0) const;
+
+private:
+    const std::vector<std::vector<std::pair<int, double>>>& adjacency_list;
+    int n;
+    bool labels_built = false;
+    double build_time_ms = 0.0;
+
+    // Labels as parallel arrays sorted by hub rank, each ending in a sentinel hub == n
+    std::vector<std::vector<std::uint32_t>> label_hubs;
+    std::vector<std::vector<double>> label_dists;
+    std::vector<int> rank_to_vertex;
+
+    std::vector<int> landmarks;
+    std::vector<std::vector<double>> landmark_dist;  // landmark_dist[l][v]
+
+    double label_query(int u, int v) const;
+};
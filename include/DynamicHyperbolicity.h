@@ -0,0 +1,117 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_set>
+#include "Hyperbolicity.h"
+
+// Sets the weight of the undirected edge {u, v}. A missing edge is inserted;
+// weight = +infinity removes it.
+struct EdgeUpdate {
+    int u;
+    int v;
+    double weight;
+};
+
+struct DynamicUpdateStats {
+    int repaired_sources = 0;     // Rows patched in place (insertions / decreases)
+    int recomputed_sources = 0;   // Rows rerun with Dijkstra (increases / removals)
+    size_t changed_pairs = 0;     // Distinct {s, t} whose distance changed
+    int bases_patched = 0;        // delta_r updated from the affected triples only
+    int bases_recomputed = 0;     // delta_r recomputed from scratch
+    int bases_bounded = 0;        // All-bases mode: left at an upper bound below delta
+    bool full_recompute = false;  // Repair would have cost more than APSP plus every base
+    double elapsed_ms = 0.0;
+};
+
+// Keeps the distance matrix and delta_r of a set of tracked bases current
+// under edge edits, instead of a full APSP plus engine run per change.
+//
+// Distances: a decrease of {u, v} to w only shortens paths through the edge,
+//   d'(s, t) = min(d(s, t), d(s, u) + w + d(v, t), d(s, v) + w + d(u, t)),
+// applied to the sources it improves. An increase can only affect sources for
+// which the old edge was tight; only those rows are rerun.
+//
+// Deltas: delta_r is a max over triples (i, j, k) of a value that depends on
+// the six distances among {r, i, j, k}. If the stored witness triple has no
+// changed pair its value is unchanged, so the new delta_r is
+// max(old delta_r, values of the affected triples). Otherwise (or when the
+// affected set is too large) delta_r is recomputed.
+//
+// With every vertex tracked (exact hyperbolicity), delta_r is the largest
+// four-point value over the quadruples containing r, so each quadruple with a
+// changed pair is evaluated once and raises all four of its bases. A base
+// whose witness changed keeps its old delta_r as an upper bound, and is only
+// recomputed while that bound is above the largest exact delta_r: delta itself
+// stays exact without evaluating bases that cannot reach it.
+//
+// A batch whose repair would cost more than starting over (more rows rerun
+// than there are vertices, or so many changed pairs that no base could be
+// patched) falls back to a full APSP and every base recomputed.
+class DynamicHyperbolicity {
+public:
+    // bases empty = track every vertex (exact hyperbolicity)
+    DynamicHyperbolicity(const std::vector<std::vector<std::pair<int, double>>>& adj_list,
+                         const std::vector<int>& bases = {});
+
+    // Full APSP and base evaluation; must run before apply(). A distance matrix
+    // the caller already has for this graph can be handed over instead.
+    void initialize(MaxMinBackend backend = MaxMinBackend::Auto,
+                    std::vector<std::vector<double>> dist_matrix = {});
+
+    // Placement of the working matrices of later base evaluations
+    void set_matrix_memory(const MatrixMemoryConfig& config) { memory_config = config; }
+
+    // Appends an isolated vertex and returns its id
+    int add_vertex();
+
+    DynamicUpdateStats apply(const std::vector<EdgeUpdate>& batch);
+
+    // max over tracked bases of delta_r, and the witness of a base reaching it
+    double max_base_delta() const;
+    BaseWitness max_base_witness() const;
+    const std::vector<int>& tracked_bases() const { return bases; }
+    // In the all-bases mode an entry with base_exact() false is only an upper
+    // bound on delta_r (at most max_base_delta()), and its witness is stale
+    const std::vector<double>& base_deltas() const { return deltas; }
+    const std::vector<BaseWitness>& base_witnesses() const { return witnesses; }
+    bool base_exact(size_t b) const { return exact[b] != 0; }
+
+    const std::vector<std::vector<double>>& distance_matrix() const { return distances; }
+    // Pairs whose distance the last apply() changed, (min, max) each; empty
+    // with all_changed() when it fell back to a full recompute
+    const std::vector<std::pair<int, int>>& changed_pairs() const { return changed_list; }
+    bool all_changed() const { return every_pair_changed; }
+    const std::vector<std::vector<std::pair<int, double>>>& adjacency_list() const { return adjacency; }
+
+private:
+    std::vector<std::vector<std::pair<int, double>>> adjacency;
+    std::vector<std::vector<double>> distances;
+    bool track_all;
+    std::vector<int> bases;
+    std::vector<double> deltas;
+    std::vector<BaseWitness> witnesses;
+    std::vector<char> exact;           // deltas[b] is delta_r itself, realised by witnesses[b]
+    MaxMinBackend max_min_backend = MaxMinBackend::Auto;
+    MatrixMemoryConfig memory_config;
+
+    // Changed pairs of the current batch, packed as (min << 32) | max
+    std::unordered_set<std::uint64_t> changed;
+    std::vector<std::pair<int, int>> changed_list;
+    bool every_pair_changed = false;   // Too many to track: treat all as changed
+
+    double current_weight(int u, int v) const;
+    void set_weight(int u, int v, double weight);
+    void record_change(int s, int t);
+    bool pair_changed(int a, int b) const;
+
+    void decrease_edge(int u, int v, double weight, DynamicUpdateStats& stats);
+    void increase_edge(int u, int v, double old_weight, DynamicUpdateStats& stats);
+    void recompute_all(DynamicUpdateStats& stats);
+
+    bool witness_affected(const BaseWitness& w) const;
+    double gromov(int r, int x, int y) const;
+    double patch_base(int b);
+    void patch_all_bases(DynamicUpdateStats& stats);
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <utility>
+
+// Exact eccentricities, diameter and radius without all-pairs shortest paths.
+// Uses the Takes-Kosters bounding scheme: every single-source search from v
+// tightens lower/upper eccentricity bounds of all vertices via
+//   max(d(v,w), ecc(v) - d(v,w)) <= ecc(w) <= ecc(v) + d(v,w)
+// and vertices whose bounds meet are resolved without a search of their own.
+// Eccentricities are taken within each connected component. diameter() and
+// radius() stop as soon as the extremes are pinned down, which usually takes
+// far fewer searches than resolving every vertex.
+class EccentricityEngine {
+public:
+    explicit EccentricityEngine(const std::vector<std::vector<std::pair<int, double>>>& adj_list);
+
+    const std::vector<double>& compute_eccentricities();
+    double diameter();
+    double radius();
+
+    // A vertex of maximum eccentricity; needs only the diameter searches
+    int peripheral_vertex();
+
+    // Vertices sorted by decreasing eccentricity (ties broken by index)
+    std::vector<int> vertices_by_eccentricity();
+
+    // Number of single-source searches used so far
+    int searches_used() const { return searches; }
+
+private:
+    const std::vector<std::vector<std::pair<int, double>>>& adjacency_list;
+    int n;
+    int searches = 0;
+    bool all_resolved = false;
+    bool extremes_resolved = false;
+    bool pick_upper = true;
+
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::vector<char> done;
+    std::vector<double> ecc;
+
+    // all_vertices = false stops once diameter and radius are exact
+    void run_bounding(bool all_vertices);
+    void search_from(int v);
+};
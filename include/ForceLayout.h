@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <functional>
+
+struct LayoutPoint {
+    double x = 0.0;
+    double y = 0.0;
+};
+
+struct ForceLayoutOptions {
+    int iterations = 300;         // Coarsest level; finer levels run a quarter of this
+    double theta = 1.0;           // Barnes-Hut opening criterion (larger = coarser, faster)
+    double ideal_length = 30.0;   // Natural edge length in layout units
+    double gravity = 0.05;        // Pull towards the centre, keeps components together
+    double tolerance = 0.01;      // Stop once a step moves less than this * ideal_length
+    unsigned int seed = 1;
+};
+
+// Multilevel force-directed layout (spring-electrical model with adaptive step
+// length). The graph is coarsened by repeated matchings, the coarsest level is
+// laid out from random positions and each finer level is refined from the
+// level above. The O(n^2) repulsion is approximated by a Barnes-Hut quadtree,
+// giving O(n log n) per iteration, and is evaluated in parallel per vertex.
+// Edge weights are ignored: the drawing shows topology, not distances.
+class ForceLayout {
+public:
+    explicit ForceLayout(const std::vector<std::vector<std::pair<int, double>>>& adj_list);
+
+    // progress(iteration) is called once per iteration (counted over all
+    // levels); returning false stops the layout early
+    std::vector<LayoutPoint> compute(const ForceLayoutOptions& options = ForceLayoutOptions(),
+                                     const std::function<bool(int)>& progress = nullptr) const;
+
+private:
+    std::vector<std::vector<int>> neighbors;  // Undirected, deduplicated
+
+    struct QuadNode {
+        double cx, cy, half;          // Square cell
+        double mx = 0.0, my = 0.0;    // Centre of mass (sum until finalised)
+        double mass = 0.0;
+        int child[4] = {-1, -1, -1, -1};
+        int point = -1;               // Single vertex stored in a leaf
+    };
+
+    static void build_quadtree(const std::vector<LayoutPoint>& pos, std::vector<QuadNode>& tree);
+    // Runs up to iterations steps on one level; returns the running iteration
+    // count, or -1 if progress asked to stop
+    static int refine(const std::vector<std::vector<int>>& graph, std::vector<LayoutPoint>& pos,
+                      double step, int iterations, int done, const ForceLayoutOptions& options,
+                      const std::function<bool(int)>& progress);
+    static LayoutPoint repulsion(int v, const std::vector<LayoutPoint>& pos,
+                                 const std::vector<QuadNode>& tree, double theta, double strength);
+};
@@ -1,11 +1,18 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
 class GraphParser {
 public:
     void parse(const std::string& filename);
+    // {"edges": [{"source": .., "target": .., "weight": ..}, ...]}, with
+    // "links" accepted for "edges" and an optional "nodes" list of names or
+    // {"id": ..} objects for isolated vertices. Names may be strings or
+    // numbers; weight defaults to 1. The file is tokenised in place and every
+    // edge goes straight into the adjacency list. Throws on malformed input.
+    void parse_json(const std::string& filename);
     const std::vector<std::vector<std::pair<int, double>>>& get_adjacency_list() const;
     const std::vector<std::string>& get_nodes() const;
 
@@ -14,6 +21,8 @@ private:
     std::vector<std::string> nodes;
     std::vector<std::vector<std::pair<int, double>>> adjacency_list;
 
+    int intern(std::string_view node);
     void add_node(const std::string& node);
     void add_edge(const std::string& src, const std::string& dest, double weight);
-};
\ No newline at end of file
+    void add_edge(int u, int v, double weight);
+};
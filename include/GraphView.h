@@ -0,0 +1,82 @@
+#ifndef GRAPHVIEW_H
+#define GRAPHVIEW_H
+
+#include <QGraphicsView>
+#include <QFutureWatcher>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "ForceLayout.h"
+
+class Graph;
+class QGraphicsItem;
+class QGraphicsScene;
+
+// What the view draws: node names, every undirected edge once, and the layout
+struct GraphDrawing {
+    QVector<QString> names;
+    std::vector<std::pair<int, int>> edges;
+    std::vector<double> weights;
+    std::vector<LayoutPoint> positions;
+    double layout_ms = 0.0;
+};
+
+// Pan/zoom view for large graphs. The layout runs on a worker thread; the
+// scene holds one item per spatial tile, so Qt's BSP index culls everything
+// off screen. Detail follows the zoom level: bundled cell-to-cell edges and
+// bare points when zoomed out, individual edges and nodes further in, names
+// and weights only close up.
+class GraphView : public QGraphicsView
+{
+    Q_OBJECT
+
+public:
+    explicit GraphView(QWidget *parent = nullptr);
+    ~GraphView();
+
+    // Snapshots the graph and lays it out in the background; a layout still
+    // running for a previous graph is cancelled
+    void setGraph(const Graph* graph);
+    void clearGraph();
+    // Marks the named vertices (a witness quadruple or pair) and joins them;
+    // kept until the next setGraph, applied once a pending layout is done
+    void setHighlight(const QStringList& names);
+    // Colours each named vertex by its value, blue (smallest) to red
+    // (largest), e.g. the local delta map; empty values restore the plain
+    // colour. Kept until the next setGraph, like the highlight.
+    void setVertexValues(const QVector<QString>& names, const std::vector<double>& values);
+
+signals:
+    void layoutProgress(int iteration);
+    void layoutFinished(int nodes, int edges, double ms);
+
+protected:
+    void wheelEvent(QWheelEvent *event) override;
+
+private slots:
+    void onLayoutFinished();
+
+private:
+    QGraphicsScene *graphScene;
+    QFutureWatcher<std::shared_ptr<GraphDrawing>> *watcher;
+    std::shared_ptr<std::atomic<bool>> cancelFlag;
+    std::shared_ptr<const GraphDrawing> drawing;
+    QStringList highlighted;
+    QList<QGraphicsItem*> highlightItems;
+    QVector<QString> valueNames;
+    std::vector<double> vertexValues;
+    // Colour step per drawing vertex, shared with the tiles; empty = plain
+    std::shared_ptr<std::vector<unsigned char>> heat;
+
+    void cancelLayout();
+    void buildScene();
+    void buildHighlight();
+    void applyVertexValues();
+};
+
+#endif // GRAPHVIEW_H
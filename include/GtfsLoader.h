@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Transport graph read straight from a GTFS feed. Stops sharing a stop_name
+// are one vertex (as in WestYorkshireBusDataset.csv); two vertices are joined
+// when some trip serves them consecutively, weighted by the great-circle
+// distance in kilometres (the shortest one if several stop pairs map to it).
+struct GtfsGraph {
+    std::vector<std::string> nodes;   // Stop names, in stops.txt order; unserved stops are dropped
+
+    // CSR: the neighbours of v are targets[offsets[v] .. offsets[v + 1]),
+    // every edge stored in both directions
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<double> weights;
+
+    // Feed statistics
+    size_t stop_time_rows = 0;
+    size_t trips = 0;
+    bool resorted = false;            // stop_times.txt was not grouped by trip_id
+
+    size_t edge_count() const { return targets.size() / 2; }
+    std::vector<std::vector<std::pair<int, double>>> adjacency_list() const;
+};
+
+// Streams stops.txt and stop_times.txt of the feed in directory. Throws if
+// either file is missing or lacks a required column.
+GtfsGraph load_gtfs(const std::string& directory);
@@ -1,21 +1,69 @@
 #pragma once
 #include <vector>
 #include <utility>
+#include "MaxMinProduct.h"
+#include "MatrixMemory.h"
+
+// Cap on the Gromov product planes and their max-min products held at once
+// by compute_for_bases; larger base sets are evaluated in chunks
+constexpr size_t BATCH_MEMORY_BYTES = size_t(512) << 20;
+
+// Base r plus the triple realising delta_r:
+//   delta_r = min(A_r[i][k], A_r[k][j]) - A_r[i][j]
+// With delta_r = 0 the trivial triple (r, r, r) is reported.
+struct BaseWitness {
+    int r = -1;
+    int i = -1;
+    int j = -1;
+    int k = -1;
+};
+
+// Witness of the largest evaluated delta_r (NaN entries skipped); r = -1 if none
+BaseWitness strongest_witness(const std::vector<double>& base_deltas, const std::vector<BaseWitness>& base_witnesses);
 
 class HyperbolicityCalculator {
 public:
     explicit HyperbolicityCalculator(const std::vector<std::vector<double>>& dist_matrix);
+    // Row-major n x n matrix, e.g. a MappedDistanceMatrix; not copied
+    HyperbolicityCalculator(const double* dist_matrix, int n);
     double compute_for_base(int r);
-    double compute_exact_hyperbolicity();
+    double compute_for_base(int r, BaseWitness* witness);
+    // witness, if given, receives the quadruple of the base with the largest delta_r
+    double compute_exact_hyperbolicity(BaseWitness* witness = nullptr);
+    // Same, reusing base_deltas[r] for every base already evaluated (NaN =
+    // not yet); the missing entries are filled in, and so are the matching
+    // entries of base_witnesses if given (one per vertex)
+    double compute_exact_hyperbolicity(std::vector<double>& base_deltas,
+                                       std::vector<BaseWitness>* base_witnesses = nullptr);
+
+    // Batched variant: evaluates delta_r for as many bases as fit in
+    // BATCH_MEMORY_BYTES per pass over the distance matrix (at least one).
+    // Returns one delta per entry of bases (same order), and the matching
+    // witnesses if asked.
+    std::vector<double> compute_for_bases(const std::vector<int>& bases,
+                                          std::vector<BaseWitness>* witnesses = nullptr);
+
+    // Selects the (max,min) product kernel used by every base evaluation
+    void set_max_min_backend(MaxMinBackend backend) { max_min_backend = backend; }
+    // Placement of the working matrices of every base evaluation
+    void set_matrix_memory(const MatrixMemoryConfig& config) { memory_config = config; }
 
 
     
     
 private:
-    const std::vector<std::vector<double>>& distances;
+    std::vector<const double*> distances;  // Row pointers into the caller's matrix
+    MaxMinBackend max_min_backend = MaxMinBackend::Dense;
+    MatrixMemoryConfig memory_config;
     
-    std::vector<std::vector<double>> gromov_product_matrix(int r) const;
-    std::vector<std::vector<double>> max_min_product(const std::vector<std::vector<double>>& A) const;
+    // Row-major n x n; every row is written first by the thread that owns it
+    // under schedule(static), which is also the split of the consuming loops
+    MatrixBuffer<double> gromov_product_matrix(int r) const;
+    MatrixBuffer<double> max_min_product(const MatrixBuffer<double>& A) const;
+
+    // Planar layout for k bases: entry (i, j) of base b lives at (b*n + i)*n + j
+    MatrixBuffer<double> batched_gromov_products(const std::vector<int>& bases) const;
+    MatrixBuffer<double> batched_max_min_product(const MatrixBuffer<double>& A, int k) const;
     // std::vector<std::vector<double>> small_max_min_product(const std::vector<std::vector<double>>& A,
     // const std::vector<std::vector<double>>& B);
 };
\ No newline at end of file
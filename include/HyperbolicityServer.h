@@ -0,0 +1,96 @@
+#ifndef HYPERBOLICITYSERVER_H
+#define HYPERBOLICITYSERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <memory>
+
+class QIODevice;
+class QJsonObject;
+class QLocalServer;
+class QTcpServer;
+struct ComputeOptions;
+
+struct ServerOptions {
+    QString name = "hyperbolicity";   // Local socket name, or a full socket path
+    int port = 0;                     // Also listen on 127.0.0.1:port; 0 = local socket only
+    QByteArray token;                 // Sent by TCP clients before any request; needed with port
+    int workers = 2;                  // Requests computed at once
+    int max_pending = 32;             // Queued and running requests before new ones are refused
+    double memory_mb = 0.0;           // RAM running computes may plan for together; 0 = free at start
+};
+
+// Long-running service around the compute core. Loaded graphs stay in memory
+// with their ComputeCache (distances, delta_r, Log tree) and incremental
+// session, so repeated requests skip parsing and APSP, and a compute request
+// seen before is answered from its stored result until the graph is edited.
+//
+// Protocol: one JSON object per line in each direction. Every request names
+// an "op" and may carry an "id" that its response echoes; responses can
+// arrive out of order. Sockets are served on the event loop, the work runs on
+// a pool of `workers` threads, and once max_pending requests are outstanding
+// new ones are refused with "busy" instead of queued. Each compute also
+// reserves its predicted peak memory (planComputation) from a budget shared
+// by all requests, and is refused with "busy" while it does not fit.
+//
+// The local socket is owner-only. Anyone on the host can reach the TCP port,
+// so a TCP client's first line must be {"op": "auth", "token": ...}.
+class HyperbolicityServer : public QObject
+{
+public:
+    explicit HyperbolicityServer(const ServerOptions& options, QObject* parent = nullptr);
+    ~HyperbolicityServer();
+
+    // Opens the sockets; false with a message in error if one cannot be opened
+    bool listen(QString* error);
+
+    struct LoadedGraph;               // A graph kept in memory with its caches
+
+private:
+    ServerOptions options;
+    QLocalServer* localServer = nullptr;
+    QTcpServer* tcpServer = nullptr;
+    QThreadPool pool;
+    int threadsPerWorker = 1;         // OpenMP threads of each pool thread
+
+    QMutex graphsMutex;               // Guards graphs
+    QHash<QString, std::shared_ptr<LoadedGraph>> graphs;   // By name
+
+    QMutex budgetMutex;               // Guards reservedBytes
+    double budgetBytes = 0.0;         // ServerOptions::memory_mb; infinite if unknown
+    double reservedBytes = 0.0;       // Predicted peaks of the computes running now
+
+    // Event-loop thread only
+    int pending = 0;
+    long long served = 0;
+    long long rejected = 0;
+
+    template <class Socket>
+    void attach(Socket* socket, bool needsToken);
+    void handleLine(QIODevice* socket, const QByteArray& line);
+    void reply(QIODevice* socket, const QJsonObject& response);
+    QJsonObject statistics();
+    std::shared_ptr<LoadedGraph> findGraph(const QString& name);
+    // Charges the predicted peak of method on loaded to the budget and
+    // returns it; throws if it does not fit. Auto options are narrowed to the
+    // memory left, so the run plans within it. Needs loaded's cacheMutex.
+    double reserveMemory(LoadedGraph& loaded, const QString& method, ComputeOptions& options);
+    void releaseMemory(double bytes);
+
+    // Run on the pool; they throw std::invalid_argument on bad requests
+    QJsonObject load(const QJsonObject& request);
+    QJsonObject compute(const QJsonObject& request);
+    QJsonObject edit(const QJsonObject& request);
+    QJsonObject distance(const QJsonObject& request);
+};
+
+// Entry point of the service: hyperbolicity --serve [NAME] [--port N
+// --token-file FILE] [--workers N] [--max-pending N] [--memory-mb N]
+int runServer(const QStringList& arguments);
+
+#endif // HYPERBOLICITYSERVER_H
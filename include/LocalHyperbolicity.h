@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "Hyperbolicity.h"
+#include "MaxMinProduct.h"
+
+// Neighbourhood around each vertex
+enum class BallKind {
+    Hops,     // Vertices at most `size` edges away (size rounded down)
+    Radius    // Vertices at graph distance at most `size`
+};
+
+struct LocalOptions {
+    BallKind kind = BallKind::Hops;
+    double size = 2.0;
+    MaxMinBackend max_min_backend = MaxMinBackend::Auto;
+    MatrixMemoryConfig memory;          // Placement of each ball's working matrices
+};
+
+// delta of the ball around every vertex, one entry per vertex
+struct LocalProfile {
+    std::vector<double> delta;
+    std::vector<int> ball_size;
+    std::vector<BaseWitness> witness;   // Vertex ids of the graph; r = -1 when delta is 0
+
+    int distinct_balls = 0;             // Balls evaluated; equal vertex sets count once
+    int settled_early = 0;              // Balls that needed fewer bases than vertices
+    long long bases_evaluated = 0;
+};
+
+// Local hyperbolicity profile: the exact delta of every ball B(v) taken as a
+// subspace of the graph, i.e. with the graph's own distances. Each ball is
+// cut out of the global distance rows, so no ball needs a subgraph or an APSP
+// of its own, and balls with the same vertex set are evaluated once.
+// Within a ball the centre is evaluated first, then the other bases in
+// batches that share one pass over the ball's distances, most eccentric
+// first. Evaluation stops once the largest delta_r reaches 2 * delta_centre
+// or half the eccentricity of the next base, which for tree-like balls is
+// after the first base.
+class LocalHyperbolicity {
+public:
+    // dist_matrix of one connected graph, adj_list the graph itself
+    LocalHyperbolicity(const std::vector<std::vector<double>>& dist_matrix,
+                       const std::vector<std::vector<std::pair<int, double>>>& adj_list);
+    // Row-major n x n matrix with n = adj_list.size(); not copied
+    LocalHyperbolicity(const double* dist_matrix,
+                       const std::vector<std::vector<std::pair<int, double>>>& adj_list);
+
+    LocalProfile compute(const LocalOptions& options) const;
+
+private:
+    std::vector<const double*> distances;  // Row pointers into the caller's matrix
+    const std::vector<std::vector<std::pair<int, double>>>& adj_list;
+
+    struct BallValue {
+        double delta = 0.0;
+        BaseWitness witness;
+        int bases = 0;
+    };
+
+    // Vertices of the ball around center, ascending
+    std::vector<int> ball(int center, const LocalOptions& options, std::vector<int>& seen, int stamp) const;
+    BallValue evaluate(const std::vector<int>& ball, int center, const LocalOptions& options) const;
+};
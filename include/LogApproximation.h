@@ -6,6 +6,8 @@
 #include <stdexcept>
 #include <utility> // For std::pair
 
+class DistanceOracle;
+
 // Basic structure to represent the unweighted approximation tree
 struct ApproxTree {
     int num_nodes = 0;
@@ -22,8 +24,25 @@ public:
         const std::vector<std::vector<std::pair<int, double>>>& graph_adj_list
     );
 
+    // Oracle variant: no dense matrix is held. Graph distances come from the
+    // oracle and tree distances are generated one BFS row at a time, so memory
+    // stays O(n) beyond the oracle itself.
+    LogApproxHyperbolicity(
+        const DistanceOracle& oracle,
+        const std::vector<std::vector<std::pair<int, double>>>& graph_adj_list
+    );
+
     // Computes the O(log n)-approximate hyperbolicity value
     double compute_approximate_hyperbolicity();
+    // Same, on a tree already built for this graph (it only depends on the graph)
+    double compute_approximate_hyperbolicity(const ApproxTree& tree);
+
+    // Chepoi-Dragan leveling tree rooted at vertex 0
+    ApproxTree construct_approximation_tree() const;
+
+    // Pair (u, v) with the largest |d_G(u, v) - d_T(u, v)| found by the last
+    // compute call; (-1, -1) if no pair is distorted
+    std::pair<int, int> distortion_witness() const { return witness_pair; }
 
 private:
     // Reference to the original graph's distance matrix
@@ -31,12 +50,16 @@ private:
     // ***** NEW MEMBER *****
     // Reference to the original graph's adjacency list
     const std::vector<std::vector<std::pair<int, double>>>& original_adj_list;
+    // Set when distances come from an oracle instead of the matrix
+    const DistanceOracle* oracle = nullptr;
 
     int n; // Number of nodes
+    std::pair<int, int> witness_pair{-1, -1};
 
-    // --- Implementation replaces the stub ---
-    ApproxTree construct_approximation_tree() const;
-    // ---
+    // Distances from the leveling base node (matrix row or one Dijkstra)
+    std::vector<double> base_distances(int base_node) const;
+    // Max |d_G - d_T| streamed row by row against the oracle
+    double max_distortion_from_oracle(const ApproxTree& tree, std::pair<int, int>& pair) const;
 
     // Computes all-pairs shortest paths (edge counts) within the given unweighted tree T
     std::vector<std::vector<double>> compute_tree_distances(const ApproxTree& tree) const;
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Whole file as one read-only buffer for the loaders' tokenisers: mapped
+// where mmap exists, read into memory otherwise. Throws if the file cannot be
+// read.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    size_t size() const { return length; }
+
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+    void* mapping = nullptr;
+    std::string fallback;
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// On-disk distance matrices.
+//
+// Raw:        "HYPDIST1", uint64 n, n*n doubles row-major (native byte order).
+//             The distances.bin of sharded jobs; MappedDistanceMatrix maps it
+//             in place.
+// Compressed: "HYPDISTZ", uint64 n, then one frame per row in the order the
+//             rows were written: uint32 row, uint32 payload bytes, payload.
+//             The payload codes the row value by value, see MatrixExport.cpp.
+enum class MatrixFormat { Raw, Compressed };
+
+constexpr char RAW_MATRIX_MAGIC[8] = {'H', 'Y', 'P', 'D', 'I', 'S', 'T', '1'};
+constexpr char COMPRESSED_MATRIX_MAGIC[8] = {'H', 'Y', 'P', 'D', 'I', 'S', 'T', 'Z'};
+constexpr size_t MATRIX_HEADER_BYTES = sizeof(RAW_MATRIX_MAGIC) + sizeof(std::uint64_t);
+
+// Writes an n x n matrix one row at a time, so the matrix never has to exist
+// in memory. Rows may come from several threads and in any order. The file
+// appears under its name only once finish() succeeds; until then it is
+// written to path + ".tmp", which the destructor removes.
+class DistanceMatrixWriter {
+public:
+    DistanceMatrixWriter(const std::string& path, int n, MatrixFormat format);
+    ~DistanceMatrixWriter();
+    DistanceMatrixWriter(const DistanceMatrixWriter&) = delete;
+    DistanceMatrixWriter& operator=(const DistanceMatrixWriter&) = delete;
+
+    // Thread-safe; row holds n values
+    void write_row(int i, const double* row);
+    // Throws unless every row was written exactly once and the file is intact
+    void finish();
+
+    size_t bytes_written() const { return bytes; }
+
+private:
+    std::string path;
+    std::string tmp_path;
+    int n;
+    MatrixFormat format;
+
+    std::mutex mutex;
+    std::ofstream out;
+    std::vector<char> written;
+    size_t bytes = 0;
+    bool finished = false;
+};
+
+// Either format, detected from the header
+std::vector<std::vector<double>> read_distance_matrix(const std::string& path);
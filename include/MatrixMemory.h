@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Placement of the large n x n working matrices (Gromov products, max-min
+// products, threshold-kernel tables).
+//
+// Buffers of at least one huge page are mapped separately and either advised
+// for transparent huge pages or, on request, taken from the explicit hugetlb
+// pool (falling back to THP when the pool is empty). Elements are left
+// uninitialised by the allocator so that the kernel that fills a buffer
+// touches it first: with the same schedule(static) split over rows as the
+// consuming loop, every thread's rows land on its own NUMA node.
+//
+// The configuration belongs to a run: engines take it with their other
+// kernel settings and hand it to the allocator of every buffer they create.
+struct HugePageUsage {
+    std::atomic<size_t> bytes{0};      // Held now by the run's huge-page mappings
+    std::atomic<size_t> peak{0};
+};
+
+struct MatrixMemoryConfig {
+    bool huge_pages = true;            // madvise(MADV_HUGEPAGE) on large buffers
+    bool explicit_huge_pages = false;  // Try MAP_HUGETLB first
+    std::shared_ptr<HugePageUsage> usage;   // Charged with the run's mappings if set
+};
+
+void* allocate_matrix_memory(size_t bytes, const MatrixMemoryConfig& config = MatrixMemoryConfig());
+void free_matrix_memory(void* ptr, size_t bytes) noexcept;
+// Bytes currently held in huge-page backed mappings, over all runs
+size_t huge_page_bytes_in_use();
+
+// Pins each thread of the calling thread's OpenMP team to its own CPU of the
+// process affinity mask while the object lives, so that first-touch placement
+// stays valid for later loops; the previous masks are restored on
+// destruction. Teams pinned at the same time (e.g. service workers) get the
+// least used CPUs, so they do not pile onto the same ones.
+class ThreadPinning {
+public:
+    explicit ThreadPinning(bool pin);
+    ~ThreadPinning();
+    ThreadPinning(const ThreadPinning&) = delete;
+    ThreadPinning& operator=(const ThreadPinning&) = delete;
+
+private:
+    std::vector<int> cpus;             // CPU of each team thread; empty = not pinned
+    std::vector<unsigned char> saved;  // Affinity mask of each thread before pinning
+};
+
+template <class T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+    explicit HugePageAllocator(const MatrixMemoryConfig& config) noexcept : config(config) {}
+    template <class U>
+    HugePageAllocator(const HugePageAllocator<U>& other) noexcept : config(other.config) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(allocate_matrix_memory(n * sizeof(T), config)); }
+    void deallocate(T* p, size_t n) noexcept { free_matrix_memory(p, n * sizeof(T)); }
+
+    // Default-initialise instead of value-initialise: resize() does not touch the pages
+    template <class U>
+    void construct(U* p) noexcept { ::new (static_cast<void*>(p)) U; }
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+    // Any allocator frees any buffer: mappings are looked up by pointer
+    template <class U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+    template <class U>
+    bool operator!=(const HugePageAllocator<U>&) const noexcept { return false; }
+
+    MatrixMemoryConfig config;
+};
+
+// Flat row-major matrix storage; construct with a size (and the run's
+// HugePageAllocator) only, then fill in parallel
+template <class T>
+using MatrixBuffer = std::vector<T, HugePageAllocator<T>>;
+
+// Hardware counters summed over the OpenMP threads between start() and stop().
+// Needs perf events (Linux, perf_event_paranoid <= 2); otherwise available is false.
+// The huge-page peak covers the buffers allocated with huge_pages() as their
+// MatrixMemoryConfig::usage, so concurrent runs each see their own.
+struct MemoryMetrics {
+    bool available = false;
+    long long tlb_misses = 0;          // dTLB load misses
+    long long remote_accesses = 0;     // Loads served by another NUMA node
+    long long cache_misses = 0;        // Last-level cache misses
+    size_t huge_page_bytes = 0;        // Peak huge-page backed matrix memory
+};
+
+class MemoryCounters {
+public:
+    MemoryCounters() = default;
+    ~MemoryCounters();
+    MemoryCounters(const MemoryCounters&) = delete;
+    MemoryCounters& operator=(const MemoryCounters&) = delete;
+
+    void start();
+    MemoryMetrics stop();
+    const std::shared_ptr<HugePageUsage>& huge_pages() const { return usage; }
+
+private:
+    std::shared_ptr<HugePageUsage> usage = std::make_shared<HugePageUsage>();
+    std::vector<int> tlb_fds;
+    std::vector<int> node_fds;
+    std::vector<int> miss_fds;
+    void close_all();
+};
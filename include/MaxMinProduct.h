@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+#include "MatrixMemory.h"
+
+// Backends for the (max,min) matrix product C[i][j] = max_k min(A[i][k], A[k][j])
+enum class MaxMinBackend {
+    Dense,            // Cubic row-streaming kernel
+    ThresholdBitset,  // Sorted-threshold decomposition into boolean bitset products
+    Auto              // ThresholdBitset when n is large for its number of distinct values, else Dense
+};
+
+// Threshold-bitset product. Values are swept from smallest to largest; at each
+// threshold t the rows {k : A[i][k] >= t} and columns {k : A[k][j] >= t} are
+// kept as bitsets, a pair (i, j) whose sets intersect is raised to its
+// witness's value, and it is final once they no longer intersect. With few distinct values (integer or hop-count weights) each level
+// is exact and the cost is about (levels * n^3 / 64) word operations; with many
+// distinct values the levels are quantile buckets and settled pairs are refined
+// by scanning only the witnesses in their bucket.
+// A and C are given as row pointers into n x n matrices; -INF marks "no path".
+// The level tables are placed according to memory.
+void threshold_max_min_product(const std::vector<const double*>& A, const std::vector<double*>& C, int n,
+                               const MatrixMemoryConfig& memory = MatrixMemoryConfig());
+
+// Picks the concrete backend for an n x n matrix (never returns Auto)
+MaxMinBackend resolve_max_min_backend(MaxMinBackend requested, const std::vector<const double*>& A, int n);
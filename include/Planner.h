@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "MaxMinProduct.h"
+
+// Ways to obtain delta, most accurate first
+enum class PlanEngine {
+    Exact,              // All bases on the in-memory distance matrix
+    ExactSharded,       // All bases in worker processes on a memory-mapped matrix
+    Factor2MultiBase,   // k bases: delta within a factor 2, usually tighter
+    Factor2,            // One base: delta within a factor 2
+    Log,                // Leveling tree on the in-memory distance matrix
+    LogOracle           // Leveling tree on distance labels, no n x n matrix
+};
+
+// What the cost model needs to know about the graph
+struct GraphProfile {
+    std::vector<int> component_vertices;          // Per connected component
+    std::vector<long long> component_entries;     // Adjacency entries (both directions) per component
+    int distance_levels = 0;                      // Distinct distances if integral and few, else 0
+};
+
+struct PlanBudget {
+    double seconds = 0.0;     // Wall-clock limit, 0 = none
+    double bytes = 0.0;       // RAM the run may use
+    int threads = 1;
+    int multi_bases = 4;      // k of Factor2MultiBase
+    int shard_workers = 2;
+    bool allow_disk = false;  // ExactSharded may be chosen (it needs a job directory)
+};
+
+struct PlanEstimate {
+    PlanEngine engine = PlanEngine::Exact;
+    MaxMinBackend kernel = MaxMinBackend::Dense;  // Exact and Factor-2 engines
+    double seconds = 0.0;
+    double bytes = 0.0;         // Peak RAM on top of what is already in use
+    double disk_bytes = 0.0;
+    bool fits_time = true;
+    bool fits_memory = true;
+};
+
+// Predicted time and memory of every engine on the graph. The constants are
+// fitted to runs on the "Evaluation Datasets" graphs (Planner.cpp); they are
+// per core and scaled by the thread count.
+std::vector<PlanEstimate> estimate_plans(const GraphProfile& profile, const PlanBudget& budget);
+
+// The most accurate plan within both budgets (the faster one on a tie); if
+// none is, the fastest within the memory budget; -1 if nothing fits in memory
+int choose_plan(const std::vector<PlanEstimate>& plans);
+
+// --- Memory probes (Linux /proc) ---
+// MemAvailable, 0 where unknown
+size_t available_memory_bytes();
+
+// Peak resident memory the process gains while this object lives
+class PeakMemory {
+public:
+    PeakMemory();   // Resets the kernel's peak RSS counter
+    bool available() const { return tracked; }
+    size_t added_bytes() const;
+
+private:
+    size_t baseline = 0;
+    bool tracked = false;
+};
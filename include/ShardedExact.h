@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Hyperbolicity.h"
+#include "MaxMinProduct.h"
+
+// Sharded exact computation. The bases 0..n-1 are cut into contiguous shards
+// that separate worker processes (on one machine or on several sharing a
+// filesystem) evaluate independently. Everything lives in a job directory:
+//
+//   job.txt                         n, shard size, shard count, graph fingerprint
+//   distances.bin                   "HYPDIST1", uint64 n, n*n doubles row-major
+//   queue/shard-00012.todo          waiting
+//   queue/shard-00012.claim.<id>    taken by worker <id>; mtime is its heartbeat
+//   queue/shard-00012.done          finished
+//   checkpoints/shard-00012.txt     one "r delta_r i j k" line per evaluated base
+//
+// Claims are atomic renames, so any number of workers can poll the queue. A
+// claim whose heartbeat is older than the lease is put back by the
+// coordinator; the checkpoint lets the next worker skip the bases already done.
+
+struct ShardJobInfo {
+    int nodes = 0;
+    int shard_size = 0;
+    int shard_count = 0;
+    std::uint64_t fingerprint = 0;
+};
+
+struct CheckpointEntry {
+    double delta = 0.0;
+    BaseWitness witness;
+};
+
+struct ShardProgress {
+    int todo = 0;
+    int claimed = 0;
+    int done = 0;
+};
+
+class ShardJob {
+public:
+    explicit ShardJob(std::string directory);
+
+    // Hash of the adjacency lists; a job is resumed only for the same graph
+    static std::uint64_t fingerprint(const std::vector<std::vector<std::pair<int, double>>>& adj_list);
+
+    // Reads job.txt; false if the directory holds no complete job
+    bool open();
+    // Starts a fresh job, discarding any queue and checkpoints in the directory
+    void create(const std::vector<std::vector<double>>& dist_matrix, std::uint64_t fingerprint, int shard_size);
+
+    const ShardJobInfo& info() const { return job; }
+    const std::string& directory() const { return dir; }
+    std::string distance_path() const;
+    // Bases [first, second) of a shard
+    std::pair<int, int> shard_range(int shard) const;
+
+    // --- Work queue ---
+    int claim(const std::string& worker);                   // Shard id, or -1 if none is waiting
+    bool heartbeat(int shard, const std::string& worker);   // False once the claim was taken away
+    void complete(int shard, const std::string& worker);
+    int requeue_stale(double lease_seconds);                // Returns the number of claims put back
+    ShardProgress progress() const;
+
+    // --- Checkpoints ---
+    void record(int shard, double delta, const BaseWitness& witness);
+    std::map<int, CheckpointEntry> checkpoint(int shard) const;
+    // delta_r for every base, NaN where no checkpoint exists yet
+    std::vector<double> base_deltas() const;
+    // Witness per base, r = -1 where no checkpoint exists yet
+    std::vector<BaseWitness> base_witnesses() const;
+
+private:
+    std::string dir;
+    ShardJobInfo job;
+
+    std::string queue_path(int shard, const std::string& state) const;
+    std::string checkpoint_path(int shard) const;
+};
+
+// Read-only view of distances.bin. The file is mapped shared, so all workers
+// on a machine read the same page-cache copy; where mmap is unavailable the
+// matrix is read into memory instead.
+class MappedDistanceMatrix {
+public:
+    explicit MappedDistanceMatrix(const std::string& path);
+    ~MappedDistanceMatrix();
+    MappedDistanceMatrix(const MappedDistanceMatrix&) = delete;
+    MappedDistanceMatrix& operator=(const MappedDistanceMatrix&) = delete;
+
+    int size() const { return n; }
+    const double* data() const { return values; }
+
+private:
+    int n = 0;
+    const double* values = nullptr;
+    void* mapping = nullptr;
+    size_t mapped_length = 0;
+    std::vector<double> fallback;
+};
+
+struct ShardWorkerOptions {
+    std::string worker_id;                          // Unique per process; empty = host name and pid
+    MaxMinBackend max_min_backend = MaxMinBackend::Auto;
+    int threads = 0;                                // OpenMP threads, 0 = runtime default
+};
+
+// Claims and evaluates shards until none is waiting; returns the number of
+// shards this worker completed. Throws if the job directory is unusable.
+int run_shard_worker(const std::string& directory, const ShardWorkerOptions& options);
@@ -1,12 +1,18 @@
 #pragma once
+#include <functional>
 #include <vector>
 
 class ShortestPath {
 public:
     explicit ShortestPath(const std::vector<std::vector<std::pair<int, double>>>& adj_list);
     std::vector<std::vector<double>> compute_all_pairs();
+    // Same rows, handed to on_row(source, row) by the thread that computed
+    // them, in no particular order; no matrix is kept. The first exception
+    // thrown by on_row stops the run and is rethrown.
+    void compute_all_pairs(const std::function<void(int, const std::vector<double>&)>& on_row) const;
+    std::vector<double> compute_single_source(int source) const;
 
 private:
     const std::vector<std::vector<std::pair<int, double>>>& adjacency_list;
-    std::vector<double> dijkstra(int source) const;
-};
\ No newline at end of file
+    void dijkstra(int source, std::vector<double>& dist) const;
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+#include <utility>
+
+// How far apart neighbours are numbered: the engines touch the rows and
+// entries of both ends of an edge together, so small gaps mean shared cache
+// lines and pages
+struct OrderLocality {
+    double mean_gap = 0.0;   // Mean |u - v| over adjacency entries
+    int bandwidth = 0;       // Largest |u - v|
+};
+
+OrderLocality order_locality(const std::vector<std::vector<std::pair<int, double>>>& adj_list);
+
+// Reverse Cuthill-McKee numbering, order[new_id] = old_id. Each component is
+// numbered breadth-first from a pseudo-peripheral vertex, neighbours by
+// increasing degree, and the whole sequence is reversed. Vertices end up
+// close in id to their neighbours, which bounds the bandwidth of the
+// adjacency and of the near-diagonal part of the distance matrix.
+std::vector<int> reverse_cuthill_mckee(const std::vector<std::vector<std::pair<int, double>>>& adj_list);
+
+// The graph renumbered so that vertex order[i] becomes i
+std::vector<std::vector<std::pair<int, double>>> permute_adjacency(
+    const std::vector<std::vector<std::pair<int, double>>>& adj_list, const std::vector<int>& order);
@@ -2,23 +2,145 @@
 #define BACKEND_H
 
 #include <QString>
+#include <QByteArray>
 #include <QVector>
+#include <QStringList>
 #include <QMap>
+#include <QHash>
+#include <QMultiHash>
+#include <QPair>
 #include <QSet>
-#include <QPixmap>
-#include <QSize>
+#include <vector>
+#include <memory>
+#include <atomic>
 
 
+// Read-only distance matrix shared between the per-graph cache and the
+// results computed from it, so a result never copies the n x n rows
+using SharedDistances = std::shared_ptr<const std::vector<std::vector<double>>>;
+
+// Per-component part of a result for disconnected graphs
+struct ComponentResult {
+    std::vector<int> vertices;                          // Indices into HyperResult::node_order
+    SharedDistances distance_matrix;                    // Compact, in the order of vertices
+    double hyperbolicity = 0.0;
+};
+
 //temp struct to print the shortest distance matrix
 struct HyperResult {
+    QString method;
     double hyperbolicity;
-    std::vector<std::vector<double>> distance_matrix;
+    SharedDistances distance_matrix;   // Connected graphs; null if no matrix was computed
+    std::vector<int> matrix_vertices;  // node_order index of each matrix row / column; empty = node order
     QVector<QString> node_order;  // Use Qt container for compatibility
     long long total_duration_ms = 0; 
 
+    // Bounds reported by the Factor-2 methods (lower <= delta <= upper);
+    // local runs set only lower_bound, and their upper_bound means nothing
+    double lower_bound = 0.0;
+    double upper_bound = 0.0;
+    QStringList bases;            // Bases evaluated by the Factor-2 methods
+
+    // Vertices behind the value. Exact and Factor-2: the quadruple r, i, j, k
+    // with delta_r = min(A_r[i][k], A_r[k][j]) - A_r[i][j] for the largest
+    // delta_r seen. Log: the pair whose tree distance strays furthest from
+    // the graph distance. Empty when the value is 0.
+    QStringList witness;
+
+    // Distance summary (per component), read off the run's distance rows or
+    // else found by the eccentricity bounding engine with this many searches
+    double diameter = 0.0;
+    double radius = 0.0;
+    int eccentricity_searches = 0;
+
+    // Distance oracle statistics (Log approximation in oracle mode).
+    // oracle_exact is false when the labels grew too large for some component
+    // and landmark upper bounds stood in for its distances, so the value is
+    // then only an estimate.
+    bool used_distance_oracle = false;
+    bool oracle_exact = true;
+    double oracle_build_ms = 0.0;
+    size_t oracle_bytes = 0;
+    double oracle_query_ns = 0.0;
+
+    // Filled instead of distance_matrix when the graph has several components
+    std::vector<ComponentResult> components;
+
+    // Reuse of cached intermediates (ComputeCache)
+    bool reused_distances = false;   // No APSP was run for this result
+    int reused_bases = 0;            // delta_r values taken from earlier runs
+
+    // Incremental update statistics (DynamicSession::applyEdits)
+    bool incremental = false;
+    size_t changed_pairs = 0;
+    int repaired_sources = 0;     // Distance rows patched in place
+    int recomputed_sources = 0;   // Distance rows rerun after increases / removals
+    int bases_patched = 0;
+    int bases_recomputed = 0;
+    bool full_recompute = false;  // Repair would have cost more, so everything was rerun
+
+    // Matrix memory placement (MemoryCounters over the whole run)
+    bool memory_counters = false;    // Hardware counters could be read
+    long long tlb_misses = 0;
+    long long remote_accesses = 0;   // Loads served by another NUMA node
+    long long cache_misses = 0;      // Last-level cache misses
+    size_t huge_page_bytes = 0;      // Peak huge-page backed kernel buffers
+
+    // Vertex numbering the engines ran on (ComputeOptions::vertex_order):
+    // "RCM" if a component was renumbered, "Input" otherwise; empty for
+    // runs outside the per-graph cache. Gaps are the mean |id(u) - id(v)|
+    // over edges, in file order and in the order used.
+    QString vertex_order;
+    double order_ms = 0.0;
+    double edge_gap_before = 0.0;
+    double edge_gap_after = 0.0;
+
+    // Sharded exact runs (computeShardedExact)
+    QString job_dir;
+    int shards = 0;
+    int shards_resumed = 0;          // Already finished when this run started
+    int bases_resumed = 0;           // delta_r values read back from checkpoints
+    int shards_requeued = 0;         // Claims taken back from silent workers
+
+    // Local hyperbolicity: delta of the ball around each vertex, in
+    // node_order; hyperbolicity is the largest of them (a lower bound on delta)
+    QString local_ball;              // "hops" or "radius"; empty for other methods
+    double local_size = 0.0;
+    std::vector<double> local_delta;
+    std::vector<int> local_ball_size;
+    int local_distinct_balls = 0;    // Balls evaluated; equal vertex sets count once
+    int local_settled_early = 0;     // Balls settled by bounds before every base ran
+    long long local_bases = 0;
+
+    // Cost of the run: predicted by the planner (Auto method only) and the
+    // peak memory it actually added (0 unless measure_peak_memory was set,
+    // or where that cannot be measured)
+    bool planned = false;
+    double predicted_seconds = 0.0;
+    double predicted_bytes = 0.0;
+    size_t peak_bytes = 0;
 
 };
 
+// Tunables for the approximation methods
+struct ComputeOptions {
+    int num_bases = 4;                           // Factor-2 Multi-base: number of bases
+    QString base_selection = "Eccentricity";     // "Eccentricity", "Centrality" or "Random"
+    unsigned int seed = 0;                       // Seed for random base selection
+    QString max_min_backend = "Auto";            // "Dense", "Threshold Bitset" or "Auto"
+    bool use_distance_oracle = false;            // Log approximation: labels instead of dense APSP
+    bool huge_pages = true;                      // Kernel matrices on transparent huge pages
+    bool pin_threads = false;                    // One CPU per OpenMP thread (NUMA first touch)
+    int shard_workers = 2;                       // Sharded exact: local worker processes
+    int shard_size = 0;                          // Sharded exact: bases per shard, 0 = automatic
+    int local_hops = 2;                          // Local hyperbolicity: k of the k-hop balls
+    double local_radius = 2.0;                   // Local hyperbolicity: radius of the distance balls
+    double time_budget_s = 0.0;                  // Auto: wall-clock limit, 0 = none
+    double memory_budget_mb = 0.0;               // Auto: RAM limit, 0 = what is available now
+    QString vertex_order = "Auto";               // "Auto", "RCM" or "Input": renumbering before APSP
+    bool measure_peak_memory = false;            // Fill HyperResult::peak_bytes; on for planned runs
+};
+
 // Simple structure to hold an edge.
 struct Edge {
     QString source;
@@ -33,12 +155,134 @@ public:
     QVector<Edge> edges;
     QMap<QString, QMap<QString, double>> adj;
     void addEdge(const QString& src, const QString& tgt, double weight);
+    // Replaces every entry between src and tgt; weight = +infinity removes the
+    // edge. Unknown nodes are appended to nodes. Constant time apart from the
+    // first call, which indexes nodes and edges; removals move the last entry
+    // of edges into the freed slot.
+    void setEdge(const QString& src, const QString& tgt, double weight);
+
+private:
+    // Names in nodes and the slots in edges of every (source, target) entry,
+    // kept current by setEdge and rebuilt when the lists changed without it
+    QHash<QString, int> node_slots;
+    QMultiHash<QPair<QString, QString>, int> edge_slots;
+    int indexed_edges = -1;
+    void indexGraph();
+    void removeEdgeSlot(int slot);
+};
+
+class DynamicHyperbolicity;
+
+// Keeps the state of one run alive so that edge edits are repaired
+// incrementally instead of rerunning computeHyperbolicity. Supports the exact
+// and Factor-2 methods; edits are applied to the graph in place.
+class DynamicSession {
+public:
+    DynamicSession(Graph* graph, const QString& method, const ComputeOptions& options = ComputeOptions());
+    ~DynamicSession();
+
+    static bool supports(const QString& method);
+
+    // result().distance_matrix stays empty: the maintained matrix is read
+    // through distanceMatrix() instead of being copied on every edit
+    const HyperResult& result() const { return current; }
+    const HyperResult& applyEdits(const QVector<Edge>& edits);
+    const std::vector<std::vector<double>>& distanceMatrix() const;
+
+private:
+    Graph* graph;
+    QString method;
+    bool pin_threads = false;           // ComputeOptions::pin_threads, for every edit
+    QMap<QString, int> node_indices;
+    std::unique_ptr<DynamicHyperbolicity> engine;
+    HyperResult current;
+    std::vector<double> eccentricity;   // Largest finite distance per row
+
+    void refreshResult();
+};
+
+struct GraphCache;  // Defined in backend.cpp
+
+// One way to run a method, with its predicted cost (Planner.h)
+struct PlanCandidate {
+    QString method;                  // As accepted by computeHyperbolicity, or "Exact Algorithm (Sharded)"
+    QString max_min_backend;         // Kernel to run it with
+    bool use_distance_oracle = false;
+    double seconds = 0.0;
+    double bytes = 0.0;              // Peak RAM
+    double disk_bytes = 0.0;
+    bool fits_time = true;
+    bool fits_memory = true;
+};
+
+struct ComputePlan {
+    QVector<PlanCandidate> candidates;
+    int chosen = -1;                 // Index into candidates; -1 if nothing fits in memory
+    double budget_seconds = 0.0;     // 0 = none
+    double budget_bytes = 0.0;
+    int threads = 1;
+};
+
+// Intermediates shared by every method run on one graph: the numeric
+// adjacency, distance matrices, eccentricity summary, chosen bases, delta_r of
+// every evaluated base and the Log approximation tree. Keep one per loaded
+// graph and invalidate() it whenever the graph is replaced or edited.
+class ComputeCache {
+public:
+    ComputeCache();
+    ~ComputeCache();
+
+    void invalidate();
+    // Cached state for graph, rebuilt if it belongs to another graph or
+    // vertex order (ComputeOptions::vertex_order)
+    GraphCache& forGraph(const Graph* graph, const QString& vertex_order = "Auto");
+    // Cached state for graph, or nullptr; never builds anything
+    GraphCache* find(const Graph* graph) const;
+
+private:
+    std::unique_ptr<GraphCache> state;
 };
 
 // Functions implemented in backend.cpp.
 Graph* loadGraph(const QString& filePath);
 // double computeHyperbolicity(const Graph* graph, const QString& method);
-HyperResult computeHyperbolicity(const Graph* graph, const QString& method, const QString& input_filename);
-QPixmap drawGraph(const Graph* graph, const QSize& size);
+HyperResult computeHyperbolicity(const Graph* graph, const QString& method, const QString& input_filename,
+                                 const ComputeOptions& options = ComputeOptions(),
+                                 ComputeCache* cache = nullptr);
+// Cost of every method on graph under the budgets of options, and the one
+// the "Auto" method runs: the most accurate within both budgets. Sharded
+// runs are only considered with allow_sharded, as they need a job directory.
+ComputePlan planComputation(const Graph* graph, const ComputeOptions& options = ComputeOptions(),
+                            ComputeCache* cache = nullptr, bool allow_sharded = false);
+// Exact, Factor-2 and Log on one shared cache: a single APSP, and the exact
+// run reuses the Factor-2 base
+QVector<HyperResult> compareAllMethods(const Graph* graph, const QString& input_filename,
+                                       const ComputeOptions& options = ComputeOptions(),
+                                       ComputeCache* cache = nullptr);
+// Exact delta with the bases split into shards that worker processes
+// (options.shard_workers local ones, plus any started elsewhere with
+// --shard-worker on the same directory) evaluate. Results are checkpointed in
+// jobDir, so calling this again for the same graph resumes the run. Needs a
+// connected graph. Blocks until every shard is done, so callers with a UI run
+// it on another thread; setting *cancel stops the local workers and throws.
+HyperResult computeShardedExact(const Graph* graph, const QString& jobDir,
+                                const ComputeOptions& options = ComputeOptions(),
+                                const std::atomic<bool>* cancel = nullptr);
+// Streams the distance matrix of graph to path, rows in graph->nodes order:
+// raw for *.bin, compressed otherwise (MatrixExport.h); the node names go to
+// path + ".nodes", one per line. Distances cached by earlier runs are written
+// as they are; otherwise APSP runs and every row is written as soon as it is
+// known, so the matrix is never held in memory. Returns the matrix file size.
+qint64 exportDistanceMatrix(const Graph* graph, const QString& path, ComputeCache* cache = nullptr);
+// Row of source (index into graph->nodes) of the distance matrix an earlier
+// run cached for graph, in node order, infinity across components; false if
+// no run has computed the distances of source's component yet
+bool cachedDistanceRow(const Graph* graph, int source, const ComputeCache& cache, std::vector<double>& row);
+// Value, bounds, witness and run metrics of result as one compact JSON
+// object without a trailing newline, for JSON-lines logs
+QByteArray resultJsonLine(const HyperResult& result, const QString& input_filename = QString());
+// Entry point of a worker process: hyperbolicity --shard-worker DIR
+// [--worker-id ID] [--kernel NAME] [--threads N]
+int runShardWorker(const QStringList& arguments);
 
 #endif // BACKEND_H
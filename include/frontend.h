@@ -2,14 +2,26 @@
 #define FRONTEND_H
 
 #include <QMainWindow>
+#include <QByteArray>
+#include <QList>
+#include <QFutureWatcher>
+#include <atomic>
+#include <memory>
 
 class QComboBox;
+class QSpinBox;
+class QCheckBox;
 class QPushButton;
-class QGraphicsView;
-class QGraphicsScene;
+class GraphView;
 class QLabel;
 class QTextEdit;
 class Graph;  // forward declaration from backend
+class DynamicSession;
+class ComputeCache;
+struct ComputeOptions;
+struct HyperResult;
+struct ComputePlan;
+struct ShardedRun;  // Outcome of a sharded exact run, defined in frontend.cpp
 
 class HyperbolicityApp : public QMainWindow
 {
@@ -22,20 +34,59 @@ public:
 private slots:
     void uploadFile();
     void computeHyperbolicity();
+    void compareAllMethods();
+    void applyEdgeEdits();
+    void exportData();
+    void shardedRunFinished();
 
 private:
     QComboBox *algorithmSelector;
+    QSpinBox *numBasesSpin;
+    QSpinBox *shardWorkersSpin;
+    QSpinBox *localHopsSpin;
+    QSpinBox *timeBudgetSpin;
+    QSpinBox *memoryBudgetSpin;
+    QComboBox *baseSelector;
+    QComboBox *kernelSelector;
+    QComboBox *orderSelector;
+    QCheckBox *oracleCheck;
+    QCheckBox *pinThreadsCheck;
     QPushButton *uploadButton;
     QPushButton *computeButton;
+    QPushButton *compareButton;
+    QPushButton *editButton;
     QPushButton *exportButton;
-    QGraphicsView *graphicsView;
-    QGraphicsScene *scene;
+    GraphView *graphView;
     QLabel *resultLabel;
     QTextEdit *logText;
 
     // Graph pointer from the backend.
     Graph* graph;
     QString currentGraphFilePath;
+
+    // Distances, bases and trees shared between runs on the loaded graph
+    ComputeCache* computeCache;
+    ComputeOptions currentOptions() const;
+    void logResult(const HyperResult& result);
+    void logWitness(const HyperResult& result);
+    void logLocalProfile(const HyperResult& result);
+    void logPlan(const ComputePlan& plan);
+    void showResult(const HyperResult& result);
+
+    // Sharded exact runs take hours, so their coordinator runs on another
+    // thread. Meanwhile the graph must stay put: upload, edits, compare and
+    // export are disabled, and Compute turns into Cancel.
+    QFutureWatcher<ShardedRun>* shardWatcher;
+    std::shared_ptr<std::atomic<bool>> shardCancel;
+    void setShardedRunning(bool running);
+
+    // One JSON line per result shown so far; written out by Export
+    QList<QByteArray> resultLines;
+
+    // Incremental state for edge edits; rebuilt when the method or options change
+    DynamicSession* session;
+    QString sessionKey;
+    void resetSession();
 };
 
 #endif // FRONTEND_H
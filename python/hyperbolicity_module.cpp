@@ -0,0 +1,751 @@
+// Python bindings for the compute core (module "hyperbolicity", built by
+// setup.py next to this file). Plain CPython, no NumPy headers needed:
+// edge columns are read in place through the buffer protocol, and results
+// are handed out as read-only buffers over the engines' own storage, so
+// numpy.asarray() or memoryview() on them copies nothing.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "ShortestPath.h"
+#include "Hyperbolicity.h"
+#include "Eccentricity.h"
+#include "Components.h"
+#include "DistanceOracle.h"
+#include "LogApproximation.h"
+#include "LocalHyperbolicity.h"
+#include "MatrixMemory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using AdjacencyList = std::vector<std::vector<std::pair<int, double>>>;
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+// Landmarks used when the exact labels would grow too large (as in backend.cpp)
+constexpr int LANDMARK_FALLBACK_COUNT = 16;
+
+PyObject* array_type = nullptr;
+PyObject* graph_type = nullptr;
+
+// Runs work with the GIL released; C++ exceptions become Python ones
+template <class Work>
+bool without_gil(Work&& work) {
+    PyObject* error_type = nullptr;
+    std::string message;
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        work();
+    } catch (const std::bad_alloc&) {
+        error_type = PyExc_MemoryError;
+        message = "out of memory";
+    } catch (const std::invalid_argument& e) {
+        error_type = PyExc_ValueError;
+        message = e.what();
+    } catch (const std::out_of_range& e) {
+        error_type = PyExc_IndexError;
+        message = e.what();
+    } catch (const std::exception& e) {
+        error_type = PyExc_RuntimeError;
+        message = e.what();
+    }
+    Py_END_ALLOW_THREADS
+    if (error_type) {
+        PyErr_SetString(error_type, message.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool parse_kernel(const char* name, MaxMinBackend& backend) {
+    const std::string kernel = name ? name : "auto";
+    if (kernel == "auto") backend = MaxMinBackend::Auto;
+    else if (kernel == "dense") backend = MaxMinBackend::Dense;
+    else if (kernel == "threshold_bitset") backend = MaxMinBackend::ThresholdBitset;
+    else {
+        PyErr_Format(PyExc_ValueError, "unknown kernel '%s' (auto, dense or threshold_bitset)", name);
+        return false;
+    }
+    return true;
+}
+
+PyObject* witness_tuple(const BaseWitness& w, const std::vector<int>* vertices = nullptr) {
+    if (w.r < 0 || (w.r == w.i && w.i == w.j && w.j == w.k)) Py_RETURN_NONE;
+    auto id = [&](int v) { return vertices ? (*vertices)[v] : v; };
+    return Py_BuildValue("(iiii)", id(w.r), id(w.i), id(w.j), id(w.k));
+}
+
+// --- Array ---
+// Read-only buffer over storage some engine filled; owner keeps it alive
+struct ArrayObject {
+    PyObject_HEAD
+    std::shared_ptr<const void>* owner;
+    const void* data;
+    char format[2];
+    Py_ssize_t itemsize;
+    int ndim;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+};
+
+PyObject* make_array(std::shared_ptr<const void> owner, const void* data, char format, Py_ssize_t itemsize,
+                     Py_ssize_t rows, Py_ssize_t cols = -1) {
+    auto* array = PyObject_New(ArrayObject, reinterpret_cast<PyTypeObject*>(array_type));
+    if (!array) return nullptr;
+    array->owner = new std::shared_ptr<const void>(std::move(owner));
+    array->data = data;
+    array->format[0] = format;
+    array->format[1] = '\0';
+    array->itemsize = itemsize;
+    array->ndim = cols < 0 ? 1 : 2;
+    array->shape[0] = rows;
+    array->shape[1] = cols < 0 ? 0 : cols;
+    array->strides[0] = cols < 0 ? itemsize : itemsize * cols;
+    array->strides[1] = itemsize;
+    return reinterpret_cast<PyObject*>(array);
+}
+
+void array_dealloc(PyObject* self) {
+    auto* array = reinterpret_cast<ArrayObject*>(self);
+    delete array->owner;
+    PyTypeObject* type = Py_TYPE(self);
+    PyObject_Free(self);
+    Py_DECREF(type);
+}
+
+int array_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+    auto* array = reinterpret_cast<ArrayObject*>(self);
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "hyperbolicity.Array is read-only");
+        view->obj = nullptr;
+        return -1;
+    }
+    Py_ssize_t count = array->shape[0] * (array->ndim == 2 ? array->shape[1] : 1);
+    view->buf = const_cast<void*>(array->data);
+    view->obj = self;
+    Py_INCREF(self);
+    view->len = count * array->itemsize;
+    view->readonly = 1;
+    view->itemsize = array->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? array->format : nullptr;
+    view->ndim = array->ndim;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? array->shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? array->strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+Py_ssize_t array_length(PyObject* self) {
+    return reinterpret_cast<ArrayObject*>(self)->shape[0];
+}
+
+PyObject* array_item(const ArrayObject* array, Py_ssize_t offset) {
+    const char* p = static_cast<const char*>(array->data) + offset * array->itemsize;
+    if (array->format[0] == 'd') {
+        double value;
+        std::memcpy(&value, p, sizeof(value));
+        return PyFloat_FromDouble(value);
+    }
+    int value;
+    std::memcpy(&value, p, sizeof(value));
+    return PyLong_FromLong(value);
+}
+
+PyObject* array_tolist(PyObject* self, PyObject*) {
+    auto* array = reinterpret_cast<ArrayObject*>(self);
+    const Py_ssize_t rows = array->shape[0];
+    PyObject* list = PyList_New(rows);
+    if (!list) return nullptr;
+    for (Py_ssize_t i = 0; i < rows; ++i) {
+        PyObject* item;
+        if (array->ndim == 1) {
+            item = array_item(array, i);
+        } else {
+            const Py_ssize_t cols = array->shape[1];
+            item = PyList_New(cols);
+            for (Py_ssize_t j = 0; item && j < cols; ++j) {
+                PyObject* value = array_item(array, i * cols + j);
+                if (!value) {
+                    Py_CLEAR(item);
+                    break;
+                }
+                PyList_SET_ITEM(item, j, value);
+            }
+        }
+        if (!item) {
+            Py_DECREF(list);
+            return nullptr;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+PyObject* array_shape(PyObject* self, void*) {
+    auto* array = reinterpret_cast<ArrayObject*>(self);
+    if (array->ndim == 1) return Py_BuildValue("(n)", array->shape[0]);
+    return Py_BuildValue("(nn)", array->shape[0], array->shape[1]);
+}
+
+PyObject* array_repr(PyObject* self) {
+    auto* array = reinterpret_cast<ArrayObject*>(self);
+    if (array->ndim == 1) {
+        return PyUnicode_FromFormat("<hyperbolicity.Array shape=(%zd,) format='%s'>", array->shape[0], array->format);
+    }
+    return PyUnicode_FromFormat("<hyperbolicity.Array shape=(%zd, %zd) format='%s'>",
+                                array->shape[0], array->shape[1], array->format);
+}
+
+PyMethodDef array_methods[] = {
+    {"tolist", array_tolist, METH_NOARGS, "Copy of the values as (nested) Python lists."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyGetSetDef array_getset[] = {
+    {"shape", array_shape, nullptr, "Dimensions of the array.", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+PyType_Slot array_slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(array_dealloc)},
+    {Py_tp_repr, reinterpret_cast<void*>(array_repr)},
+    {Py_tp_methods, array_methods},
+    {Py_tp_getset, array_getset},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(array_getbuffer)},
+    {Py_sq_length, reinterpret_cast<void*>(array_length)},
+    {Py_tp_doc, const_cast<char*>("Read-only view of engine-owned values; numpy.asarray() wraps it without copying.")},
+    {0, nullptr}};
+
+PyType_Spec array_spec = {"hyperbolicity.Array", sizeof(ArrayObject), 0, Py_TPFLAGS_DEFAULT, array_slots};
+
+// --- Edge columns ---
+// One 1-D buffer of edge data, read in place
+class Column {
+public:
+    ~Column() {
+        if (held) PyBuffer_Release(&view);
+    }
+
+    // Sets a Python error and returns false if obj is not a usable column
+    bool open(PyObject* obj, const char* name, bool allow_real) {
+        if (PyObject_GetBuffer(obj, &view, PyBUF_RECORDS_RO) != 0) {
+            PyErr_Format(PyExc_TypeError, "%s must support the buffer protocol (e.g. a NumPy array)", name);
+            return false;
+        }
+        held = true;
+        if (view.ndim != 1) {
+            PyErr_Format(PyExc_ValueError, "%s must be one-dimensional", name);
+            return false;
+        }
+        const char* format = view.format ? view.format : "B";
+        if (*format == '@' || *format == '=' || *format == '<' || (*format == '>' && !big_endian_host())) {
+            if (*format == '>') {
+                PyErr_Format(PyExc_ValueError, "%s must be in native byte order", name);
+                return false;
+            }
+            ++format;
+        }
+        code = format[0];
+        const bool integral = std::strchr("bBhHiIlLqQnN", code) != nullptr && format[1] == '\0';
+        const bool real = (code == 'f' || code == 'd') && format[1] == '\0';
+        if (!integral && !(allow_real && real)) {
+            PyErr_Format(PyExc_TypeError, "%s has unsupported element format '%s'", name, view.format);
+            return false;
+        }
+        is_real = real;
+        stride = view.strides ? view.strides[0] : view.itemsize;
+        return true;
+    }
+
+    Py_ssize_t size() const { return view.shape ? view.shape[0] : view.len / view.itemsize; }
+
+    long long integer(Py_ssize_t i) const {
+        const char* p = static_cast<const char*>(view.buf) + i * stride;
+        switch (code) {
+        case 'b': return load<signed char>(p);
+        case 'B': return load<unsigned char>(p);
+        case 'h': return load<short>(p);
+        case 'H': return load<unsigned short>(p);
+        case 'i': return load<int>(p);
+        case 'I': return load<unsigned int>(p);
+        case 'l': return load<long>(p);
+        case 'L': return clamp(load<unsigned long>(p));
+        case 'q': return load<long long>(p);
+        case 'Q': return clamp(load<unsigned long long>(p));
+        case 'n': return load<Py_ssize_t>(p);
+        default: return clamp(load<size_t>(p));
+        }
+    }
+
+    double real(Py_ssize_t i) const {
+        const char* p = static_cast<const char*>(view.buf) + i * stride;
+        if (code == 'd') return load<double>(p);
+        if (code == 'f') return load<float>(p);
+        return static_cast<double>(integer(i));
+    }
+
+private:
+    Py_buffer view{};
+    bool held = false;
+    bool is_real = false;
+    char code = 'B';
+    Py_ssize_t stride = 1;
+
+    template <class T>
+    static T load(const char* p) {
+        T value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    template <class T>
+    static long long clamp(T value) {
+        return value > static_cast<T>(std::numeric_limits<long long>::max()) ? std::numeric_limits<long long>::max()
+                                                                            : static_cast<long long>(value);
+    }
+    static bool big_endian_host() {
+        const unsigned short probe = 1;
+        unsigned char first;
+        std::memcpy(&first, &probe, 1);
+        return first == 0;
+    }
+};
+
+// --- Graph ---
+struct GraphState {
+    AdjacencyList adj_list;
+    long long edge_count = 0;
+
+    std::mutex mutex;                             // Guards the lazily built members
+    std::shared_ptr<MatrixBuffer<double>> distances;
+    std::unique_ptr<ConnectedComponents> components;
+};
+
+struct GraphObject {
+    PyObject_HEAD
+    GraphState* state;
+};
+
+// Row-major n x n distance matrix, computed on first use (GIL released)
+std::shared_ptr<MatrixBuffer<double>> distances_of(GraphState& state) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.distances) {
+        const size_t n = state.adj_list.size();
+        auto matrix = std::make_shared<MatrixBuffer<double>>(n * n);
+        ShortestPath sp(state.adj_list);
+        sp.compute_all_pairs([&](int source, const std::vector<double>& row) {
+            std::memcpy(matrix->data() + static_cast<size_t>(source) * n, row.data(), n * sizeof(double));
+        });
+        state.distances = std::move(matrix);
+    }
+    return state.distances;
+}
+
+const ConnectedComponents& components_of(GraphState& state) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.components) state.components = std::make_unique<ConnectedComponents>(state.adj_list);
+    return *state.components;
+}
+
+// Calls run(block, m, vertices) for every component of at least four
+// vertices (smaller ones have delta 0). block is the component's m x m
+// distance matrix: the graph's own when it is connected, else a compact copy,
+// so each engine costs the component's size instead of the graph's.
+template <class Run>
+void for_each_component(GraphState& state, Run&& run) {
+    std::shared_ptr<MatrixBuffer<double>> distances = distances_of(state);
+    const ConnectedComponents& cc = components_of(state);
+    const size_t n = state.adj_list.size();
+    if (cc.count() <= 1) {
+        std::vector<int> all(n);
+        for (size_t v = 0; v < n; ++v) all[v] = v;
+        if (n >= 4) run(distances->data(), static_cast<int>(n), all);
+        return;
+    }
+    for (const GraphComponent& part : cc.components()) {
+        const int m = part.vertices.size();
+        if (m < 4) continue;
+        MatrixBuffer<double> block(static_cast<size_t>(m) * m);
+        for (int a = 0; a < m; ++a) {
+            const double* row = distances->data() + static_cast<size_t>(part.vertices[a]) * n;
+            for (int b = 0; b < m; ++b) block[static_cast<size_t>(a) * m + b] = row[part.vertices[b]];
+        }
+        run(block.data(), m, part.vertices);
+    }
+}
+
+GraphState* state_of(PyObject* self) {
+    GraphState* state = reinterpret_cast<GraphObject*>(self)->state;
+    if (!state) PyErr_SetString(PyExc_RuntimeError, "hyperbolicity.Graph was not initialised");
+    return state;
+}
+
+// Computations run without the GIL on the state they found, so a graph is
+// never re-initialised in place: its state lives until the object dies
+bool already_initialised(PyObject* self) {
+    if (!reinterpret_cast<GraphObject*>(self)->state) return false;
+    PyErr_SetString(PyExc_RuntimeError, "hyperbolicity.Graph is already initialised; create a new Graph instead");
+    return true;
+}
+
+int graph_init(PyObject* self, PyObject* args, PyObject* kwds) {
+    static const char* keywords[] = {"src", "dst", "weight", "num_vertices", nullptr};
+    if (already_initialised(self)) return -1;
+    PyObject* src_obj = nullptr;
+    PyObject* dst_obj = nullptr;
+    PyObject* weight_obj = Py_None;
+    Py_ssize_t num_vertices = -1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|On", const_cast<char**>(keywords),
+                                     &src_obj, &dst_obj, &weight_obj, &num_vertices)) {
+        return -1;
+    }
+
+    Column src, dst, weight;
+    if (!src.open(src_obj, "src", false) || !dst.open(dst_obj, "dst", false)) return -1;
+    const bool weighted = weight_obj != Py_None;
+    if (weighted && !weight.open(weight_obj, "weight", true)) return -1;
+    const Py_ssize_t m = src.size();
+    if (dst.size() != m || (weighted && weight.size() != m)) {
+        PyErr_SetString(PyExc_ValueError, "src, dst and weight must have the same length");
+        return -1;
+    }
+
+    auto state = std::make_unique<GraphState>();
+    std::string error;
+    Py_BEGIN_ALLOW_THREADS
+    long long max_id = num_vertices > 0 ? num_vertices - 1 : -1;
+    for (Py_ssize_t e = 0; e < m && error.empty(); ++e) {
+        long long u = src.integer(e), v = dst.integer(e);
+        double w = weighted ? weight.real(e) : 1.0;
+        if (u < 0 || v < 0) error = "vertex ids must be non-negative";
+        else if (num_vertices >= 0 && (u >= num_vertices || v >= num_vertices)) error = "vertex id not below num_vertices";
+        else if (std::max(u, v) >= std::numeric_limits<int>::max()) error = "vertex id too large";
+        else if (!(w >= 0.0) || std::isinf(w)) error = "weights must be finite and non-negative";
+        max_id = std::max({max_id, u, v});
+    }
+    if (error.empty()) {
+        state->adj_list.resize(static_cast<size_t>(max_id + 1));
+        // Edges are undirected and stored in both directions, as GraphParser does
+        for (Py_ssize_t e = 0; e < m; ++e) {
+            int u = static_cast<int>(src.integer(e)), v = static_cast<int>(dst.integer(e));
+            if (u == v) continue;
+            double w = weighted ? weight.real(e) : 1.0;
+            state->adj_list[u].emplace_back(v, w);
+            state->adj_list[v].emplace_back(u, w);
+            ++state->edge_count;
+        }
+    }
+    Py_END_ALLOW_THREADS
+    if (!error.empty()) {
+        PyErr_SetString(PyExc_ValueError, error.c_str());
+        return -1;
+    }
+
+    // Another thread may have initialised it while the GIL was released
+    if (already_initialised(self)) return -1;
+    reinterpret_cast<GraphObject*>(self)->state = state.release();
+    return 0;
+}
+
+void graph_dealloc(PyObject* self) {
+    delete reinterpret_cast<GraphObject*>(self)->state;
+    PyTypeObject* type = Py_TYPE(self);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+PyObject* graph_num_vertices(PyObject* self, void*) {
+    GraphState* state = state_of(self);
+    return state ? PyLong_FromSize_t(state->adj_list.size()) : nullptr;
+}
+
+PyObject* graph_num_edges(PyObject* self, void*) {
+    GraphState* state = state_of(self);
+    return state ? PyLong_FromLongLong(state->edge_count) : nullptr;
+}
+
+PyObject* graph_distances(PyObject* self, PyObject*) {
+    GraphState* state = state_of(self);
+    if (!state) return nullptr;
+    std::shared_ptr<MatrixBuffer<double>> matrix;
+    if (!without_gil([&] { matrix = distances_of(*state); })) return nullptr;
+    const Py_ssize_t n = state->adj_list.size();
+    const double* data = matrix->data();
+    return make_array(std::move(matrix), data, 'd', sizeof(double), n, n);
+}
+
+PyObject* graph_exact(PyObject* self, PyObject* args, PyObject* kwds) {
+    static const char* keywords[] = {"kernel", nullptr};
+    const char* kernel = "auto";
+    MaxMinBackend backend;
+    GraphState* state = state_of(self);
+    if (!state || !PyArg_ParseTupleAndKeywords(args, kwds, "|s", const_cast<char**>(keywords), &kernel) ||
+        !parse_kernel(kernel, backend)) {
+        return nullptr;
+    }
+
+    double delta = 0.0;
+    BaseWitness witness;
+    std::vector<int> witness_vertices;
+    bool ok = without_gil([&] {
+        for_each_component(*state, [&](const double* block, int m, const std::vector<int>& vertices) {
+            HyperbolicityCalculator calc(block, m);
+            calc.set_max_min_backend(backend);
+            BaseWitness w;
+            double value = calc.compute_exact_hyperbolicity(&w);
+            if (value > delta) {
+                delta = value;
+                witness = w;
+                witness_vertices = vertices;
+            }
+        });
+    });
+    if (!ok) return nullptr;
+    return Py_BuildValue("{s:d,s:N}", "delta", delta, "witness", witness_tuple(witness, &witness_vertices));
+}
+
+PyObject* graph_factor2(PyObject* self, PyObject* args, PyObject* kwds) {
+    static const char* keywords[] = {"bases", "kernel", nullptr};
+    PyObject* bases_obj = nullptr;
+    const char* kernel = "auto";
+    MaxMinBackend backend;
+    GraphState* state = state_of(self);
+    if (!state || !PyArg_ParseTupleAndKeywords(args, kwds, "|Os", const_cast<char**>(keywords), &bases_obj, &kernel) ||
+        !parse_kernel(kernel, backend)) {
+        return nullptr;
+    }
+
+    // An int k (k most eccentric vertices of every component) or explicit vertex ids
+    long k = 1;
+    std::vector<int> given;
+    const bool explicit_bases = bases_obj && !PyLong_Check(bases_obj);
+    if (bases_obj && PyLong_Check(bases_obj)) {
+        k = PyLong_AsLong(bases_obj);
+        if (k < 1) {
+            if (!PyErr_Occurred()) PyErr_SetString(PyExc_ValueError, "bases must be at least 1");
+            return nullptr;
+        }
+    } else if (explicit_bases) {
+        PyObject* sequence = PySequence_Fast(bases_obj, "bases must be an int or a sequence of vertex ids");
+        if (!sequence) return nullptr;
+        for (Py_ssize_t b = 0; b < PySequence_Fast_GET_SIZE(sequence); ++b) {
+            long v = PyLong_AsLong(PySequence_Fast_GET_ITEM(sequence, b));
+            if (v == -1 && PyErr_Occurred()) {
+                Py_DECREF(sequence);
+                return nullptr;
+            }
+            if (v < 0 || v >= static_cast<long>(state->adj_list.size())) {
+                Py_DECREF(sequence);
+                PyErr_Format(PyExc_IndexError, "base %ld is not a vertex", v);
+                return nullptr;
+            }
+            given.push_back(static_cast<int>(v));
+        }
+        Py_DECREF(sequence);
+        if (given.empty()) {
+            PyErr_SetString(PyExc_ValueError, "bases must not be empty");
+            return nullptr;
+        }
+    }
+
+    double lower = 0.0, upper = 0.0;
+    BaseWitness witness;
+    std::vector<int> witness_vertices, used;
+    bool ok = without_gil([&] {
+        std::vector<int> order;
+        if (!explicit_bases) order = EccentricityEngine(state->adj_list).vertices_by_eccentricity();
+        std::vector<int> local_of(state->adj_list.size(), -1);
+
+        for_each_component(*state, [&](const double* block, int m, const std::vector<int>& vertices) {
+            for (int a = 0; a < m; ++a) local_of[vertices[a]] = a;
+            std::vector<int> bases;
+            for (int v : explicit_bases ? given : order) {
+                if (local_of[v] >= 0 && (explicit_bases || static_cast<long>(bases.size()) < k)) {
+                    bases.push_back(local_of[v]);
+                }
+            }
+            std::sort(bases.begin(), bases.end());
+            bases.erase(std::unique(bases.begin(), bases.end()), bases.end());
+
+            if (bases.empty()) {
+                upper = INF;  // Nothing bounds this component from above
+            } else {
+                HyperbolicityCalculator calc(block, m);
+                calc.set_max_min_backend(backend);
+                std::vector<BaseWitness> witnesses;
+                std::vector<double> deltas = calc.compute_for_bases(bases, &witnesses);
+                double smallest = INF;
+                for (size_t b = 0; b < bases.size(); ++b) {
+                    used.push_back(vertices[bases[b]]);
+                    smallest = std::min(smallest, deltas[b]);
+                    if (deltas[b] > lower) {
+                        lower = deltas[b];
+                        witness = witnesses[b];
+                        witness_vertices = vertices;
+                    }
+                }
+                upper = std::max(upper, 2 * smallest);
+            }
+            for (int v : vertices) local_of[v] = -1;
+        });
+    });
+    if (!ok) return nullptr;
+
+    PyObject* bases_list = PyList_New(used.size());
+    if (!bases_list) return nullptr;
+    for (size_t b = 0; b < used.size(); ++b) PyList_SET_ITEM(bases_list, b, PyLong_FromLong(used[b]));
+    return Py_BuildValue("{s:d,s:d,s:N,s:N}", "lower", lower, "upper", upper, "bases", bases_list,
+                         "witness", witness_tuple(witness, &witness_vertices));
+}
+
+PyObject* graph_log_approx(PyObject* self, PyObject*) {
+    GraphState* state = state_of(self);
+    if (!state) return nullptr;
+
+    double delta = 0.0;
+    std::pair<int, int> pair{-1, -1};
+    bool exact = true;
+    bool ok = without_gil([&] {
+        // Distance labels per component: no n x n matrix is needed
+        const ConnectedComponents& cc = components_of(*state);
+        for (const GraphComponent& part : cc.components()) {
+            if (part.vertices.size() < 2) continue;
+            DistanceOracle oracle(part.adj_list);
+            if (!oracle.build_labels()) {
+                // Landmark upper bounds stand in for the distances
+                oracle.build_landmarks(LANDMARK_FALLBACK_COUNT);
+                exact = false;
+            }
+            LogApproxHyperbolicity log_approx(oracle, part.adj_list);
+            double value = log_approx.compute_approximate_hyperbolicity();
+            if (value > delta) {
+                delta = value;
+                std::pair<int, int> local = log_approx.distortion_witness();
+                pair = local.first < 0 ? std::pair<int, int>{-1, -1}
+                                       : std::pair<int, int>{part.vertices[local.first], part.vertices[local.second]};
+            }
+        }
+    });
+    if (!ok) return nullptr;
+    PyObject* exact_obj = exact ? Py_True : Py_False;
+    if (pair.first < 0) {
+        return Py_BuildValue("{s:d,s:O,s:O}", "delta", delta, "witness", Py_None, "exact", exact_obj);
+    }
+    return Py_BuildValue("{s:d,s:(ii),s:O}", "delta", delta, "witness", pair.first, pair.second, "exact", exact_obj);
+}
+
+PyObject* graph_local(PyObject* self, PyObject* args, PyObject* kwds) {
+    static const char* keywords[] = {"hops", "radius", "kernel", nullptr};
+    PyObject* hops_obj = Py_None;
+    PyObject* radius_obj = Py_None;
+    const char* kernel = "auto";
+    LocalOptions options;
+    GraphState* state = state_of(self);
+    if (!state || !PyArg_ParseTupleAndKeywords(args, kwds, "|OOs", const_cast<char**>(keywords),
+                                               &hops_obj, &radius_obj, &kernel) ||
+        !parse_kernel(kernel, options.max_min_backend)) {
+        return nullptr;
+    }
+    if ((hops_obj == Py_None) == (radius_obj == Py_None)) {
+        PyErr_SetString(PyExc_TypeError, "give exactly one of hops and radius");
+        return nullptr;
+    }
+    if (hops_obj != Py_None) {
+        long hops = PyLong_AsLong(hops_obj);
+        if (hops == -1 && PyErr_Occurred()) return nullptr;
+        options.kind = BallKind::Hops;
+        options.size = hops;
+    } else {
+        options.size = PyFloat_AsDouble(radius_obj);
+        if (options.size == -1.0 && PyErr_Occurred()) return nullptr;
+        options.kind = BallKind::Radius;
+    }
+
+    auto profile = std::make_shared<LocalProfile>();
+    bool ok = without_gil([&] {
+        std::shared_ptr<MatrixBuffer<double>> distances = distances_of(*state);
+        *profile = LocalHyperbolicity(distances->data(), state->adj_list).compute(options);
+    });
+    if (!ok) return nullptr;
+
+    const Py_ssize_t n = state->adj_list.size();
+    PyObject* delta = make_array(profile, profile->delta.data(), 'd', sizeof(double), n);
+    PyObject* ball_size = delta ? make_array(profile, profile->ball_size.data(), 'i', sizeof(int), n) : nullptr;
+    if (!ball_size) {
+        Py_XDECREF(delta);
+        return nullptr;
+    }
+    return Py_BuildValue("{s:N,s:N,s:i,s:L}", "delta", delta, "ball_size", ball_size,
+                         "distinct_balls", profile->distinct_balls, "bases", profile->bases_evaluated);
+}
+
+PyMethodDef graph_methods[] = {
+    {"distances", graph_distances, METH_NOARGS,
+     "distances() -> Array\n\nAll-pairs shortest path distances as an n x n float64 view over the\n"
+     "engine's matrix (inf between components). Computed once, without the GIL."},
+    {"exact", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(graph_exact)), METH_VARARGS | METH_KEYWORDS,
+     "exact(kernel='auto') -> {'delta', 'witness'}\n\nExact delta (max over components) and the quadruple\n"
+     "(r, i, j, k) realising it, or None when delta is 0."},
+    {"factor2", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(graph_factor2)), METH_VARARGS | METH_KEYWORDS,
+     "factor2(bases=1, kernel='auto') -> {'lower', 'upper', 'bases', 'witness'}\n\n"
+     "Bounds lower <= delta <= upper from the given vertex ids, or from the\n"
+     "k most eccentric vertices of every component when bases is an int."},
+    {"log_approx", graph_log_approx, METH_NOARGS,
+     "log_approx() -> {'delta', 'witness', 'exact'}\n\nO(log n) approximation on distance labels; no distance matrix is built.\n"
+     "'exact' is False if the labels grew too large for some component and landmark upper bounds\n"
+     "stood in for its distances; delta is then only an estimate."},
+    {"local", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(graph_local)), METH_VARARGS | METH_KEYWORDS,
+     "local(hops=None, radius=None, kernel='auto') -> {'delta', 'ball_size', 'distinct_balls', 'bases'}\n\n"
+     "Exact delta of the k-hop or radius ball around every vertex; delta and\n"
+     "ball_size are per-vertex Array views."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyGetSetDef graph_getset[] = {
+    {"num_vertices", graph_num_vertices, nullptr, "Number of vertices.", nullptr},
+    {"num_edges", graph_num_edges, nullptr, "Number of undirected edges (self-loops dropped).", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+PyType_Slot graph_slots[] = {
+    {Py_tp_new, reinterpret_cast<void*>(PyType_GenericNew)},
+    {Py_tp_init, reinterpret_cast<void*>(graph_init)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(graph_dealloc)},
+    {Py_tp_methods, graph_methods},
+    {Py_tp_getset, graph_getset},
+    {Py_tp_doc, const_cast<char*>(
+        "Graph(src, dst, weight=None, num_vertices=None)\n\n"
+        "Undirected graph on vertices 0..n-1 from edge columns: any 1-D buffers\n"
+        "(NumPy arrays, array.array, memoryview) of integer ids and, optionally,\n"
+        "non-negative weights (default 1). The columns are read in place.\n"
+        "Every computation releases the GIL. A Graph is initialised once.")},
+    {0, nullptr}};
+
+PyType_Spec graph_spec = {"hyperbolicity.Graph", sizeof(GraphObject), 0,
+                          Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, graph_slots};
+
+PyModuleDef module_def = {
+    PyModuleDef_HEAD_INIT, "hyperbolicity",
+    "Gromov hyperbolicity engines (exact, Factor-2, Log, local) over edge arrays.",
+    -1, nullptr, nullptr, nullptr, nullptr, nullptr};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_hyperbolicity() {
+    PyObject* module = PyModule_Create(&module_def);
+    if (!module) return nullptr;
+    array_type = PyType_FromSpec(&array_spec);
+    graph_type = PyType_FromSpec(&graph_spec);
+    if (!array_type || !graph_type ||
+        PyModule_AddObjectRef(module, "Array", array_type) < 0 ||
+        PyModule_AddObjectRef(module, "Graph", graph_type) < 0) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
@@ -0,0 +1,54 @@
+# Builds the "hyperbolicity" extension from the Qt-free engine sources:
+#   python setup.py build_ext --inplace      (or: pip install ./python)
+import os
+import sys
+
+from setuptools import Extension, setup
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.relpath(os.path.join(HERE, ".."), HERE)
+
+CORE = [
+    "ShortestPath.cpp",
+    "Hyperbolicity.cpp",
+    "MaxMinProduct.cpp",
+    "MatrixMemory.cpp",
+    "Eccentricity.cpp",
+    "Components.cpp",
+    "DistanceOracle.cpp",
+    "LogApproximation.cpp",
+    "LocalHyperbolicity.cpp",
+]
+
+# OpenMP flags per platform, as in src/hyperbolicity.pro
+compile_args, link_args, libraries, include_dirs, library_dirs = [], [], [], [], []
+if sys.platform == "win32":
+    compile_args += ["/std:c++17", "/O2", "/openmp"]
+elif sys.platform == "darwin":
+    brew = "/usr/local" if os.path.exists("/usr/local/bin/brew") else "/opt/homebrew"
+    compile_args += ["-std=c++17", "-O3", "-Xpreprocessor", "-fopenmp"]
+    include_dirs.append(os.path.join(brew, "opt/libomp/include"))
+    library_dirs.append(os.path.join(brew, "opt/libomp/lib"))
+    libraries.append("omp")
+else:
+    compile_args += ["-std=c++17", "-O3", "-fopenmp"]
+    link_args += ["-fopenmp"]
+
+setup(
+    name="hyperbolicity",
+    version="0.1",
+    description="Gromov hyperbolicity engines over NumPy edge arrays",
+    ext_modules=[
+        Extension(
+            "hyperbolicity",
+            sources=["hyperbolicity_module.cpp"] + [os.path.join(ROOT, "src", f) for f in CORE],
+            include_dirs=[os.path.join(ROOT, "include")] + include_dirs,
+            library_dirs=library_dirs,
+            libraries=libraries,
+            extra_compile_args=compile_args,
+            extra_link_args=link_args,
+            language="c++",
+        )
+    ],
+    python_requires=">=3.10",
+)
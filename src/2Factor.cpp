@@ -1,14 +1,24 @@
 #include "2Factor.h"
 #include "Hyperbolicity.h"
+#include "Eccentricity.h"
 #include <algorithm>
 #include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
 
 // Constructor
 TwoFactorApproximation::TwoFactorApproximation(const std::vector<std::vector<double>>& dist_matrix)
     : distances(dist_matrix) {}
 
-// Compute eccentricity for all nodes (O(n^2))
+TwoFactorApproximation::TwoFactorApproximation(const std::vector<std::vector<double>>& dist_matrix,
+                                               EccentricityEngine& eccentricity)
+    : distances(dist_matrix), eccentricity_engine(&eccentricity) {}
+
+// Compute eccentricity for all nodes (O(n^2) from the matrix, or via the bounding engine)
 std::vector<double> TwoFactorApproximation::compute_eccentricities() const {
+    if (eccentricity_engine) return eccentricity_engine->compute_eccentricities();
+
     int n = distances.size();
     std::vector<double> ecc(n, -INFINITY);
     
@@ -20,6 +30,7 @@ std::vector<double> TwoFactorApproximation::compute_eccentricities() const {
 
 // Select node with maximum eccentricity
 int TwoFactorApproximation::select_base_heuristic() const {
+    if (eccentricity_engine) return eccentricity_engine->peripheral_vertex();
     auto ecc = compute_eccentricities();
     auto max_it = std::max_element(ecc.begin(), ecc.end());
     return std::distance(ecc.begin(), max_it);  // Index of max eccentricity
@@ -28,7 +39,101 @@ int TwoFactorApproximation::select_base_heuristic() const {
 // Approximation entry point
 double TwoFactorApproximation::compute_approximate_hyperbolicity() {
     HyperbolicityCalculator hc(distances);
+    hc.set_max_min_backend(max_min_backend);
+    hc.set_matrix_memory(memory_config);
     int r = select_base_heuristic();
     double delta_r = hc.compute_for_base(r);
     return 2 * delta_r;
-}
\ No newline at end of file
+}
+
+// Pick k distinct bases according to the requested strategy
+std::vector<int> TwoFactorApproximation::select_bases(int k, BaseSelection selection, unsigned int seed,
+                                                      const std::vector<int>& ids) const {
+    int n = distances.size();
+    k = std::max(0, std::min(k, n));
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    if (static_cast<int>(ids.size()) == n) {
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return ids[a] < ids[b]; });
+    }
+
+    if (selection == BaseSelection::Eccentricity) {
+        auto ecc = compute_eccentricities();
+        std::stable_sort(order.begin(), order.end(),
+                         [&](int a, int b) { return ecc[a] > ecc[b]; });
+    } else if (selection == BaseSelection::Centrality) {
+        // Closeness: sum of finite distances, unreachable nodes penalised by count
+        std::vector<double> total(n, 0.0);
+        std::vector<int> unreachable(n, 0);
+        for (int i = 0; i < n; ++i) {
+            for (double d : distances[i]) {
+                if (std::isinf(d)) ++unreachable[i];
+                else total[i] += d;
+            }
+        }
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            if (unreachable[a] != unreachable[b]) return unreachable[a] < unreachable[b];
+            return total[a] < total[b];
+        });
+    } else {
+        std::mt19937 rng(seed);
+        std::shuffle(order.begin(), order.end(), rng);
+    }
+
+    order.resize(k);
+    return order;
+}
+
+// Multi-base entry point
+MultiBaseResult TwoFactorApproximation::compute_multi_base(int k, BaseSelection selection, unsigned int seed) {
+    std::vector<double> known_deltas(distances.size(), NAN);
+    return evaluate_bases(select_bases(k, selection, seed), known_deltas);
+}
+
+MultiBaseResult TwoFactorApproximation::evaluate_bases(const std::vector<int>& bases,
+                                                      std::vector<double>& known_deltas,
+                                                      std::vector<BaseWitness>* known_witnesses) {
+    MultiBaseResult result;
+    result.bases = bases;
+    if (result.bases.empty()) return result;
+    if (known_deltas.size() != distances.size() ||
+        (known_witnesses && known_witnesses->size() != distances.size())) {
+        throw std::invalid_argument("evaluate_bases: one known delta entry per vertex expected.");
+    }
+
+    // Without a caller-owned table the witnesses of this call are kept locally
+    std::vector<BaseWitness> local_witnesses;
+    if (!known_witnesses) {
+        local_witnesses.assign(distances.size(), BaseWitness{});
+        known_witnesses = &local_witnesses;
+    }
+
+    std::vector<int> missing;
+    for (int r : result.bases) {
+        if (std::isnan(known_deltas[r])) missing.push_back(r);
+    }
+    if (!missing.empty()) {
+        HyperbolicityCalculator hc(distances);
+        hc.set_max_min_backend(max_min_backend);
+        hc.set_matrix_memory(memory_config);
+        std::vector<BaseWitness> fresh_witnesses;
+        std::vector<double> fresh = hc.compute_for_bases(missing, &fresh_witnesses);
+        for (size_t m = 0; m < missing.size(); ++m) {
+            known_deltas[missing[m]] = fresh[m];
+            (*known_witnesses)[missing[m]] = fresh_witnesses[m];
+        }
+    }
+    for (int r : result.bases) result.base_deltas.push_back(known_deltas[r]);
+
+    // The base with the largest delta_r backs the lower bound
+    double best = -INFINITY;
+    for (int r : result.bases) {
+        if (known_deltas[r] > best) {
+            best = known_deltas[r];
+            result.witness = (*known_witnesses)[r];
+        }
+    }
+    result.lower_bound = *std::max_element(result.base_deltas.begin(), result.base_deltas.end());
+    result.upper_bound = 2 * *std::min_element(result.base_deltas.begin(), result.base_deltas.end());
+    return result;
+}
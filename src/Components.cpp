@@ -0,0 +1,58 @@
+#include "Components.h"
+#include <algorithm>
+#include <numeric>
+
+ConnectedComponents::ConnectedComponents(const std::vector<std::vector<std::pair<int, double>>>& adj_list) {
+    int n = adj_list.size();
+    membership.assign(n, -1);
+
+    // --- 1. Label components with an iterative DFS ---
+    std::vector<std::vector<int>> groups;
+    std::vector<int> stack;
+    for (int s = 0; s < n; ++s) {
+        if (membership[s] != -1) continue;
+        int label = groups.size();
+        groups.emplace_back();
+        membership[s] = label;
+        stack.push_back(s);
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+            groups[label].push_back(u);
+            for (const auto& [v, weight] : adj_list[u]) {
+                if (membership[v] == -1) {
+                    membership[v] = label;
+                    stack.push_back(v);
+                }
+            }
+        }
+    }
+
+    // --- 2. Largest first, so schedulers can hand out big work early ---
+    std::vector<int> order(groups.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return groups[a].size() > groups[b].size(); });
+
+    parts.resize(groups.size());
+    std::vector<int> local_id(n, -1);
+    for (size_t c = 0; c < order.size(); ++c) {
+        GraphComponent& part = parts[c];
+        part.vertices = std::move(groups[order[c]]);
+        std::sort(part.vertices.begin(), part.vertices.end());
+        for (size_t i = 0; i < part.vertices.size(); ++i) {
+            local_id[part.vertices[i]] = i;
+            membership[part.vertices[i]] = c;
+        }
+    }
+
+    // --- 3. Local adjacency lists ---
+    for (GraphComponent& part : parts) {
+        part.adj_list.resize(part.vertices.size());
+        for (size_t i = 0; i < part.vertices.size(); ++i) {
+            for (const auto& [v, weight] : adj_list[part.vertices[i]]) {
+                part.adj_list[i].emplace_back(local_id[v], weight);
+            }
+        }
+    }
+}
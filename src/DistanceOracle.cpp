@@ -0,0 +1,210 @@
+#include "DistanceOracle.h"
+#include "ShortestPath.h"
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <stdexcept>
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+DistanceOracle::DistanceOracle(const std::vector<std::vector<std::pair<int, double>>>& adj_list)
+    : adjacency_list(adj_list), n(adj_list.size()) {}
+
+// --- Pruned landmark labeling ---
+bool DistanceOracle::build_labels(int max_avg_label) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Hubs in decreasing degree order
+    rank_to_vertex.resize(n);
+    std::iota(rank_to_vertex.begin(), rank_to_vertex.end(), 0);
+    std::stable_sort(rank_to_vertex.begin(), rank_to_vertex.end(), [&](int a, int b) {
+        return adjacency_list[a].size() > adjacency_list[b].size();
+    });
+
+    label_hubs.assign(n, {});
+    label_dists.assign(n, {});
+    const size_t max_entries = static_cast<size_t>(max_avg_label) * std::max(n, 1);
+    size_t total_entries = 0;
+
+    std::vector<double> root_label(n + 1, INF);  // Root's label indexed by hub rank
+    std::vector<double> dist(n, INF);
+    std::vector<int> touched;
+    using QueueItem = std::pair<double, int>;
+
+    for (int rank = 0; rank < n; ++rank) {
+        int root = rank_to_vertex[rank];
+        for (size_t e = 0; e < label_hubs[root].size(); ++e) {
+            root_label[label_hubs[root][e]] = label_dists[root][e];
+        }
+
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> pq;
+        dist[root] = 0.0;
+        touched.push_back(root);
+        pq.emplace(0.0, root);
+
+        while (!pq.empty()) {
+            auto [d, u] = pq.top();
+            pq.pop();
+            if (d > dist[u]) continue;
+
+            // Prune if an earlier hub already certifies d(root, u) <= d
+            bool covered = false;
+            for (size_t e = 0; e < label_hubs[u].size(); ++e) {
+                if (root_label[label_hubs[u][e]] + label_dists[u][e] <= d) {
+                    covered = true;
+                    break;
+                }
+            }
+            if (covered) continue;
+
+            label_hubs[u].push_back(rank);
+            label_dists[u].push_back(d);
+            ++total_entries;
+
+            for (const auto& [v, weight] : adjacency_list[u]) {
+                double nd = d + weight;
+                if (nd < dist[v]) {
+                    if (dist[v] == INF) touched.push_back(v);
+                    dist[v] = nd;
+                    pq.emplace(nd, v);
+                }
+            }
+        }
+
+        for (int v : touched) dist[v] = INF;
+        touched.clear();
+        for (size_t e = 0; e < label_hubs[root].size(); ++e) {
+            root_label[label_hubs[root][e]] = INF;
+        }
+
+        if (total_entries > max_entries) {
+            label_hubs.clear();
+            label_dists.clear();
+            labels_built = false;
+            build_time_ms += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            return false;
+        }
+    }
+
+    // Sentinels make the merge loop branch-light
+    for (int v = 0; v < n; ++v) {
+        label_hubs[v].push_back(n);
+        label_dists[v].push_back(INF);
+        label_hubs[v].shrink_to_fit();
+        label_dists[v].shrink_to_fit();
+    }
+    labels_built = true;
+    build_time_ms += std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+double DistanceOracle::label_query(int u, int v) const {
+    const std::uint32_t* hu = label_hubs[u].data();
+    const std::uint32_t* hv = label_hubs[v].data();
+    const double* du = label_dists[u].data();
+    const double* dv = label_dists[v].data();
+    double best = INF;
+    size_t i = 0, j = 0;
+    while (true) {
+        if (hu[i] == hv[j]) {
+            if (hu[i] == static_cast<std::uint32_t>(n)) break;
+            best = std::min(best, du[i] + dv[j]);
+            ++i;
+            ++j;
+        } else if (hu[i] < hv[j]) {
+            ++i;
+        } else {
+            ++j;
+        }
+    }
+    return best;
+}
+
+// --- Landmark bounds ---
+void DistanceOracle::build_landmarks(int k) {
+    auto start = std::chrono::steady_clock::now();
+    landmarks.clear();
+    landmark_dist.clear();
+    k = std::max(0, std::min(k, n));
+    if (k == 0) return;
+
+    ShortestPath sp(adjacency_list);
+    int next = 0;
+    for (int v = 1; v < n; ++v) {
+        if (adjacency_list[v].size() > adjacency_list[next].size()) next = v;
+    }
+
+    // Farthest-first: each new landmark maximises its distance to the chosen
+    // ones; unreachable vertices count as farthest so every component gets one
+    std::vector<double> nearest(n, INF);
+    for (int l = 0; l < k; ++l) {
+        landmarks.push_back(next);
+        landmark_dist.push_back(sp.compute_single_source(next));
+        const std::vector<double>& row = landmark_dist.back();
+        for (int v = 0; v < n; ++v) nearest[v] = std::min(nearest[v], row[v]);
+        next = std::distance(nearest.begin(), std::max_element(nearest.begin(), nearest.end()));
+    }
+    build_time_ms += std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+std::pair<double, double> DistanceOracle::bounds(int u, int v) const {
+    if (u == v) return {0.0, 0.0};
+    double lower = 0.0;
+    double upper = INF;
+    for (const std::vector<double>& row : landmark_dist) {
+        double du = row[u];
+        double dv = row[v];
+        if (du == INF && dv == INF) continue;
+        if (du == INF || dv == INF) return {INF, INF};  // Different components
+        lower = std::max(lower, std::abs(du - dv));
+        upper = std::min(upper, du + dv);
+    }
+    return {lower, upper};
+}
+
+double DistanceOracle::query(int u, int v) const {
+    if (u < 0 || v < 0 || u >= n || v >= n) {
+        throw std::out_of_range("DistanceOracle::query: vertex index out of range.");
+    }
+    if (labels_built) return label_query(u, v);
+    if (landmark_dist.empty()) {
+        throw std::logic_error("DistanceOracle::query: neither labels nor landmarks have been built.");
+    }
+    return bounds(u, v).second;
+}
+
+// --- Reporting ---
+size_t DistanceOracle::label_entries() const {
+    size_t total = 0;
+    for (const auto& hubs : label_hubs) total += hubs.empty() ? 0 : hubs.size() - 1;
+    return total;
+}
+
+size_t DistanceOracle::memory_bytes() const {
+    size_t bytes = 0;
+    for (const auto& hubs : label_hubs) bytes += hubs.size() * (sizeof(std::uint32_t) + sizeof(double));
+    bytes += rank_to_vertex.size() * sizeof(int);
+    bytes += landmark_dist.size() * static_cast<size_t>(n) * sizeof(double);
+    return bytes;
+}
+
+double DistanceOracle::measure_query_ns(int samples, unsigned int seed) const {
+    if (n == 0 || samples <= 0) return 0.0;
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    std::vector<std::pair<int, int>> pairs(samples);
+    for (auto& p : pairs) p = {pick(rng), pick(rng)};
+
+    volatile double sink = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& [u, v] : pairs) sink = sink + query(u, v);
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / samples;
+}
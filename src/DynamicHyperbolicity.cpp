@@ -0,0 +1,512 @@
+#include "DynamicHyperbolicity.h"
+#include "ShortestPath.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <omp.h>
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+// One patched triple (three Gromov products, scattered reads) against one
+// step of the dense max-min kernel, measured on ring-plus-chord graphs.
+constexpr double PATCH_TRIPLE_COST = 6.0;
+
+DynamicHyperbolicity::DynamicHyperbolicity(const std::vector<std::vector<std::pair<int, double>>>& adj_list,
+                                           const std::vector<int>& tracked)
+    : adjacency(adj_list), track_all(tracked.empty()), bases(tracked) {
+    int n = adjacency.size();
+    if (track_all) {
+        bases.resize(n);
+        std::iota(bases.begin(), bases.end(), 0);
+    }
+    for (int r : bases) {
+        if (r < 0 || r >= n) {
+            throw std::out_of_range("DynamicHyperbolicity: base index out of range.");
+        }
+    }
+}
+
+void DynamicHyperbolicity::initialize(MaxMinBackend backend, std::vector<std::vector<double>> dist_matrix) {
+    max_min_backend = backend;
+    if (!dist_matrix.empty() && dist_matrix.size() == adjacency.size()) {
+        distances = std::move(dist_matrix);
+    } else {
+        ShortestPath sp(adjacency);
+        distances = sp.compute_all_pairs();
+    }
+
+    HyperbolicityCalculator hc(distances);
+    hc.set_max_min_backend(max_min_backend);
+    hc.set_matrix_memory(memory_config);
+    deltas.assign(bases.size(), 0.0);
+    witnesses.assign(bases.size(), BaseWitness{});
+    exact.assign(bases.size(), 1);
+    for (size_t b = 0; b < bases.size(); ++b) {
+        deltas[b] = hc.compute_for_base(bases[b], &witnesses[b]);
+    }
+}
+
+int DynamicHyperbolicity::add_vertex() {
+    int id = adjacency.size();
+    adjacency.emplace_back();
+    for (auto& row : distances) row.push_back(INF);
+    distances.emplace_back(id + 1, INF);
+    distances[id][id] = 0.0;
+    if (track_all) {
+        bases.push_back(id);
+        deltas.push_back(0.0);
+        witnesses.push_back(BaseWitness{id, id, id, id});
+        exact.push_back(1);
+    }
+    return id;
+}
+
+double DynamicHyperbolicity::max_base_delta() const {
+    double best = 0.0;
+    for (double d : deltas) best = std::max(best, d);
+    return best;
+}
+
+// Bounded entries never exceed the largest exact one, so an exact base reaches the max
+BaseWitness DynamicHyperbolicity::max_base_witness() const {
+    BaseWitness best;
+    double best_delta = -INF;
+    for (size_t b = 0; b < deltas.size(); ++b) {
+        if (exact[b] && deltas[b] > best_delta) {
+            best_delta = deltas[b];
+            best = witnesses[b];
+        }
+    }
+    return best;
+}
+
+// --- Edge bookkeeping (parallel entries collapse to their minimum) ---
+double DynamicHyperbolicity::current_weight(int u, int v) const {
+    double w = INF;
+    for (const auto& [x, weight] : adjacency[u]) {
+        if (x == v) w = std::min(w, weight);
+    }
+    return w;
+}
+
+void DynamicHyperbolicity::set_weight(int u, int v, double weight) {
+    auto drop = [](std::vector<std::pair<int, double>>& list, int x) {
+        list.erase(std::remove_if(list.begin(), list.end(),
+                                  [x](const std::pair<int, double>& e) { return e.first == x; }),
+                   list.end());
+    };
+    drop(adjacency[u], v);
+    drop(adjacency[v], u);
+    if (weight != INF) {
+        adjacency[u].emplace_back(v, weight);
+        adjacency[v].emplace_back(u, weight);
+    }
+}
+
+void DynamicHyperbolicity::record_change(int s, int t) {
+    if (s == t || every_pair_changed) return;
+    std::uint64_t key = (static_cast<std::uint64_t>(std::min(s, t)) << 32) | static_cast<std::uint32_t>(std::max(s, t));
+    if (changed.insert(key).second) changed_list.emplace_back(std::min(s, t), std::max(s, t));
+}
+
+bool DynamicHyperbolicity::pair_changed(int a, int b) const {
+    if (a == b) return false;
+    if (every_pair_changed) return true;
+    std::uint64_t key = (static_cast<std::uint64_t>(std::min(a, b)) << 32) | static_cast<std::uint32_t>(std::max(a, b));
+    return changed.count(key) != 0;
+}
+
+// --- Distance repair ---
+// Insertion or decrease: only sources that the edge now shortcuts change, and
+// if d(s, t) drops both s and t are such sources, so each row is written by
+// exactly one thread.
+void DynamicHyperbolicity::decrease_edge(int u, int v, double weight, DynamicUpdateStats& stats) {
+    int n = distances.size();
+    const std::vector<double> row_u = distances[u];
+    const std::vector<double> row_v = distances[v];
+
+    std::vector<int> affected;
+    for (int s = 0; s < n; ++s) {
+        if (row_u[s] + weight < row_v[s] || row_v[s] + weight < row_u[s]) affected.push_back(s);
+    }
+    stats.repaired_sources += affected.size();
+
+    std::vector<std::vector<std::pair<int, int>>> local_changes(omp_get_max_threads());
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int a = 0; a < static_cast<int>(affected.size()); ++a) {
+        int s = affected[a];
+        std::vector<double>& row_s = distances[s];
+        double via_u = row_u[s] + weight;  // s -> u -> v -> t
+        double via_v = row_v[s] + weight;  // s -> v -> u -> t
+        auto& changes = local_changes[omp_get_thread_num()];
+        for (int t = 0; t < n; ++t) {
+            double nd = std::min(via_u + row_v[t], via_v + row_u[t]);
+            if (nd < row_s[t]) {
+                row_s[t] = nd;
+                if (s < t) changes.emplace_back(s, t);
+            }
+        }
+    }
+    for (const auto& changes : local_changes) {
+        for (const auto& [s, t] : changes) record_change(s, t);
+    }
+}
+
+// Increase or removal: a source is affected only if the old edge was tight on
+// one of its shortest paths, and within its row only the targets reached
+// through the edge can move; every other target keeps a shortest path that
+// avoids it. Those targets are settled again by a Dijkstra search confined to
+// them, seeded from their neighbours outside the set.
+void DynamicHyperbolicity::increase_edge(int u, int v, double old_weight, DynamicUpdateStats& stats) {
+    int n = distances.size();
+    auto tight = [&](double near, double far) {
+        return near != INF && std::abs(near + old_weight - far) <= 1e-9 * std::max(1.0, std::abs(far));
+    };
+
+    std::vector<int> affected;
+    for (int s = 0; s < n; ++s) {
+        if (tight(distances[s][u], distances[s][v]) || tight(distances[s][v], distances[s][u])) {
+            affected.push_back(s);
+        }
+    }
+    stats.recomputed_sources += affected.size();
+
+    // New distances per affected source, written back once every row is read
+    std::vector<std::vector<std::pair<int, double>>> updates(affected.size());
+    const std::vector<double>& row_u = distances[u];
+    const std::vector<double>& row_v = distances[v];
+    #pragma omp parallel
+    {
+        std::vector<double> dist(n, INF);
+        std::vector<char> moved(n, 0);
+        std::vector<int> targets;
+        #pragma omp for schedule(dynamic)
+        for (int a = 0; a < static_cast<int>(affected.size()); ++a) {
+            const int s = affected[a];
+            const std::vector<double>& row_s = distances[s];
+            targets.clear();
+            for (int t = 0; t < n; ++t) {
+                if (t == s || row_s[t] == INF) continue;
+                const double through_uv = row_s[u] + old_weight + row_v[t];
+                const double through_vu = row_s[v] + old_weight + row_u[t];
+                if (std::abs(std::min(through_uv, through_vu) - row_s[t]) <= 1e-9 * std::max(1.0, row_s[t])) {
+                    moved[t] = 1;
+                    targets.push_back(t);
+                }
+            }
+
+            std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, std::greater<>> pq;
+            for (int t : targets) {
+                dist[t] = INF;
+                for (const auto& [x, weight] : adjacency[t]) {
+                    if (!moved[x]) dist[t] = std::min(dist[t], row_s[x] + weight);
+                }
+                if (dist[t] != INF) pq.emplace(dist[t], t);
+            }
+            while (!pq.empty()) {
+                auto [d, t] = pq.top();
+                pq.pop();
+                if (d > dist[t]) continue;
+                for (const auto& [x, weight] : adjacency[t]) {
+                    if (moved[x] && d + weight < dist[x]) {
+                        dist[x] = d + weight;
+                        pq.emplace(dist[x], x);
+                    }
+                }
+            }
+            for (int t : targets) {
+                if (dist[t] != row_s[t]) updates[a].emplace_back(t, dist[t]);
+                moved[t] = 0;
+            }
+        }
+    }
+
+    for (size_t a = 0; a < affected.size(); ++a) {
+        int s = affected[a];
+        for (const auto& [t, d] : updates[a]) {
+            record_change(s, t);
+            distances[s][t] = d;
+            distances[t][s] = d;
+        }
+    }
+}
+
+// --- Base re-evaluation ---
+double DynamicHyperbolicity::gromov(int r, int x, int y) const {
+    double dr_x = distances[r][x];
+    double dr_y = distances[r][y];
+    double dx_y = distances[x][y];
+    if (dr_x == INF || dr_y == INF || dx_y == INF) return -INF;
+    return 0.5 * (dr_x + dr_y - dx_y);
+}
+
+// Same quantity compute_for_base maximises, min(A_ik, A_kj) - A_ij, from the
+// three Gromov products of the triple. A_ij = -INF only if i or j is cut off
+// from r, and then so is one of the other two.
+static inline double triple_value(double a_ij, double a_ik, double a_kj) {
+    if (a_ij == -INF) return -INF;
+    return std::min(a_ik, a_kj) - a_ij;
+}
+
+bool DynamicHyperbolicity::witness_affected(const BaseWitness& w) const {
+    const int q[4] = {w.r, w.i, w.j, w.k};
+    for (int a = 0; a < 4; ++a) {
+        for (int b = a + 1; b < 4; ++b) {
+            if (pair_changed(q[a], q[b])) return true;
+        }
+    }
+    return false;
+}
+
+// Max over the triples whose quadruple with r contains a changed pair. The
+// value is symmetric in (i, j), so each unordered triple {x, y, z} has three
+// distinct values, one per choice of k.
+double DynamicHyperbolicity::patch_base(int b) {
+    int n = distances.size();
+    int r = bases[b];
+    double best = deltas[b];
+    BaseWitness& witness = witnesses[b];
+
+    auto consider = [&](double val, int i, int j, int k) {
+        if (val > best) {
+            best = val;
+            witness = BaseWitness{r, i, j, k};
+        }
+    };
+
+    std::vector<double> row_x(n);
+    for (const auto& [a, c] : changed_list) {
+        if (a == r || c == r) {
+            // d(r, x) changed: every Gromov product involving x moves
+            int x = (a == r) ? c : a;
+            for (int y = 0; y < n; ++y) row_x[y] = gromov(r, x, y);
+            for (int y = 0; y < n; ++y) {
+                for (int z = 0; z < n; ++z) {
+                    double a_yz = gromov(r, y, z);
+                    consider(triple_value(row_x[y], row_x[z], a_yz), x, y, z);
+                    consider(triple_value(a_yz, row_x[y], row_x[z]), y, z, x);
+                }
+            }
+        } else {
+            double a_ac = gromov(r, a, c);
+            for (int y = 0; y < n; ++y) {
+                double a_ay = gromov(r, a, y);
+                double a_cy = gromov(r, c, y);
+                consider(triple_value(a_ac, a_ay, a_cy), a, c, y);
+                consider(triple_value(a_ay, a_ac, a_cy), a, y, c);
+                consider(triple_value(a_cy, a_ac, a_ay), c, y, a);
+            }
+        }
+    }
+    return best;
+}
+
+// All-bases mode (bases[b] == b). Each quadruple {a, c, x, y} with a changed
+// pair {a, c} is evaluated once per changed pair it holds; its four-point
+// value, (largest - middle of the three pair sums) / 2, is the triple value of
+// each of its vertices as base, with that vertex's partner in the largest sum
+// as k. Quadruples without a changed pair keep their values, which are at
+// most the old delta_r of each of their vertices.
+void DynamicHyperbolicity::patch_all_bases(DynamicUpdateStats& stats) {
+    const int n = distances.size();
+    const int pairs = changed_list.size();
+    const int threads = omp_get_max_threads();
+    std::vector<std::vector<double>> thread_best(threads, std::vector<double>(n, -INF));
+    std::vector<std::vector<BaseWitness>> thread_witness(threads, std::vector<BaseWitness>(n));
+
+    #pragma omp parallel
+    {
+        std::vector<double>& best = thread_best[omp_get_thread_num()];
+        std::vector<BaseWitness>& witness = thread_witness[omp_get_thread_num()];
+        // Base r of quadruple q with pair sums s[0..2] = {q0 q1 | q2 q3}, {q0 q2 | q1 q3}, {q0 q3 | q1 q2}
+        auto raise = [&](int r, double val, const int q[4], int top) {
+            static const int pairing[3][4] = {{0, 1, 2, 3}, {0, 2, 1, 3}, {0, 3, 1, 2}};
+            int slot[4];
+            for (int s = 0; s < 4; ++s) slot[s] = q[pairing[top][s]];
+            // r's partner in the largest sum is k, the other pair is (i, j)
+            const int own = slot[0] == r ? 0 : slot[1] == r ? 1 : slot[2] == r ? 2 : 3;
+            const int k = slot[own ^ 1];
+            const int i = slot[own < 2 ? 2 : 0], j = slot[own < 2 ? 3 : 1];
+            best[r] = val;
+            witness[r] = BaseWitness{r, i, j, k};
+        };
+
+        #pragma omp for schedule(dynamic, 4)
+        for (int p = 0; p < pairs; ++p) {
+            const int a = changed_list[p].first, c = changed_list[p].second;
+            const double* d_a = distances[a].data();
+            const double* d_c = distances[c].data();
+            const double d_ac = d_a[c];
+            if (d_ac == INF) continue;
+            for (int x = 0; x < n; ++x) {
+                if (x == a || x == c || d_a[x] == INF || d_c[x] == INF) continue;
+                const double* d_x = distances[x].data();
+                const double ax = d_ac, a_x = d_a[x], c_x = d_c[x];
+                // Smallest entry the quadruple could raise among a, c and x
+                double floor = std::min(best[a], std::min(best[c], best[x]));
+                for (int y = x + 1; y < n; ++y) {
+                    const double s0 = ax + d_x[y], s1 = a_x + d_c[y], s2 = d_a[y] + c_x;
+                    const double top = std::max(s0, std::max(s1, s2));
+                    const double val = 0.5 * (top - (s0 + s1 + s2 - top - std::min(s0, std::min(s1, s2))));
+                    if (!(val > std::min(floor, best[y])) || !(top < INF) || y == a || y == c) continue;
+                    const int q[4] = {a, c, x, y};
+                    const int largest = top == s0 ? 0 : top == s1 ? 1 : 2;
+                    for (int r : q) {
+                        if (val > best[r]) raise(r, val, q, largest);
+                    }
+                    floor = std::min(best[a], std::min(best[c], best[x]));
+                }
+            }
+        }
+    }
+
+    // A base stays exact if its witness is untouched or a changed quadruple
+    // reaches its old value; otherwise that value is only an upper bound
+    for (int r = 0; r < n; ++r) {
+        double changed_best = -INF;
+        BaseWitness changed_witness;
+        for (int t = 0; t < threads; ++t) {
+            if (thread_best[t][r] > changed_best) {
+                changed_best = thread_best[t][r];
+                changed_witness = thread_witness[t][r];
+            }
+        }
+        if (exact[r] && !witness_affected(witnesses[r])) {
+            if (changed_best > deltas[r]) {
+                deltas[r] = changed_best;
+                witnesses[r] = changed_witness;
+            }
+        } else if (changed_best >= deltas[r]) {
+            deltas[r] = changed_best;
+            witnesses[r] = changed_witness;
+            exact[r] = 1;
+        } else if (deltas[r] <= 0.0) {
+            deltas[r] = 0.0;
+            witnesses[r] = BaseWitness{r, r, r, r};
+            exact[r] = 1;
+        } else {
+            exact[r] = 0;
+        }
+    }
+
+    // Evaluate bounded bases, largest bound first, while one could exceed the
+    // largest exact delta_r
+    double lower = 0.0;
+    std::vector<int> open;
+    for (int r = 0; r < n; ++r) {
+        if (exact[r]) lower = std::max(lower, deltas[r]);
+        else open.push_back(r);
+    }
+    std::sort(open.begin(), open.end(), [&](int x, int y) { return deltas[x] > deltas[y]; });
+    HyperbolicityCalculator hc(distances);
+    hc.set_max_min_backend(max_min_backend);
+    hc.set_matrix_memory(memory_config);
+    for (int r : open) {
+        if (deltas[r] <= lower) {
+            ++stats.bases_bounded;
+            continue;
+        }
+        deltas[r] = hc.compute_for_base(r, &witnesses[r]);
+        exact[r] = 1;
+        lower = std::max(lower, deltas[r]);
+        ++stats.bases_recomputed;
+    }
+    stats.bases_patched = n - stats.bases_recomputed;
+}
+
+// Full APSP over the current adjacency; every pair counts as changed
+void DynamicHyperbolicity::recompute_all(DynamicUpdateStats& stats) {
+    ShortestPath sp(adjacency);
+    distances = sp.compute_all_pairs();
+    changed.clear();
+    changed_list.clear();
+    every_pair_changed = true;
+    stats.full_recompute = true;
+}
+
+DynamicUpdateStats DynamicHyperbolicity::apply(const std::vector<EdgeUpdate>& batch) {
+    auto start = std::chrono::steady_clock::now();
+    DynamicUpdateStats stats;
+    changed.clear();
+    changed_list.clear();
+    every_pair_changed = false;
+
+    int n = distances.size();
+    for (const EdgeUpdate& e : batch) {
+        if (e.u < 0 || e.v < 0 || e.u >= n || e.v >= n) {
+            throw std::out_of_range("DynamicHyperbolicity::apply: vertex index out of range.");
+        }
+    }
+
+    // Patching base r evaluates ~2n^2 triples per changed pair touching r
+    // and ~3n per other pair; past the cost of a fresh compute_for_base
+    // (n^3 min/max steps) recomputing is cheaper. Beyond this many changed
+    // pairs every base is past that point, so they are no longer tracked.
+    const double full_cost = static_cast<double>(n) * n * n / PATCH_TRIPLE_COST;
+    // With every base tracked a changed pair costs n^2 / 2 quadruples in all
+    // against n fresh bases
+    const double max_tracked_pairs = track_all ? 2.0 * full_cost / std::max(1, n)
+                                               : full_cost / (3.0 * std::max(1, n));
+
+    for (const EdgeUpdate& e : batch) {
+        if (e.u == e.v || e.weight < 0 || std::isnan(e.weight)) continue;
+
+        double old_weight = current_weight(e.u, e.v);
+        if (e.weight == old_weight) continue;
+        set_weight(e.u, e.v, e.weight);
+        if (stats.full_recompute) continue;   // Distances are redone once the batch is in
+        if (e.weight < old_weight) {
+            decrease_edge(e.u, e.v, e.weight, stats);
+        } else if (stats.recomputed_sources >= n) {
+            // Rows rerun so far already add up to an APSP
+            stats.full_recompute = true;
+        } else {
+            increase_edge(e.u, e.v, old_weight, stats);
+        }
+        if (changed_list.size() > max_tracked_pairs) stats.full_recompute = true;
+    }
+    if (stats.full_recompute) recompute_all(stats);
+    stats.changed_pairs = every_pair_changed ? static_cast<size_t>(n) * (n - 1) / 2 : changed_list.size();
+
+    if (track_all && !every_pair_changed) {
+        if (!changed_list.empty()) patch_all_bases(stats);
+    } else if (every_pair_changed || !changed_list.empty()) {
+        // Cost of patching each base, from the changed pairs touching it
+        std::vector<int> touching(n, 0);
+        for (const auto& [a, c] : changed_list) {
+            ++touching[a];
+            ++touching[c];
+        }
+        const double pairs = changed_list.size();
+        std::vector<int> recompute;
+        std::vector<int> patch;
+        for (size_t b = 0; b < bases.size(); ++b) {
+            const double own = touching[bases[b]];
+            const double cost = own * 2.0 * n * n + (pairs - own) * 3.0 * n;
+            if (every_pair_changed || cost > full_cost || witness_affected(witnesses[b])) recompute.push_back(b);
+            else patch.push_back(b);
+        }
+
+        #pragma omp parallel for schedule(dynamic)
+        for (int p = 0; p < static_cast<int>(patch.size()); ++p) {
+            deltas[patch[p]] = patch_base(patch[p]);
+        }
+
+        HyperbolicityCalculator hc(distances);
+        hc.set_max_min_backend(max_min_backend);
+        hc.set_matrix_memory(memory_config);
+        for (int b : recompute) {
+            deltas[b] = hc.compute_for_base(bases[b], &witnesses[b]);
+            exact[b] = 1;
+        }
+        stats.bases_patched = patch.size();
+        stats.bases_recomputed = recompute.size();
+    }
+
+    stats.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
@@ -0,0 +1,123 @@
+#include "Eccentricity.h"
+#include "ShortestPath.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+EccentricityEngine::EccentricityEngine(const std::vector<std::vector<std::pair<int, double>>>& adj_list)
+    : adjacency_list(adj_list), n(adj_list.size()),
+      lower(n, 0.0), upper(n, INF), done(n, 0), ecc(n, 0.0) {}
+
+// Bounds are compared with a relative tolerance so weighted graphs resolve
+static bool bounds_meet(double low, double high) {
+    if (high == INF) return false;
+    return high - low <= 1e-9 * std::max(1.0, std::abs(high));
+}
+
+// One single-source search from v; tightens the bounds of its whole component
+void EccentricityEngine::search_from(int v) {
+    ShortestPath sp(adjacency_list);
+    std::vector<double> dist = sp.compute_single_source(v);
+    ++searches;
+
+    double ecc_v = 0.0;
+    for (double d : dist) {
+        if (d != INF) ecc_v = std::max(ecc_v, d);
+    }
+    ecc[v] = lower[v] = upper[v] = ecc_v;
+    done[v] = 1;
+
+    for (int w = 0; w < n; ++w) {
+        double d = dist[w];
+        if (done[w] || d == INF) continue;
+        lower[w] = std::max(lower[w], std::max(d, ecc_v - d));
+        upper[w] = std::min(upper[w], ecc_v + d);
+        if (bounds_meet(lower[w], upper[w])) {
+            ecc[w] = lower[w];
+            done[w] = 1;
+        }
+    }
+}
+
+void EccentricityEngine::run_bounding(bool all_vertices) {
+    if (all_resolved || (!all_vertices && extremes_resolved)) return;
+
+    while (true) {
+        // Current bracket on diameter and radius
+        double diam_low = 0.0, diam_up = 0.0;
+        double rad_low = INF, rad_up = INF;
+        for (int w = 0; w < n; ++w) {
+            diam_low = std::max(diam_low, lower[w]);
+            diam_up = std::max(diam_up, upper[w]);
+            rad_low = std::min(rad_low, lower[w]);
+            rad_up = std::min(rad_up, upper[w]);
+        }
+
+        // Alternate between the largest upper and the smallest lower bound;
+        // higher degree breaks ties since hubs tighten more bounds. When only
+        // the extremes are wanted, vertices that cannot affect them are skipped.
+        int v = -1;
+        for (int w = 0; w < n; ++w) {
+            if (done[w]) continue;
+            if (!all_vertices && !(upper[w] > diam_low && !bounds_meet(diam_low, upper[w])) &&
+                !(lower[w] < rad_up && !bounds_meet(lower[w], rad_up))) {
+                continue;
+            }
+            if (v == -1) { v = w; continue; }
+            double key_w = pick_upper ? upper[w] : -lower[w];
+            double key_v = pick_upper ? upper[v] : -lower[v];
+            if (key_w > key_v ||
+                (key_w == key_v && adjacency_list[w].size() > adjacency_list[v].size())) {
+                v = w;
+            }
+        }
+
+        if (v == -1) {
+            extremes_resolved = true;
+            if (all_vertices || std::all_of(done.begin(), done.end(), [](char d) { return d != 0; })) {
+                all_resolved = true;
+            }
+            return;
+        }
+        pick_upper = !pick_upper;
+        search_from(v);
+    }
+}
+
+const std::vector<double>& EccentricityEngine::compute_eccentricities() {
+    run_bounding(true);
+    return ecc;
+}
+
+double EccentricityEngine::diameter() {
+    run_bounding(false);
+    double diam = 0.0;
+    for (int w = 0; w < n; ++w) diam = std::max(diam, lower[w]);
+    return diam;
+}
+
+double EccentricityEngine::radius() {
+    run_bounding(false);
+    if (n == 0) return 0.0;
+    double rad = INF;
+    for (int w = 0; w < n; ++w) rad = std::min(rad, upper[w]);
+    return rad;
+}
+
+// Once the diameter is exact, any vertex whose lower bound reaches it is peripheral
+int EccentricityEngine::peripheral_vertex() {
+    run_bounding(false);
+    if (n == 0) return -1;
+    return std::distance(lower.begin(), std::max_element(lower.begin(), lower.end()));
+}
+
+std::vector<int> EccentricityEngine::vertices_by_eccentricity() {
+    run_bounding(true);
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return ecc[a] > ecc[b]; });
+    return order;
+}
@@ -0,0 +1,291 @@
+#include "ForceLayout.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <omp.h>
+
+// Coincident points stop splitting here and share one leaf
+constexpr int MAX_QUAD_DEPTH = 40;
+// Relative strength of repulsion against the springs (Hu, "Efficient and
+// high quality force-directed graph drawing", 2005)
+constexpr double REPULSION = 0.2;
+// Adaptive step: grow after this many improving iterations, shrink otherwise
+constexpr int STEP_PATIENCE = 5;
+constexpr double STEP_FACTOR = 0.9;
+// Coarsening stops at this size, or when a matching removes too few vertices
+constexpr int COARSEST_SIZE = 100;
+constexpr double MIN_COARSENING = 0.8;
+// Finer levels start close to their final shape: shorter steps, fewer iterations
+constexpr double REFINE_STEP = 0.5;
+constexpr int REFINE_DIVISOR = 4;
+
+ForceLayout::ForceLayout(const std::vector<std::vector<std::pair<int, double>>>& adj_list)
+    : neighbors(adj_list.size()) {
+    const int n = adj_list.size();
+    for (int u = 0; u < n; ++u) {
+        for (const auto& [v, weight] : adj_list[u]) {
+            if (v == u || v < 0 || v >= n) continue;
+            neighbors[u].push_back(v);
+            neighbors[v].push_back(u);
+        }
+    }
+    for (auto& list : neighbors) {
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+    }
+}
+
+// --- Barnes-Hut quadtree ---
+void ForceLayout::build_quadtree(const std::vector<LayoutPoint>& pos, std::vector<QuadNode>& tree) {
+    tree.clear();
+    const int n = pos.size();
+    if (n == 0) return;
+
+    double min_x = pos[0].x, max_x = pos[0].x, min_y = pos[0].y, max_y = pos[0].y;
+    for (const LayoutPoint& p : pos) {
+        min_x = std::min(min_x, p.x);
+        max_x = std::max(max_x, p.x);
+        min_y = std::min(min_y, p.y);
+        max_y = std::max(max_y, p.y);
+    }
+    QuadNode root;
+    root.cx = 0.5 * (min_x + max_x);
+    root.cy = 0.5 * (min_y + max_y);
+    root.half = 0.5 * std::max(max_x - min_x, max_y - min_y) + 1.0;
+    tree.reserve(2 * static_cast<size_t>(n));
+    tree.push_back(root);
+
+    auto quadrant = [&](int node, const LayoutPoint& p) {
+        return (p.x >= tree[node].cx ? 1 : 0) + (p.y >= tree[node].cy ? 2 : 0);
+    };
+    auto make_child = [&](int node, int c) {
+        QuadNode child;
+        child.half = 0.5 * tree[node].half;
+        child.cx = tree[node].cx + ((c & 1) ? child.half : -child.half);
+        child.cy = tree[node].cy + ((c & 2) ? child.half : -child.half);
+        tree.push_back(child);
+        tree[node].child[c] = tree.size() - 1;
+        return static_cast<int>(tree.size() - 1);
+    };
+
+    for (int p = 0; p < n; ++p) {
+        int node = 0;
+        int depth = 0;
+        while (true) {
+            tree[node].mass += 1.0;
+            tree[node].mx += pos[p].x;
+            tree[node].my += pos[p].y;
+
+            const int* ch = tree[node].child;
+            bool leaf = ch[0] < 0 && ch[1] < 0 && ch[2] < 0 && ch[3] < 0;
+            if (leaf) {
+                if (tree[node].mass == 1.0) {
+                    tree[node].point = p;
+                    break;
+                }
+                if (depth >= MAX_QUAD_DEPTH) {
+                    tree[node].point = -1;  // Aggregated leaf
+                    break;
+                }
+                // Split: the stored vertex moves one level down
+                int q = tree[node].point;
+                tree[node].point = -1;
+                int child = make_child(node, quadrant(node, pos[q]));
+                tree[child].mass = 1.0;
+                tree[child].mx = pos[q].x;
+                tree[child].my = pos[q].y;
+                tree[child].point = q;
+            }
+            int c = quadrant(node, pos[p]);
+            int next = tree[node].child[c] >= 0 ? tree[node].child[c] : make_child(node, c);
+            node = next;
+            ++depth;
+        }
+    }
+
+    for (QuadNode& q : tree) {
+        q.mx /= q.mass;
+        q.my /= q.mass;
+    }
+}
+
+LayoutPoint ForceLayout::repulsion(int v, const std::vector<LayoutPoint>& pos,
+                                   const std::vector<QuadNode>& tree, double theta, double strength) {
+    LayoutPoint f;
+    if (tree.empty()) return f;
+
+    int stack[4 * MAX_QUAD_DEPTH + 8];
+    int top = 0;
+    stack[top++] = 0;
+    const double theta_sq = theta * theta;
+
+    while (top > 0) {
+        const QuadNode& q = tree[stack[--top]];
+        double dx = pos[v].x - q.mx;
+        double dy = pos[v].y - q.my;
+        double d_sq = dx * dx + dy * dy;
+
+        bool leaf = q.child[0] < 0 && q.child[1] < 0 && q.child[2] < 0 && q.child[3] < 0;
+        double width = 2.0 * q.half;
+        if (leaf || width * width < theta_sq * d_sq) {
+            // Leaf, or a cell far enough away to act as one body
+            if (q.point == v || d_sq < 1e-12) continue;
+            double scale = strength * q.mass / d_sq;
+            f.x += dx * scale;
+            f.y += dy * scale;
+        } else {
+            for (int c = 0; c < 4; ++c) {
+                if (q.child[c] >= 0) stack[top++] = q.child[c];
+            }
+        }
+    }
+    return f;
+}
+
+// --- Multilevel coarsening ---
+// Heavy-edge-free matching: vertices in random order pair with their unmatched
+// neighbour of smallest degree. Returns the coarse graph and the fine -> coarse map.
+static std::vector<std::vector<int>> coarsen(const std::vector<std::vector<int>>& graph,
+                                             std::vector<int>& parent, std::mt19937& rng) {
+    const int n = graph.size();
+    std::vector<int> order(n);
+    for (int v = 0; v < n; ++v) order[v] = v;
+    std::shuffle(order.begin(), order.end(), rng);
+
+    parent.assign(n, -1);
+    int coarse_n = 0;
+    for (int v : order) {
+        if (parent[v] >= 0) continue;
+        int mate = -1;
+        for (int u : graph[v]) {
+            if (parent[u] < 0 && (mate < 0 || graph[u].size() < graph[mate].size())) mate = u;
+        }
+        parent[v] = coarse_n;
+        if (mate >= 0) parent[mate] = coarse_n;
+        ++coarse_n;
+    }
+
+    std::vector<std::vector<int>> coarse(coarse_n);
+    for (int v = 0; v < n; ++v) {
+        for (int u : graph[v]) {
+            if (parent[u] != parent[v]) coarse[parent[v]].push_back(parent[u]);
+        }
+    }
+    for (auto& list : coarse) {
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+    }
+    return coarse;
+}
+
+// --- Layout iterations ---
+int ForceLayout::refine(const std::vector<std::vector<int>>& graph, std::vector<LayoutPoint>& pos,
+                        double step, int iterations, int done, const ForceLayoutOptions& options,
+                        const std::function<bool(int)>& progress) {
+    const int n = graph.size();
+    const double K = options.ideal_length;
+    const double strength = REPULSION * K * K;
+    double energy = std::numeric_limits<double>::infinity();
+    int improving = 0;
+    std::vector<QuadNode> tree;
+    std::vector<LayoutPoint> force(n);
+
+    for (int it = 0; it < iterations; ++it) {
+        build_quadtree(pos, tree);
+        LayoutPoint centre{tree[0].mx, tree[0].my};
+
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (int v = 0; v < n; ++v) {
+            LayoutPoint f = repulsion(v, pos, tree, options.theta, strength);
+            // Springs: magnitude d^2 / K along the edge
+            for (int u : graph[v]) {
+                double dx = pos[u].x - pos[v].x;
+                double dy = pos[u].y - pos[v].y;
+                double d = std::sqrt(dx * dx + dy * dy);
+                f.x += dx * d / K;
+                f.y += dy * d / K;
+            }
+            f.x -= options.gravity * (pos[v].x - centre.x);
+            f.y -= options.gravity * (pos[v].y - centre.y);
+            force[v] = f;
+        }
+
+        // Every vertex moves by step along its force direction
+        double new_energy = 0.0;
+        #pragma omp parallel for schedule(static) reduction(+:new_energy)
+        for (int v = 0; v < n; ++v) {
+            double len = std::sqrt(force[v].x * force[v].x + force[v].y * force[v].y);
+            if (len > 0.0) {
+                pos[v].x += step * force[v].x / len;
+                pos[v].y += step * force[v].y / len;
+            }
+            new_energy += len * len;
+        }
+
+        if (new_energy < energy) {
+            if (++improving >= STEP_PATIENCE) {
+                improving = 0;
+                step /= STEP_FACTOR;
+            }
+        } else {
+            improving = 0;
+            step *= STEP_FACTOR;
+        }
+        energy = new_energy;
+
+        ++done;
+        if (progress && !progress(done)) return -1;
+        if (step < options.tolerance * K) break;
+    }
+    return done;
+}
+
+std::vector<LayoutPoint> ForceLayout::compute(const ForceLayoutOptions& options,
+                                              const std::function<bool(int)>& progress) const {
+    const int n = neighbors.size();
+    const double K = options.ideal_length;
+    std::mt19937 rng(options.seed);
+
+    // Hierarchy of matchings down to a graph small enough to untangle directly
+    std::vector<std::vector<std::vector<int>>> levels;
+    std::vector<std::vector<int>> parents;
+    const std::vector<std::vector<int>>* current = &neighbors;
+    while (static_cast<int>(current->size()) > COARSEST_SIZE) {
+        std::vector<int> parent;
+        std::vector<std::vector<int>> coarse = coarsen(*current, parent, rng);
+        if (coarse.size() > MIN_COARSENING * current->size()) break;
+        parents.push_back(std::move(parent));
+        levels.push_back(std::move(coarse));
+        current = &levels.back();
+    }
+
+    std::uniform_real_distribution<double> coord(0.0, K * std::sqrt(static_cast<double>(current->size())));
+    std::vector<LayoutPoint> pos(current->size());
+    for (LayoutPoint& p : pos) {
+        p.x = coord(rng);
+        p.y = coord(rng);
+    }
+    if (n <= 1) return pos;
+
+    int done = refine(*current, pos, K, options.iterations, 0, options, progress);
+
+    // Prolong: each fine vertex starts at its coarse vertex, spread so the
+    // area grows with the vertex count, then a shorter refinement
+    std::uniform_real_distribution<double> jitter(-0.1 * K, 0.1 * K);
+    for (int l = static_cast<int>(levels.size()) - 1; l >= 0 && done >= 0; --l) {
+        const std::vector<std::vector<int>>& fine = l > 0 ? levels[l - 1] : neighbors;
+        const std::vector<int>& parent = parents[l];
+        double scale = std::sqrt(static_cast<double>(fine.size()) / pos.size());
+
+        std::vector<LayoutPoint> fine_pos(fine.size());
+        for (size_t v = 0; v < fine.size(); ++v) {
+            fine_pos[v].x = pos[parent[v]].x * scale + jitter(rng);
+            fine_pos[v].y = pos[parent[v]].y * scale + jitter(rng);
+        }
+        pos = std::move(fine_pos);
+        done = refine(fine, pos, REFINE_STEP * K, std::max(1, options.iterations / REFINE_DIVISOR), done,
+                      options, progress);
+    }
+    return pos;
+}
@@ -1,21 +1,33 @@
 #include "GraphParser.h"
+#include "MappedFile.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
 
-void GraphParser::add_node(const std::string& node) {
-    if (node_indices.find(node) == node_indices.end()) {
-        node_indices[node] = nodes.size();
-        nodes.push_back(node);
-        adjacency_list.resize(nodes.size());
+int GraphParser::intern(std::string_view node) {
+    auto [it, inserted] = node_indices.try_emplace(std::string(node), static_cast<int>(nodes.size()));
+    if (inserted) {
+        nodes.push_back(it->first);
+        adjacency_list.emplace_back();
     }
+    return it->second;
+}
+
+void GraphParser::add_node(const std::string& node) {
+    intern(node);
 }
 
 void GraphParser::add_edge(const std::string& src, const std::string& dest, double weight) {
-    add_node(src);
-    add_node(dest);
-    int u = node_indices[src];
-    int v = node_indices[dest];
+    int u = intern(src);
+    int v = intern(dest);
+    add_edge(u, v, weight);
+}
+
+void GraphParser::add_edge(int u, int v, double weight) {
     adjacency_list[u].emplace_back(v, weight);
     adjacency_list[v].emplace_back(u, weight); 
 }
@@ -38,6 +50,235 @@ void GraphParser::parse(const std::string& filename) {
     }
 }
 
+// --- JSON ---
+// Pull tokeniser over the mapped file. Only what the graph needs is decoded:
+// names are views into the buffer unless they contain escapes, and values of
+// unknown keys are skipped without being built.
+namespace {
+
+class JsonCursor {
+public:
+    JsonCursor(const char* begin, const char* end) : start(begin), p(begin), stop(end) {}
+
+    void ws() {
+        while (p < stop && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    }
+    bool consume(char c) {
+        ws();
+        if (p < stop && *p == c) {
+            ++p;
+            return true;
+        }
+        return false;
+    }
+    void expect(char c) {
+        if (!consume(c)) fail(std::string("expected '") + c + "'");
+    }
+    char peek() {
+        ws();
+        return p < stop ? *p : '\0';
+    }
+    bool at_end() {
+        ws();
+        return p >= stop;
+    }
+    // Members and elements: true while another one follows
+    bool next_item(char close, bool& first) {
+        if (consume(close)) return false;
+        if (!first) expect(',');
+        first = false;
+        return true;
+    }
+
+    // String contents; scratch holds the decoded text when there are escapes
+    std::string_view string(std::string& scratch) {
+        expect('"');
+        const char* begin = p;
+        while (p < stop && *p != '"' && *p != '\\') ++p;
+        if (p < stop && *p == '"') return std::string_view(begin, p++ - begin);
+
+        scratch.assign(begin, p);
+        while (p < stop && *p != '"') {
+            if (*p != '\\') {
+                scratch.push_back(*p++);
+                continue;
+            }
+            if (++p >= stop) break;
+            char e = *p++;
+            switch (e) {
+                case '"': case '\\': case '/': scratch.push_back(e); break;
+                case 'b': scratch.push_back('\b'); break;
+                case 'f': scratch.push_back('\f'); break;
+                case 'n': scratch.push_back('\n'); break;
+                case 'r': scratch.push_back('\r'); break;
+                case 't': scratch.push_back('\t'); break;
+                case 'u': append_utf8(scratch, code_point()); break;
+                default: fail("bad escape");
+            }
+        }
+        if (p >= stop) fail("unterminated string");
+        ++p;
+        return scratch;
+    }
+
+    // A name: string contents, or the literal text of a number
+    std::string_view name(std::string& scratch) {
+        if (peek() == '"') return string(scratch);
+        const char* begin = p;
+        while (p < stop && (std::isdigit(static_cast<unsigned char>(*p)) || std::strchr("+-.eE", *p))) ++p;
+        if (p == begin) fail("expected a name");
+        return std::string_view(begin, p - begin);
+    }
+
+    double number() {
+        ws();
+        char buf[64];
+        size_t len = 0;
+        while (p + len < stop && len < sizeof(buf) - 1 &&
+               (std::isdigit(static_cast<unsigned char>(p[len])) || std::strchr("+-.eE", p[len]))) {
+            buf[len] = p[len];
+            ++len;
+        }
+        buf[len] = '\0';
+        char* end = nullptr;
+        double value = std::strtod(buf, &end);
+        if (len == 0 || end != buf + len) fail("expected a number");
+        p += len;
+        return value;
+    }
+
+    // Any value, nesting tracked by depth only
+    void skip_value() {
+        int depth = 0;
+        std::string scratch;
+        do {
+            char c = peek();
+            if (c == '{' || c == '[') {
+                ++p;
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (depth == 0) fail("unexpected close");
+                ++p;
+                --depth;
+            } else if (c == ',' || c == ':') {
+                if (depth == 0) fail("unexpected separator");
+                ++p;
+            } else if (c == '"') {
+                string(scratch);
+            } else if (c == 't' || c == 'f' || c == 'n') {
+                while (p < stop && std::isalpha(static_cast<unsigned char>(*p))) ++p;
+            } else {
+                number();
+            }
+        } while (depth > 0);
+    }
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("Invalid JSON graph at byte " + std::to_string(p - start) + ": " + what);
+    }
+
+private:
+    const char* start;
+    const char* p;
+    const char* stop;
+
+    unsigned hex4() {
+        if (stop - p < 4) fail("bad \\u escape");
+        unsigned value = 0;
+        for (int k = 0; k < 4; ++k) {
+            char c = *p++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else fail("bad \\u escape");
+        }
+        return value;
+    }
+    unsigned code_point() {
+        unsigned cp = hex4();
+        if (cp >= 0xD800 && cp < 0xDC00 && stop - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+            p += 2;
+            unsigned low = hex4();
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+        return cp;
+    }
+    static void append_utf8(std::string& out, unsigned cp) {
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+};
+
+} // namespace
+
+void GraphParser::parse_json(const std::string& filename) {
+    MappedFile file(filename);
+    JsonCursor in(file.begin(), file.end());
+    std::string key_scratch, src_scratch, dest_scratch;
+
+    in.expect('{');
+    bool first_key = true;
+    while (in.next_item('}', first_key)) {
+        std::string_view key = in.string(key_scratch);
+        in.expect(':');
+
+        if (key == "edges" || key == "links") {
+            in.expect('[');
+            bool first_edge = true;
+            while (in.next_item(']', first_edge)) {
+                in.expect('{');
+                int u = -1, v = -1;
+                double weight = 1.0;
+                bool first_field = true;
+                while (in.next_item('}', first_field)) {
+                    std::string_view field = in.string(key_scratch);
+                    in.expect(':');
+                    if (field == "source") u = intern(in.name(src_scratch));
+                    else if (field == "target") v = intern(in.name(dest_scratch));
+                    else if (field == "weight") weight = in.number();
+                    else in.skip_value();
+                }
+                if (u < 0 || v < 0) in.fail("edge without source or target");
+                add_edge(u, v, weight);
+            }
+        } else if (key == "nodes") {
+            in.expect('[');
+            bool first_node = true;
+            while (in.next_item(']', first_node)) {
+                if (in.peek() != '{') {
+                    intern(in.name(src_scratch));
+                    continue;
+                }
+                in.expect('{');
+                bool first_field = true;
+                while (in.next_item('}', first_field)) {
+                    std::string_view field = in.string(key_scratch);
+                    in.expect(':');
+                    if (field == "id") intern(in.name(src_scratch));
+                    else in.skip_value();
+                }
+            }
+        } else {
+            in.skip_value();
+        }
+    }
+    if (!in.at_end()) in.fail("trailing data");
+}
+
 const std::vector<std::vector<std::pair<int, double>>>& GraphParser::get_adjacency_list() const {
     return adjacency_list;
 }
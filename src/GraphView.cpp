@@ -0,0 +1,470 @@
+#include "GraphView.h"
+#include "backend.h"
+#include <QGraphicsScene>
+#include <QGraphicsItem>
+#include <QStyleOptionGraphicsItem>
+#include <QPainter>
+#include <QWheelEvent>
+#include <QHash>
+#include <QLineF>
+#include <QFontMetricsF>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <tuple>
+
+// Scene units per layout unit edge length are 1:1 (ForceLayoutOptions::ideal_length)
+constexpr double NODE_RADIUS = 6.0;
+constexpr double TILE_SIZE = 240.0;        // ~8 edge lengths per tile side
+constexpr int BUNDLE_GRID = 48;            // Cells per side for bundled edges
+
+// Level of detail = screen pixels per scene unit
+constexpr double BUNDLE_LOD = 0.15;        // Below: bundled edges, nodes as points
+constexpr double NODE_LOD = 0.5;           // Above: nodes as discs
+constexpr double LABEL_LOD = 1.5;          // Above: node names and edge weights
+
+constexpr double LABEL_PIXELS = 10.0;      // On-screen text height
+constexpr double MARKER_PIXELS = 7.0;      // Witness marker radius, at every zoom level
+constexpr double ZOOM_STEP = 1.25;
+constexpr int PROGRESS_INTERVAL = 10;      // Iterations between progress signals
+
+constexpr int HEAT_LEVELS = 16;            // Colour steps for vertex values
+constexpr unsigned char NO_HEAT = 255;     // Vertex without a value
+
+// --- Scene items ---
+namespace {
+
+// Blue for the smallest value through red for the largest
+QColor heatColor(int level) {
+    const double t = static_cast<double>(level) / (HEAT_LEVELS - 1);
+    return QColor(static_cast<int>(40 + 215 * t), static_cast<int>(90 - 50 * t), static_cast<int>(230 - 190 * t));
+}
+
+// Nodes whose position falls into one tile, plus the edges starting at them.
+// The bounding rect covers both ends of every edge so culling stays exact.
+class TileItem : public QGraphicsItem
+{
+public:
+    TileItem(std::shared_ptr<const GraphDrawing> drawing, std::shared_ptr<const std::vector<unsigned char>> heat,
+             std::vector<int> nodes, std::vector<int> edges)
+        : drawing(std::move(drawing)), heat(std::move(heat)), nodes(std::move(nodes)), edges(std::move(edges)) {
+        const auto& pos = this->drawing->positions;
+        bool first = true;
+        auto extend = [&](int v) {
+            QRectF r(pos[v].x - NODE_RADIUS, pos[v].y - NODE_RADIUS, 2 * NODE_RADIUS, 2 * NODE_RADIUS);
+            bounds = first ? r : bounds.united(r);
+            first = false;
+        };
+        for (int v : this->nodes) extend(v);
+        for (int e : this->edges) {
+            extend(this->drawing->edges[e].first);
+            extend(this->drawing->edges[e].second);
+        }
+        // Labels hang off the right of a node
+        bounds.adjust(0, 0, 80, 0);
+    }
+
+    QRectF boundingRect() const override { return bounds; }
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *) override {
+        const double lod = option->levelOfDetailFromTransform(painter->worldTransform());
+        const QRectF exposed = option->exposedRect;
+        const auto& pos = drawing->positions;
+        auto point = [&](int v) { return QPointF(pos[v].x, pos[v].y); };
+
+        if (lod >= BUNDLE_LOD) {
+            QVector<QLineF> lines;
+            lines.reserve(edges.size());
+            for (int e : edges) {
+                QLineF line(point(drawing->edges[e].first), point(drawing->edges[e].second));
+                QRectF box = QRectF(line.p1(), line.p2()).normalized().adjusted(-1, -1, 1, 1);
+                if (box.intersects(exposed)) lines.append(line);
+            }
+            QPen edgePen(QColor(150, 150, 150));
+            edgePen.setCosmetic(true);
+            painter->setPen(edgePen);
+            painter->drawLines(lines);
+        }
+
+        // Grouped by colour step so each colour is set once; the last group
+        // holds the vertices without a value
+        std::vector<QVector<QPointF>> visible(HEAT_LEVELS + 1);
+        for (int v : nodes) {
+            QPointF p = point(v);
+            if (exposed.adjusted(-NODE_RADIUS, -NODE_RADIUS, NODE_RADIUS, NODE_RADIUS).contains(p)) {
+                unsigned char level = heat->empty() ? NO_HEAT : (*heat)[v];
+                visible[level == NO_HEAT ? HEAT_LEVELS : level].append(p);
+            }
+        }
+        for (int level = 0; level <= HEAT_LEVELS; ++level) {
+            const QVector<QPointF>& group = visible[level];
+            if (group.isEmpty()) continue;
+            if (lod < NODE_LOD) {
+                QPen pointPen(level == HEAT_LEVELS ? QColor(40, 40, 40) : heatColor(level));
+                pointPen.setCosmetic(true);
+                pointPen.setWidthF(level == HEAT_LEVELS ? 2.0 : 3.0);
+                painter->setPen(pointPen);
+                painter->drawPoints(group.constData(), group.size());
+            } else {
+                painter->setPen(QPen(Qt::black, 0));
+                painter->setBrush(level == HEAT_LEVELS ? QColor(Qt::lightGray) : heatColor(level));
+                for (const QPointF& p : group) {
+                    painter->drawEllipse(p, NODE_RADIUS, NODE_RADIUS);
+                }
+            }
+        }
+
+        if (lod >= LABEL_LOD) {
+            QFont font = painter->font();
+            font.setPointSizeF(LABEL_PIXELS / lod);
+            painter->setFont(font);
+            painter->setPen(Qt::black);
+            for (int v : nodes) {
+                QPointF p = point(v);
+                if (exposed.contains(p)) {
+                    painter->drawText(p + QPointF(NODE_RADIUS + 1, NODE_RADIUS / 2), drawing->names[v]);
+                }
+            }
+            painter->setPen(Qt::darkBlue);
+            for (int e : edges) {
+                QPointF mid = (point(drawing->edges[e].first) + point(drawing->edges[e].second)) / 2;
+                if (exposed.contains(mid)) {
+                    painter->drawText(mid, QString::number(drawing->weights[e], 'f', 2));
+                }
+            }
+        }
+    }
+
+private:
+    std::shared_ptr<const GraphDrawing> drawing;
+    std::shared_ptr<const std::vector<unsigned char>> heat;
+    std::vector<int> nodes;
+    std::vector<int> edges;
+    QRectF bounds;
+};
+
+// Zoomed-out stand-in for the edges: nodes are grouped into grid cells and
+// all edges between two cells become one line between the cells' centroids,
+// wider the more edges it carries.
+class BundleItem : public QGraphicsItem
+{
+public:
+    explicit BundleItem(const GraphDrawing& drawing) {
+        const auto& pos = drawing.positions;
+        if (pos.empty()) return;
+
+        double min_x = pos[0].x, max_x = pos[0].x, min_y = pos[0].y, max_y = pos[0].y;
+        for (const LayoutPoint& p : pos) {
+            min_x = std::min(min_x, p.x);
+            max_x = std::max(max_x, p.x);
+            min_y = std::min(min_y, p.y);
+            max_y = std::max(max_y, p.y);
+        }
+        bounds = QRectF(min_x, min_y, max_x - min_x, max_y - min_y).adjusted(-1, -1, 1, 1);
+        const double cell = std::max(bounds.width(), bounds.height()) / BUNDLE_GRID;
+
+        auto cell_of = [&](int v) {
+            int cx = std::min(BUNDLE_GRID - 1, static_cast<int>((pos[v].x - bounds.left()) / cell));
+            int cy = std::min(BUNDLE_GRID - 1, static_cast<int>((pos[v].y - bounds.top()) / cell));
+            return cy * BUNDLE_GRID + cx;
+        };
+
+        std::vector<QPointF> centroid(BUNDLE_GRID * BUNDLE_GRID, QPointF(0, 0));
+        std::vector<int> members(BUNDLE_GRID * BUNDLE_GRID, 0);
+        std::vector<int> cells(pos.size());
+        for (size_t v = 0; v < pos.size(); ++v) {
+            cells[v] = cell_of(v);
+            centroid[cells[v]] += QPointF(pos[v].x, pos[v].y);
+            ++members[cells[v]];
+        }
+        for (size_t c = 0; c < centroid.size(); ++c) {
+            if (members[c] > 0) centroid[c] /= members[c];
+        }
+
+        std::map<std::pair<int, int>, int> counts;
+        for (const auto& [u, v] : drawing.edges) {
+            int a = cells[u], b = cells[v];
+            if (a == b) continue;
+            ++counts[{std::min(a, b), std::max(a, b)}];
+        }
+        for (const auto& [cell_pair, count] : counts) {
+            bundles.push_back({QLineF(centroid[cell_pair.first], centroid[cell_pair.second]), count});
+        }
+        // Thin lines first so heavy bundles stay on top
+        std::sort(bundles.begin(), bundles.end(),
+                  [](const Bundle& a, const Bundle& b) { return a.count < b.count; });
+    }
+
+    QRectF boundingRect() const override { return bounds; }
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *) override {
+        const double lod = option->levelOfDetailFromTransform(painter->worldTransform());
+        if (lod >= BUNDLE_LOD) return;
+
+        QPen pen(QColor(110, 130, 170, 160));
+        pen.setCosmetic(true);
+        for (const Bundle& b : bundles) {
+            pen.setWidthF(1.0 + std::log2(static_cast<double>(b.count)));
+            painter->setPen(pen);
+            painter->drawLine(b.line);
+        }
+    }
+
+private:
+    struct Bundle {
+        QLineF line;
+        int count;
+    };
+    std::vector<Bundle> bundles;
+    QRectF bounds;
+};
+
+// One witness vertex: a disc and its role and name, drawn in screen pixels
+// so it stays findable however far the view is zoomed out
+class MarkerItem : public QGraphicsItem
+{
+public:
+    explicit MarkerItem(const QString& text) : text(text) {
+        setFlag(QGraphicsItem::ItemIgnoresTransformations);
+        textWidth = QFontMetricsF(QFont()).boundingRect(text).width();
+    }
+
+    QRectF boundingRect() const override {
+        return QRectF(-MARKER_PIXELS - 1, -MARKER_PIXELS - 1,
+                      2 * MARKER_PIXELS + 4 + textWidth, 2 * MARKER_PIXELS + 2);
+    }
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *) override {
+        painter->setPen(QPen(QColor(170, 0, 0), 2));
+        painter->setBrush(QColor(255, 90, 90));
+        painter->drawEllipse(QPointF(0, 0), MARKER_PIXELS, MARKER_PIXELS);
+        painter->setPen(QColor(120, 0, 0));
+        painter->drawText(QPointF(MARKER_PIXELS + 3, MARKER_PIXELS / 2), text);
+    }
+
+private:
+    QString text;
+    double textWidth = 0.0;
+};
+
+} // namespace
+
+// --- View ---
+GraphView::GraphView(QWidget *parent)
+    : QGraphicsView(parent), graphScene(new QGraphicsScene(this)),
+      watcher(new QFutureWatcher<std::shared_ptr<GraphDrawing>>(this)),
+      heat(std::make_shared<std::vector<unsigned char>>())
+{
+    setScene(graphScene);
+    setRenderHint(QPainter::Antialiasing, true);
+    setDragMode(QGraphicsView::ScrollHandDrag);
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
+    setOptimizationFlag(QGraphicsView::DontAdjustForAntialiasing, true);
+    connect(watcher, &QFutureWatcher<std::shared_ptr<GraphDrawing>>::finished,
+            this, &GraphView::onLayoutFinished);
+}
+
+GraphView::~GraphView() {
+    // Cancelled layouts may still be winding down and would emit on this view
+    cancelLayout();
+    QThreadPool::globalInstance()->waitForDone();
+}
+
+void GraphView::cancelLayout() {
+    if (cancelFlag) cancelFlag->store(true);
+    cancelFlag.reset();
+}
+
+void GraphView::clearGraph() {
+    cancelLayout();
+    graphScene->clear();
+    highlightItems.clear();
+    highlighted.clear();
+    valueNames.clear();
+    vertexValues.clear();
+    heat->clear();
+    drawing.reset();
+}
+
+void GraphView::setHighlight(const QStringList& names) {
+    highlighted = names;
+    if (drawing) buildHighlight();
+}
+
+void GraphView::setVertexValues(const QVector<QString>& names, const std::vector<double>& values) {
+    valueNames = names;
+    vertexValues = values;
+    if (drawing) {
+        applyVertexValues();
+        graphScene->update();
+    }
+}
+
+void GraphView::applyVertexValues() {
+    heat->clear();
+    const int count = std::min<int>(valueNames.size(), vertexValues.size());
+    if (count == 0) return;
+
+    double low = std::numeric_limits<double>::infinity();
+    double high = -low;
+    for (int v = 0; v < count; ++v) {
+        if (!std::isfinite(vertexValues[v])) continue;
+        low = std::min(low, vertexValues[v]);
+        high = std::max(high, vertexValues[v]);
+    }
+
+    QHash<QString, int> index;
+    for (int i = 0; i < drawing->names.size(); ++i) index.insert(drawing->names[i], i);
+    heat->assign(drawing->names.size(), NO_HEAT);
+    for (int v = 0; v < count; ++v) {
+        auto found = index.constFind(valueNames[v]);
+        if (found == index.constEnd() || !std::isfinite(vertexValues[v])) continue;
+        const double t = high > low ? (vertexValues[v] - low) / (high - low) : 0.0;
+        (*heat)[found.value()] = static_cast<unsigned char>(std::lround(t * (HEAT_LEVELS - 1)));
+    }
+}
+
+void GraphView::buildHighlight() {
+    for (QGraphicsItem *item : highlightItems) {
+        graphScene->removeItem(item);
+        delete item;
+    }
+    highlightItems.clear();
+
+    // Roles follow HyperResult::witness: base r and triple i, j, k, or a pair
+    const QStringList roles = highlighted.size() == 4 ? QStringList{"r", "i", "j", "k"} : QStringList{"u", "v"};
+    QVector<QPointF> points;
+    QStringList labels;
+    for (int w = 0; w < highlighted.size(); ++w) {
+        int v = drawing->names.indexOf(highlighted[w]);
+        if (v < 0) continue;
+        points.append(QPointF(drawing->positions[v].x, drawing->positions[v].y));
+        labels.append(w < roles.size() ? QString("%1: %2").arg(roles[w], highlighted[w]) : highlighted[w]);
+    }
+
+    // Every pair joined: the four-point condition compares the three pairings
+    QPen linkPen(QColor(200, 0, 0), 2, Qt::DashLine);
+    linkPen.setCosmetic(true);
+    for (int a = 0; a < points.size(); ++a) {
+        for (int b = a + 1; b < points.size(); ++b) {
+            QGraphicsLineItem *link = graphScene->addLine(QLineF(points[a], points[b]), linkPen);
+            link->setZValue(1);
+            highlightItems.append(link);
+        }
+    }
+    for (int a = 0; a < points.size(); ++a) {
+        MarkerItem *marker = new MarkerItem(labels[a]);
+        marker->setPos(points[a]);
+        marker->setZValue(2);
+        graphScene->addItem(marker);
+        highlightItems.append(marker);
+    }
+}
+
+void GraphView::setGraph(const Graph* graph) {
+    clearGraph();
+    if (!graph) return;
+
+    // Snapshot on the UI thread: names, and each undirected edge once
+    auto snapshot = std::make_shared<GraphDrawing>();
+    snapshot->names = graph->nodes.toVector();
+    QHash<QString, int> index;
+    for (int i = 0; i < snapshot->names.size(); ++i) index.insert(snapshot->names[i], i);
+
+    std::vector<std::tuple<int, int, double>> unique_edges;
+    unique_edges.reserve(graph->edges.size());
+    for (const Edge& edge : graph->edges) {
+        auto u = index.constFind(edge.source);
+        auto v = index.constFind(edge.target);
+        if (u == index.constEnd() || v == index.constEnd() || u.value() == v.value()) continue;
+        unique_edges.emplace_back(std::min(u.value(), v.value()), std::max(u.value(), v.value()), edge.weight);
+    }
+    std::sort(unique_edges.begin(), unique_edges.end());
+    unique_edges.erase(std::unique(unique_edges.begin(), unique_edges.end(),
+                                   [](const auto& a, const auto& b) {
+                                       return std::get<0>(a) == std::get<0>(b) && std::get<1>(a) == std::get<1>(b);
+                                   }),
+                       unique_edges.end());
+    for (const auto& [u, v, w] : unique_edges) {
+        snapshot->edges.emplace_back(u, v);
+        snapshot->weights.push_back(w);
+    }
+
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    cancelFlag = cancel;
+
+    watcher->setFuture(QtConcurrent::run([this, snapshot, cancel]() {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::vector<std::pair<int, double>>> adj_list(snapshot->names.size());
+        for (size_t e = 0; e < snapshot->edges.size(); ++e) {
+            adj_list[snapshot->edges[e].first].emplace_back(snapshot->edges[e].second, snapshot->weights[e]);
+        }
+
+        ForceLayout layout(adj_list);
+        snapshot->positions = layout.compute(ForceLayoutOptions(), [this, cancel](int iteration) {
+            if (cancel->load()) return false;
+            if (iteration % PROGRESS_INTERVAL == 0) emit layoutProgress(iteration);
+            return true;
+        });
+        snapshot->layout_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return cancel->load() ? std::shared_ptr<GraphDrawing>() : snapshot;
+    }));
+}
+
+void GraphView::onLayoutFinished() {
+    std::shared_ptr<GraphDrawing> result = watcher->result();
+    if (!result) return;  // Cancelled
+    drawing = result;
+    applyVertexValues();
+    buildScene();
+    emit layoutFinished(drawing->names.size(), drawing->edges.size(), drawing->layout_ms);
+}
+
+void GraphView::buildScene() {
+    graphScene->clear();
+    highlightItems.clear();
+    const auto& pos = drawing->positions;
+    if (pos.empty()) return;
+
+    // Bucket nodes into square tiles; an edge belongs to its first endpoint's tile
+    double min_x = pos[0].x, min_y = pos[0].y;
+    for (const LayoutPoint& p : pos) {
+        min_x = std::min(min_x, p.x);
+        min_y = std::min(min_y, p.y);
+    }
+    auto tile_of = [&](int v) {
+        return std::make_pair(static_cast<int>((pos[v].x - min_x) / TILE_SIZE),
+                              static_cast<int>((pos[v].y - min_y) / TILE_SIZE));
+    };
+    std::map<std::pair<int, int>, std::pair<std::vector<int>, std::vector<int>>> tiles;
+    for (size_t v = 0; v < pos.size(); ++v) {
+        tiles[tile_of(v)].first.push_back(v);
+    }
+    for (size_t e = 0; e < drawing->edges.size(); ++e) {
+        tiles[tile_of(drawing->edges[e].first)].second.push_back(e);
+    }
+
+    BundleItem *bundles = new BundleItem(*drawing);
+    bundles->setZValue(-1);
+    graphScene->addItem(bundles);
+    for (auto& [key, content] : tiles) {
+        graphScene->addItem(new TileItem(drawing, heat, std::move(content.first), std::move(content.second)));
+    }
+
+    QRectF bounds = graphScene->itemsBoundingRect();
+    graphScene->setSceneRect(bounds.adjusted(-bounds.width() * 0.05, -bounds.height() * 0.05,
+                                             bounds.width() * 0.05, bounds.height() * 0.05));
+    fitInView(graphScene->sceneRect(), Qt::KeepAspectRatio);
+    buildHighlight();
+}
+
+void GraphView::wheelEvent(QWheelEvent *event) {
+    double factor = event->angleDelta().y() > 0 ? ZOOM_STEP : 1.0 / ZOOM_STEP;
+    scale(factor, factor);
+    event->accept();
+}
@@ -0,0 +1,480 @@
+#include "GtfsLoader.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+// Mean Earth radius, as in Pythonscripts/Leeds_bus.py
+constexpr double EARTH_RADIUS_KM = 6371.0;
+constexpr double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+namespace {
+
+// --- Input ---
+// Splits a CSV buffer into rows of fields that point into the buffer. Quoted
+// fields lose their outer quotes; doubled quotes inside them stay doubled
+// (unquote() collapses them where the text is kept).
+class CsvReader {
+public:
+    CsvReader(const char* begin, const char* end) : pos(begin), stop(end) {
+        if (stop - pos >= 3 && std::memcmp(pos, "\xEF\xBB\xBF", 3) == 0) pos += 3;
+    }
+
+    bool next(std::vector<std::string_view>& fields) {
+        while (pos < stop) {
+            fields.clear();
+            const char* row_start = pos;
+            for (;;) {
+                fields.push_back(field());
+                if (pos < stop && *pos == ',') {
+                    ++pos;
+                    continue;
+                }
+                break;
+            }
+            if (pos < stop && *pos == '\r') ++pos;
+            if (pos < stop && *pos == '\n') ++pos;
+            // Blank lines carry no row
+            if (fields.size() > 1 || !fields[0].empty() || *row_start == '"') return true;
+        }
+        return false;
+    }
+
+private:
+    const char* pos;
+    const char* stop;
+
+    std::string_view field() {
+        if (pos < stop && *pos == '"') {
+            const char* start = ++pos;
+            while (pos < stop) {
+                if (*pos == '"') {
+                    if (pos + 1 < stop && pos[1] == '"') {
+                        pos += 2;
+                        continue;
+                    }
+                    break;
+                }
+                ++pos;
+            }
+            std::string_view text(start, pos - start);
+            if (pos < stop) ++pos;
+            // Anything between the closing quote and the separator is dropped
+            while (pos < stop && *pos != ',' && *pos != '\n' && *pos != '\r') ++pos;
+            return text;
+        }
+        const char* start = pos;
+        while (pos < stop && *pos != ',' && *pos != '\n' && *pos != '\r') ++pos;
+        return std::string_view(start, pos - start);
+    }
+};
+
+std::string unquote(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        out.push_back(text[i]);
+        if (text[i] == '"' && i + 1 < text.size() && text[i + 1] == '"') ++i;
+    }
+    return out;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+int column(const std::vector<std::string_view>& header, const char* name, const char* file) {
+    for (size_t c = 0; c < header.size(); ++c) {
+        if (trim(header[c]) == name) return static_cast<int>(c);
+    }
+    throw std::runtime_error(std::string("GTFS feed: ") + file + " has no " + name + " column");
+}
+
+double parse_double(std::string_view text) {
+    text = trim(text);
+    char buf[64];
+    if (text.empty() || text.size() >= sizeof(buf)) return std::numeric_limits<double>::quiet_NaN();
+    std::memcpy(buf, text.data(), text.size());
+    buf[text.size()] = '\0';
+    char* end = nullptr;
+    double value = std::strtod(buf, &end);
+    return end == buf ? std::numeric_limits<double>::quiet_NaN() : value;
+}
+
+bool parse_int(std::string_view text, int& value) {
+    text = trim(text);
+    if (text.empty()) return false;
+    long long v = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (c - '0');
+        if (v > std::numeric_limits<int>::max()) return false;
+    }
+    value = static_cast<int>(v);
+    return true;
+}
+
+// --- Lookup tables ---
+// Key to int with linear probing in a power-of-two table kept at most half
+// full. Every stop_times.txt row does a stop lookup and every consecutive pair
+// a link lookup, and std::unordered_map pays a node dereference per probe.
+template <typename Key, typename Hash>
+class FlatIndex {
+public:
+    FlatIndex() { rehash(64); }
+
+    // Slot of key, plus whether it was inserted with value
+    std::pair<int*, bool> emplace(const Key& key, int value) {
+        if (2 * (count + 1) > values.size()) rehash(2 * values.size());
+        size_t slot = probe(key);
+        if (values[slot] >= 0) return {&values[slot], false};
+        keys[slot] = key;
+        values[slot] = value;
+        ++count;
+        return {&values[slot], true};
+    }
+    // -1 if absent
+    int find(const Key& key) const {
+        return values[probe(key)];
+    }
+    size_t size() const { return count; }
+    void clear() {
+        count = 0;
+        rehash(64);
+    }
+
+private:
+    std::vector<Key> keys;
+    std::vector<int> values;    // -1 marks an empty slot
+    size_t count = 0;
+
+    size_t probe(const Key& key) const {
+        const size_t mask = values.size() - 1;
+        size_t slot = Hash()(key) & mask;
+        while (values[slot] >= 0 && !(keys[slot] == key)) slot = (slot + 1) & mask;
+        return slot;
+    }
+    void rehash(size_t capacity) {
+        std::vector<Key> old_keys(capacity);
+        std::vector<int> old_values(capacity, -1);
+        old_keys.swap(keys);
+        old_values.swap(values);
+        for (size_t i = 0; i < old_values.size(); ++i) {
+            if (old_values[i] >= 0) {
+                size_t slot = probe(old_keys[i]);
+                keys[slot] = old_keys[i];
+                values[slot] = old_values[i];
+            }
+        }
+    }
+};
+
+// FNV-1a, as for the job fingerprints of ShardedExact
+struct TextHash {
+    size_t operator()(std::string_view text) const {
+        std::uint64_t h = 1469598103934665603ull;
+        for (unsigned char c : text) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+// splitmix64 finaliser; the packed vertex pairs are far from uniform
+struct PairHash {
+    size_t operator()(std::uint64_t key) const {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ull;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebull;
+        return static_cast<size_t>(key ^ (key >> 31));
+    }
+};
+
+// --- Graph assembly ---
+struct TripStop {
+    int sequence;
+    int stop;
+};
+
+struct Link {
+    int u;
+    int v;
+    double weight;
+};
+
+class GtfsBuilder {
+public:
+    void read_stops(const MappedFile& file);
+    // False if a trip_id reappeared after other trips, i.e. the rows are not grouped
+    bool stream_stop_times(const MappedFile& file);
+    void sort_stop_times(const MappedFile& file);
+    GtfsGraph finish();
+
+private:
+    // Per stop of stops.txt; coordinates in radians
+    FlatIndex<std::string_view, TextHash> stop_index;
+    std::vector<int> stop_node;
+    std::vector<double> stop_lat, stop_lon, stop_cos_lat;
+    std::vector<std::string> names;
+
+    // Deduplicated undirected links, keyed by (min, max) vertex pair
+    std::vector<Link> links;
+    FlatIndex<std::uint64_t, PairHash> link_index;
+
+    size_t rows = 0;
+    size_t trips = 0;
+
+    // Scratch reused by every trip
+    std::vector<double> lat1, lon1, cos1, lat2, lon2, cos2, dist;
+
+    struct StopTimeColumns {
+        int trip, stop, sequence;
+    };
+    StopTimeColumns stop_time_columns(CsvReader& reader, std::vector<std::string_view>& fields) const;
+    void add_trip(std::vector<TripStop>& trip);
+};
+
+void GtfsBuilder::read_stops(const MappedFile& file) {
+    CsvReader reader(file.begin(), file.end());
+    std::vector<std::string_view> fields;
+    if (!reader.next(fields)) throw std::runtime_error("GTFS feed: stops.txt is empty");
+    const int c_id = column(fields, "stop_id", "stops.txt");
+    const int c_name = column(fields, "stop_name", "stops.txt");
+    const int c_lat = column(fields, "stop_lat", "stops.txt");
+    const int c_lon = column(fields, "stop_lon", "stops.txt");
+    const size_t width = std::max({c_id, c_name, c_lat, c_lon}) + 1;
+
+    std::unordered_map<std::string, int> name_index;
+    while (reader.next(fields)) {
+        if (fields.size() < width) continue;
+        double lat = parse_double(fields[c_lat]);
+        double lon = parse_double(fields[c_lon]);
+        // Stops without coordinates cannot be weighted; their visits are skipped
+        if (std::isnan(lat) || std::isnan(lon)) continue;
+        std::string_view id = trim(fields[c_id]);
+        if (!stop_index.emplace(id, static_cast<int>(stop_node.size())).second) continue;
+
+        std::string name = unquote(trim(fields[c_name]));
+        if (name.empty()) name = unquote(id);
+        auto [it, inserted] = name_index.emplace(name, static_cast<int>(names.size()));
+        if (inserted) names.push_back(std::move(name));
+
+        stop_node.push_back(it->second);
+        stop_lat.push_back(lat * DEG_TO_RAD);
+        stop_lon.push_back(lon * DEG_TO_RAD);
+        stop_cos_lat.push_back(std::cos(lat * DEG_TO_RAD));
+    }
+}
+
+GtfsBuilder::StopTimeColumns GtfsBuilder::stop_time_columns(CsvReader& reader,
+                                                            std::vector<std::string_view>& fields) const {
+    if (!reader.next(fields)) throw std::runtime_error("GTFS feed: stop_times.txt is empty");
+    return {column(fields, "trip_id", "stop_times.txt"),
+            column(fields, "stop_id", "stop_times.txt"),
+            column(fields, "stop_sequence", "stop_times.txt")};
+}
+
+// Feeds the consecutive stops of one trip into the link set. The distances
+// are computed first over flat coordinate arrays so the haversine loop has no
+// lookups or branches and can be vectorised.
+void GtfsBuilder::add_trip(std::vector<TripStop>& trip) {
+    if (trip.size() < 2) return;
+    auto by_sequence = [](const TripStop& a, const TripStop& b) { return a.sequence < b.sequence; };
+    if (!std::is_sorted(trip.begin(), trip.end(), by_sequence)) {
+        std::stable_sort(trip.begin(), trip.end(), by_sequence);
+    }
+
+    const size_t m = trip.size() - 1;
+    for (auto* v : {&lat1, &lon1, &cos1, &lat2, &lon2, &cos2, &dist}) v->resize(m);
+    for (size_t t = 0; t < m; ++t) {
+        int a = trip[t].stop, b = trip[t + 1].stop;
+        lat1[t] = stop_lat[a]; lon1[t] = stop_lon[a]; cos1[t] = stop_cos_lat[a];
+        lat2[t] = stop_lat[b]; lon2[t] = stop_lon[b]; cos2[t] = stop_cos_lat[b];
+    }
+    const double* la1 = lat1.data(); const double* lo1 = lon1.data(); const double* c1 = cos1.data();
+    const double* la2 = lat2.data(); const double* lo2 = lon2.data(); const double* c2 = cos2.data();
+    double* d = dist.data();
+    #pragma omp simd
+    for (size_t t = 0; t < m; ++t) {
+        double s_lat = std::sin(0.5 * (la2[t] - la1[t]));
+        double s_lon = std::sin(0.5 * (lo2[t] - lo1[t]));
+        double h = s_lat * s_lat + c1[t] * c2[t] * s_lon * s_lon;
+        d[t] = 2.0 * EARTH_RADIUS_KM * std::asin(std::sqrt(std::min(1.0, h)));
+    }
+
+    for (size_t t = 0; t < m; ++t) {
+        int u = stop_node[trip[t].stop];
+        int v = stop_node[trip[t + 1].stop];
+        if (u == v) continue;
+        if (u > v) std::swap(u, v);
+        std::uint64_t key = (static_cast<std::uint64_t>(u) << 32) | static_cast<std::uint32_t>(v);
+        auto [slot, inserted] = link_index.emplace(key, static_cast<int>(links.size()));
+        if (inserted) {
+            links.push_back({u, v, d[t]});
+        } else {
+            links[*slot].weight = std::min(links[*slot].weight, d[t]);
+        }
+    }
+}
+
+bool GtfsBuilder::stream_stop_times(const MappedFile& file) {
+    CsvReader reader(file.begin(), file.end());
+    std::vector<std::string_view> fields;
+    const StopTimeColumns c = stop_time_columns(reader, fields);
+    const size_t width = std::max({c.trip, c.stop, c.sequence}) + 1;
+
+    std::vector<TripStop> trip;
+    FlatIndex<std::string_view, TextHash> finished;
+    std::string_view current;
+    bool open = false;
+    while (reader.next(fields)) {
+        if (fields.size() < width) continue;
+        ++rows;
+        std::string_view trip_id = trim(fields[c.trip]);
+        if (!open || trip_id != current) {
+            if (open) {
+                add_trip(trip);
+                finished.emplace(current, 0);
+            }
+            if (finished.find(trip_id) >= 0) return false;
+            trip.clear();
+            current = trip_id;
+            open = true;
+            ++trips;
+        }
+        // Visits of unknown stops are dropped, joining their neighbours (the
+        // inner merge of the Python script does the same)
+        int stop = stop_index.find(trim(fields[c.stop]));
+        int sequence;
+        if (stop < 0 || !parse_int(fields[c.sequence], sequence)) continue;
+        trip.push_back({sequence, stop});
+    }
+    if (open) add_trip(trip);
+    return true;
+}
+
+// Fallback for feeds whose rows are not grouped by trip: every visit is
+// collected and sorted by (trip, stop_sequence) before the links are built
+void GtfsBuilder::sort_stop_times(const MappedFile& file) {
+    links.clear();
+    link_index.clear();
+    rows = 0;
+
+    CsvReader reader(file.begin(), file.end());
+    std::vector<std::string_view> fields;
+    const StopTimeColumns c = stop_time_columns(reader, fields);
+    const size_t width = std::max({c.trip, c.stop, c.sequence}) + 1;
+
+    struct Visit {
+        int trip;
+        int sequence;
+        int stop;
+    };
+    std::vector<Visit> visits;
+    FlatIndex<std::string_view, TextHash> trip_index;
+    while (reader.next(fields)) {
+        if (fields.size() < width) continue;
+        ++rows;
+        int trip = *trip_index.emplace(trim(fields[c.trip]), static_cast<int>(trip_index.size())).first;
+        int stop = stop_index.find(trim(fields[c.stop]));
+        int sequence;
+        if (stop < 0 || !parse_int(fields[c.sequence], sequence)) continue;
+        visits.push_back({trip, sequence, stop});
+    }
+    trips = trip_index.size();
+
+    std::stable_sort(visits.begin(), visits.end(), [](const Visit& a, const Visit& b) {
+        return a.trip != b.trip ? a.trip < b.trip : a.sequence < b.sequence;
+    });
+    std::vector<TripStop> trip;
+    for (size_t i = 0; i < visits.size(); ++i) {
+        if (i > 0 && visits[i].trip != visits[i - 1].trip) {
+            add_trip(trip);
+            trip.clear();
+        }
+        trip.push_back({visits[i].sequence, visits[i].stop});
+    }
+    add_trip(trip);
+}
+
+GtfsGraph GtfsBuilder::finish() {
+    GtfsGraph graph;
+    graph.stop_time_rows = rows;
+    graph.trips = trips;
+
+    // Only served stops become vertices, numbered in stops.txt order
+    std::vector<int> vertex(names.size(), -1);
+    for (const Link& link : links) vertex[link.u] = vertex[link.v] = 0;
+    for (size_t s = 0; s < names.size(); ++s) {
+        if (vertex[s] < 0) continue;
+        vertex[s] = static_cast<int>(graph.nodes.size());
+        graph.nodes.push_back(std::move(names[s]));
+    }
+
+    const int n = graph.nodes.size();
+    graph.offsets.assign(n + 1, 0);
+    for (const Link& link : links) {
+        ++graph.offsets[vertex[link.u] + 1];
+        ++graph.offsets[vertex[link.v] + 1];
+    }
+    for (int v = 0; v < n; ++v) graph.offsets[v + 1] += graph.offsets[v];
+    graph.targets.resize(graph.offsets[n]);
+    graph.weights.resize(graph.offsets[n]);
+    std::vector<int> cursor(graph.offsets.begin(), graph.offsets.end() - 1);
+    for (const Link& link : links) {
+        int u = vertex[link.u], v = vertex[link.v];
+        graph.targets[cursor[u]] = v;
+        graph.weights[cursor[u]++] = link.weight;
+        graph.targets[cursor[v]] = u;
+        graph.weights[cursor[v]++] = link.weight;
+    }
+    return graph;
+}
+
+} // namespace
+
+std::vector<std::vector<std::pair<int, double>>> GtfsGraph::adjacency_list() const {
+    std::vector<std::vector<std::pair<int, double>>> adj(nodes.size());
+    for (size_t v = 0; v < nodes.size(); ++v) {
+        adj[v].reserve(offsets[v + 1] - offsets[v]);
+        for (int e = offsets[v]; e < offsets[v + 1]; ++e) {
+            adj[v].emplace_back(targets[e], weights[e]);
+        }
+    }
+    return adj;
+}
+
+GtfsGraph load_gtfs(const std::string& directory) {
+    const fs::path dir(directory);
+    for (const char* name : {"stops.txt", "stop_times.txt"}) {
+        if (!fs::is_regular_file(dir / name)) {
+            throw std::runtime_error(std::string("GTFS feed: no ") + name + " in " + directory);
+        }
+    }
+
+    // stops.txt stays mapped while stop_times.txt is read: the stop index
+    // points into it
+    GtfsBuilder builder;
+    MappedFile stops((dir / "stops.txt").string());
+    builder.read_stops(stops);
+    MappedFile stop_times((dir / "stop_times.txt").string());
+    bool grouped = builder.stream_stop_times(stop_times);
+    if (!grouped) builder.sort_stop_times(stop_times);
+
+    GtfsGraph graph = builder.finish();
+    graph.resorted = !grouped;
+    return graph;
+}
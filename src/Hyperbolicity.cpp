@@ -2,6 +2,7 @@
 //----------
 #include "Hyperbolicity.h"
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <stdexcept>
 #include <functional>
@@ -11,44 +12,53 @@
 constexpr double INF = std::numeric_limits<double>::infinity();
 
 HyperbolicityCalculator::HyperbolicityCalculator(const std::vector<std::vector<double>>& dist_matrix)
-    : distances(dist_matrix) {
+    : distances(dist_matrix.size()) {
     int n = distances.size();
     for (int i = 0; i < n; ++i) {
-        if (distances[i].size() != n) {
+        if (dist_matrix[i].size() != distances.size()) {
             throw std::invalid_argument("Distance matrix must be square.");
         }
+        if (dist_matrix[i][i] != 0.0) {
+            throw std::invalid_argument("Diagonal entries must be zero.");
+        }
+        distances[i] = dist_matrix[i].data();
+    }
+}
+
+HyperbolicityCalculator::HyperbolicityCalculator(const double* dist_matrix, int n)
+    : distances(n) {
+    for (int i = 0; i < n; ++i) {
+        distances[i] = dist_matrix + static_cast<size_t>(i) * n;
         if (distances[i][i] != 0.0) {
             throw std::invalid_argument("Diagonal entries must be zero.");
         }
-        
     }
 }
 
-std::vector<std::vector<double>> HyperbolicityCalculator::gromov_product_matrix(int r) const {
+MatrixBuffer<double> HyperbolicityCalculator::gromov_product_matrix(int r) const {
     int n = distances.size();
-    std::vector<std::vector<double>> A(n, std::vector<double>(n));
-    
+    MatrixBuffer<double> A(static_cast<size_t>(n) * n, HugePageAllocator<double>(memory_config));
+    const double* row_r = distances[r];
 
+    #pragma omp parallel for schedule(static)
     for (int i = 0; i < n; ++i) {
+        const double* row_i = distances[i];
+        double* out = &A[static_cast<size_t>(i) * n];
         for (int j = 0; j < n; ++j) {
             // A[i][j] = 0.5 * (distances[i][r] + distances[r][j] - distances[i][j]);
-            // Assuming distances matrix is valid and square
-            double dr_i = distances[r][i];
-            double dr_j = distances[r][j];
-            double di_j = distances[i][j];
+            double dr_i = row_r[i];
+            double dr_j = row_r[j];
+            double di_j = row_i[j];
 
             // Check if ALL relevant distances are finite
             if ((dr_i)!=INF && (dr_j)!=INF && (di_j)!=INF)
             {
-                // If all finite, compute the Gromov product
-                A[i][j] = 0.5 * (dr_i + dr_j - di_j);
-                // Optional: check for NaN result from potential 0*INF if distances were non-numeric?
-                
+                out[j] = 0.5 * (dr_i + dr_j - di_j);
             }
             else
             {
                 // If any distance is INF, explicitly set Gromov product to indicate disconnection
-                A[i][j] = -INF;
+                out[j] = -INF;
             }
         }
     }
@@ -56,26 +66,38 @@ std::vector<std::vector<double>> HyperbolicityCalculator::gromov_product_matrix(
     return A;
 }
 
-std::vector<std::vector<double>> HyperbolicityCalculator::max_min_product(
-    const std::vector<std::vector<double>>& A
-) const {
-    int n = A.size();
+MatrixBuffer<double> HyperbolicityCalculator::max_min_product(const MatrixBuffer<double>& A) const {
+    int n = distances.size();
     if (n == 0) return {};
-     if (A[0].size() != n) {
-         throw std::invalid_argument("Input matrix A must be square.");
+    if (A.size() != static_cast<size_t>(n) * n) {
+        throw std::invalid_argument("Input matrix A must be square.");
     }
 
     constexpr double N_INF = -std::numeric_limits<double>::infinity();
-    std::vector<std::vector<double>> result(n, std::vector<double>(n, N_INF));
+    MatrixBuffer<double> result(A.size(), HugePageAllocator<double>(memory_config));
 
-    // Parallelize the outer loop 'i'
+    std::vector<const double*> A_rows(n);
+    std::vector<double*> result_rows(n);
+    for (int i = 0; i < n; ++i) {
+        A_rows[i] = &A[static_cast<size_t>(i) * n];
+        result_rows[i] = &result[static_cast<size_t>(i) * n];
+    }
+    if (resolve_max_min_backend(max_min_backend, A_rows, n) == MaxMinBackend::ThresholdBitset) {
+        threshold_max_min_product(A_rows, result_rows, n, memory_config);
+        return result;
+    }
+
+    // Parallelize the outer loop 'i'; row i is initialised by its own thread
     #pragma omp parallel for schedule(static)
     for (int i = 0; i < n; ++i) {
+        double* res_i = result_rows[i];
+        std::fill(res_i, res_i + n, N_INF);
         for (int k = 0; k < n; ++k) {
-             double Aik = A[i][k];
+            double Aik = A_rows[i][k];
+            const double* A_k = A_rows[k];
             for (int j = 0; j < n; ++j) {
-                double min_val = std::min(Aik, A[k][j]);
-                result[i][j] = std::max(result[i][j], min_val);
+                double min_val = std::min(Aik, A_k[j]);
+                res_i[j] = std::max(res_i[j], min_val);
             }
         }
     }
@@ -83,38 +105,223 @@ std::vector<std::vector<double>> HyperbolicityCalculator::max_min_product(
 }
 
 
+// --- Witness tracking ---
+// Largest A_sq - A over the finite entries of one n x n matrix, 0 if none is
+// positive. Each thread keeps its own maximum and position; the maxima are
+// merged once at the end, ties going to the first entry in row-major order
+// so the result matches a serial scan.
+static double max_gap(const double* A, const double* A_sq, int n, int& best_i, int& best_j) {
+    double best = 0.0;
+    long long best_idx = -1;
+
+    #pragma omp parallel
+    {
+        double local = 0.0;
+        long long local_idx = -1;
+        #pragma omp for schedule(static) nowait
+        for (int i = 0; i < n; ++i) {
+            const double* A_i = A + static_cast<size_t>(i) * n;
+            const double* A_sq_i = A_sq + static_cast<size_t>(i) * n;
+            for (int j = 0; j < n; ++j) {
+                if (A_i[j] != INF && A_sq_i[j] != INF && A_sq_i[j] - A_i[j] > local) {
+                    local = A_sq_i[j] - A_i[j];
+                    local_idx = static_cast<long long>(i) * n + j;
+                }
+            }
+        }
+        #pragma omp critical
+        {
+            if (local_idx >= 0 && (local > best || (local == best && local_idx < best_idx))) {
+                best = local;
+                best_idx = local_idx;
+            }
+        }
+    }
+    if (best_idx >= 0) {
+        best_i = static_cast<int>(best_idx / n);
+        best_j = static_cast<int>(best_idx % n);
+    }
+    return best;
+}
+
+// Intermediate k of the max-min product entry (i, j): O(n) after the fact
+// instead of an argmax carried through the product kernels
+static int max_min_witness(const double* A, int n, int i, int j) {
+    int best_k = i;
+    double best_val = -INF;
+    for (int k = 0; k < n; ++k) {
+        double v = std::min(A[static_cast<size_t>(i) * n + k], A[static_cast<size_t>(k) * n + j]);
+        if (v > best_val) {
+            best_val = v;
+            best_k = k;
+        }
+    }
+    return best_k;
+}
+
 double HyperbolicityCalculator::compute_for_base(int r) {
+    return compute_for_base(r, nullptr);
+}
+
+double HyperbolicityCalculator::compute_for_base(int r, BaseWitness* witness) {
+    const int n = distances.size();
     auto A = gromov_product_matrix(r);
     auto A_sq = max_min_product(A);
-    double max_delta = 0.0;
-    
-    for (auto i = 0; i < A.size(); ++i) {
-        for (auto j = 0; j < A.size(); ++j) {
+    int best_i = r, best_j = r;
+    double max_delta = max_gap(A.data(), A_sq.data(), n, best_i, best_j);
 
-            double a_ij = A[i][j];
-            double a_sq_ij = A_sq[i][j];
+    if (witness) {
+        int best_k = max_delta > 0.0 ? max_min_witness(A.data(), n, best_i, best_j) : r;
+        *witness = BaseWitness{r, best_i, best_j, best_k};
+    }
+    return max_delta;
+}
 
-            
-            if ((a_ij)!=INF && (a_sq_ij)!=INF)
-            {
+// --- Batched multi-base evaluation ---
+// The k Gromov product matrices are built in a single sweep over the distance
+// matrix: each d(i, j) is loaded once and feeds every base.
+MatrixBuffer<double> HyperbolicityCalculator::batched_gromov_products(const std::vector<int>& bases) const {
+    int n = distances.size();
+    int k = bases.size();
+    const size_t plane = static_cast<size_t>(n) * n;
+    MatrixBuffer<double> A(plane * k, HugePageAllocator<double>(memory_config));
 
-                max_delta = std::max(max_delta, a_sq_ij - a_ij);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; ++i) {
+        const double* row_i = distances[i];
+        for (int b = 0; b < k; ++b) {
+            const double* row_r = distances[bases[b]];
+            double dr_i = row_r[i];
+            double* out = &A[b * plane + static_cast<size_t>(i) * n];
+            for (int j = 0; j < n; ++j) {
+                double dr_j = row_r[j];
+                double di_j = row_i[j];
+                if (dr_i != INF && dr_j != INF && di_j != INF) {
+                    out[j] = 0.5 * (dr_i + dr_j - di_j);
+                } else {
+                    out[j] = -INF;
+                }
+            }
+        }
+    }
+    return A;
+}
+
+// One parallel sweep over rows i serves all bases; for each base the result
+// row stays hot while row m of that base's plane is streamed.
+MatrixBuffer<double> HyperbolicityCalculator::batched_max_min_product(const MatrixBuffer<double>& A, int k) const {
+    int n = distances.size();
+    const size_t plane = static_cast<size_t>(n) * n;
+    MatrixBuffer<double> result(A.size(), HugePageAllocator<double>(memory_config));
+
+    // Planes whose backend resolves to the threshold kernel are handled one by one
+    std::vector<char> dense(k, 1);
+    for (int b = 0; b < k; ++b) {
+        std::vector<const double*> A_rows(n);
+        std::vector<double*> result_rows(n);
+        for (int i = 0; i < n; ++i) {
+            A_rows[i] = &A[b * plane + static_cast<size_t>(i) * n];
+            result_rows[i] = &result[b * plane + static_cast<size_t>(i) * n];
+        }
+        if (resolve_max_min_backend(max_min_backend, A_rows, n) == MaxMinBackend::ThresholdBitset) {
+            threshold_max_min_product(A_rows, result_rows, n, memory_config);
+            dense[b] = 0;
+        }
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; ++i) {
+        for (int b = 0; b < k; ++b) {
+            if (!dense[b]) continue;
+            const double* A_b = &A[b * plane];
+            const double* A_i = A_b + static_cast<size_t>(i) * n;
+            double* res_i = &result[b * plane + static_cast<size_t>(i) * n];
+            std::fill(res_i, res_i + n, -INF);
+            for (int m = 0; m < n; ++m) {
+                double A_im = A_i[m];
+                const double* A_m = A_b + static_cast<size_t>(m) * n;
+                for (int j = 0; j < n; ++j) {
+                    res_i[j] = std::max(res_i[j], std::min(A_im, A_m[j]));
+                }
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<double> HyperbolicityCalculator::compute_for_bases(const std::vector<int>& bases,
+                                                               std::vector<BaseWitness>* witnesses) {
+    int n = distances.size();
+    int k = bases.size();
+    for (int r : bases) {
+        if (r < 0 || r >= n) {
+            throw std::out_of_range("compute_for_bases: base index out of range.");
+        }
+    }
+    if (witnesses) {
+        witnesses->clear();
+        for (int r : bases) witnesses->push_back(BaseWitness{r, r, r, r});
+    }
+    if (k == 0 || n == 0) return std::vector<double>(k, 0.0);
+
+    // Each base needs two n x n planes; chunks keep them under the cap
+    const size_t plane = static_cast<size_t>(n) * n;
+    const int chunk = static_cast<int>(std::max<size_t>(1, BATCH_MEMORY_BYTES / (2 * plane * sizeof(double))));
+
+    std::vector<double> max_delta(k, 0.0);
+    for (int first = 0; first < k; first += chunk) {
+        const std::vector<int> part(bases.begin() + first, bases.begin() + std::min(k, first + chunk));
+        const int count = part.size();
+        auto A = batched_gromov_products(part);
+        auto A_sq = batched_max_min_product(A, count);
+        for (int b = 0; b < count; ++b) {
+            const double* a = &A[b * plane];
+            int best_i = part[b], best_j = part[b];
+            max_delta[first + b] = max_gap(a, &A_sq[b * plane], n, best_i, best_j);
+            if (witnesses && max_delta[first + b] > 0.0) {
+                (*witnesses)[first + b] = BaseWitness{part[b], best_i, best_j, max_min_witness(a, n, best_i, best_j)};
             }
         }
     }
     return max_delta;
 }
 
-double HyperbolicityCalculator::compute_exact_hyperbolicity() {
+double HyperbolicityCalculator::compute_exact_hyperbolicity(BaseWitness* witness) {
+    std::vector<double> base_deltas(distances.size(), std::numeric_limits<double>::quiet_NaN());
+    std::vector<BaseWitness> base_witnesses(distances.size());
+    double delta = compute_exact_hyperbolicity(base_deltas, witness ? &base_witnesses : nullptr);
+    if (witness) *witness = strongest_witness(base_deltas, base_witnesses);
+    return delta;
+}
+
+double HyperbolicityCalculator::compute_exact_hyperbolicity(std::vector<double>& base_deltas,
+                                                            std::vector<BaseWitness>* base_witnesses) {
     int n = distances.size();
+    if (base_deltas.size() != static_cast<size_t>(n) ||
+        (base_witnesses && base_witnesses->size() != static_cast<size_t>(n))) {
+        throw std::invalid_argument("compute_exact_hyperbolicity: one entry per vertex expected.");
+    }
     double max_hyperbolicity = 0.0;
 
     // #pragma omp parallel for reduction(max:max_hyperbolicity) schedule(dynamic)
     for (int r = 0; r < n; ++r) {
-        double delta_r = compute_for_base(r);
-        max_hyperbolicity = std::max(max_hyperbolicity, delta_r);
+        if (std::isnan(base_deltas[r])) {
+            base_deltas[r] = compute_for_base(r, base_witnesses ? &(*base_witnesses)[r] : nullptr);
+        }
+        max_hyperbolicity = std::max(max_hyperbolicity, base_deltas[r]);
     }
 
     return max_hyperbolicity;
 }
 
+BaseWitness strongest_witness(const std::vector<double>& base_deltas, const std::vector<BaseWitness>& base_witnesses) {
+    BaseWitness best;
+    double best_delta = -INF;
+    for (size_t r = 0; r < base_deltas.size() && r < base_witnesses.size(); ++r) {
+        if (!std::isnan(base_deltas[r]) && base_deltas[r] > best_delta) {
+            best_delta = base_deltas[r];
+            best = base_witnesses[r];
+        }
+    }
+    return best;
+}
@@ -0,0 +1,637 @@
+#include "HyperbolicityServer.h"
+#include "backend.h"
+#include "ShortestPath.h"
+#include "Planner.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QReadWriteLock>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <omp.h>
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+// A client that sends more than this without a newline is disconnected
+constexpr qint64 MAX_REQUEST_BYTES = qint64(64) << 20;
+constexpr double MEGABYTE = 1024.0 * 1024.0;
+
+// Set on TCP sockets until they sent the token
+static const char* const NEEDS_TOKEN = "needsToken";
+
+// Refusals the client should retry later; answered with "busy": true
+struct ServerBusy : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// Methods a compute request may name (computeHyperbolicity)
+static const QStringList SERVED_METHODS = {
+    "Auto",
+    "Exact Algorithm",
+    "Factor-2 Approximation",
+    "Factor-2 Multi-base Approximation",
+    "Log Approximation",
+    "Local Hyperbolicity (k-hop balls)",
+    "Local Hyperbolicity (radius balls)",
+};
+
+// --- Loaded graphs ---
+struct HyperbolicityServer::LoadedGraph {
+    QString path;
+    std::unique_ptr<Graph> graph;
+    QHash<QString, int> index;                                   // Node name -> position in graph->nodes
+    std::vector<std::vector<std::pair<int, double>>> adj_list;   // Node order, for distance queries
+
+    QReadWriteLock lock;            // Edits write; every other request reads
+    QMutex cacheMutex;              // Guards cache and session
+    ComputeCache cache;
+    std::unique_ptr<DynamicSession> session;
+    QString sessionKey;
+
+    QMutex resultsMutex;            // Guards results
+    QHash<QString, QJsonObject> results;   // Result objects by request key; edits clear them
+
+    // Rebuilds index and adj_list after the graph changed
+    void reindex() {
+        index.clear();
+        for (int i = 0; i < graph->nodes.size(); ++i) index.insert(graph->nodes[i], i);
+        // Edges are stored in both directions already
+        adj_list.assign(graph->nodes.size(), {});
+        for (const Edge& edge : graph->edges) {
+            adj_list[index.value(edge.source)].emplace_back(index.value(edge.target), edge.weight);
+        }
+    }
+};
+
+static QJsonObject graphSummary(const QString& name, const HyperbolicityServer::LoadedGraph& loaded);
+
+static ComputeOptions computeOptionsFromJson(const QJsonObject& json) {
+    ComputeOptions options;
+    options.num_bases = json.value("num_bases").toInt(options.num_bases);
+    options.base_selection = json.value("base_selection").toString(options.base_selection);
+    options.seed = static_cast<unsigned int>(json.value("seed").toDouble(options.seed));
+    options.max_min_backend = json.value("max_min_backend").toString(options.max_min_backend);
+    options.use_distance_oracle = json.value("use_distance_oracle").toBool(options.use_distance_oracle);
+    options.local_hops = json.value("local_hops").toInt(options.local_hops);
+    options.local_radius = json.value("local_radius").toDouble(options.local_radius);
+    options.time_budget_s = json.value("time_budget_s").toDouble(options.time_budget_s);
+    options.memory_budget_mb = json.value("memory_budget_mb").toDouble(options.memory_budget_mb);
+    options.vertex_order = json.value("vertex_order").toString(options.vertex_order);
+    return options;
+}
+
+static QString requiredString(const QJsonObject& request, const QString& key) {
+    QString value = request.value(key).toString();
+    if (value.isEmpty()) {
+        throw std::invalid_argument(QString("Missing \"%1\"").arg(key).toStdString());
+    }
+    return value;
+}
+
+static int nodeIndex(const HyperbolicityServer::LoadedGraph& loaded, const QString& name) {
+    auto it = loaded.index.constFind(name);
+    if (it == loaded.index.constEnd()) {
+        throw std::invalid_argument(QString("Unknown vertex \"%1\"").arg(name).toStdString());
+    }
+    return it.value();
+}
+
+// Compares every byte, so the time taken does not reveal the matching prefix
+static bool tokenMatches(const QByteArray& given, const QByteArray& token) {
+    if (given.size() != token.size()) return false;
+    unsigned char diff = 0;
+    for (int i = 0; i < token.size(); ++i) diff |= static_cast<unsigned char>(given[i] ^ token[i]);
+    return diff == 0;
+}
+
+// Unreachable vertices become null, as JSON has no infinity
+static QJsonValue distanceValue(double d) {
+    return d == INF ? QJsonValue() : QJsonValue(d);
+}
+
+// --- Server ---
+HyperbolicityServer::HyperbolicityServer(const ServerOptions& options, QObject* parent)
+    : QObject(parent), options(options) {
+    this->options.workers = std::max(1, options.workers);
+    this->options.max_pending = std::max(this->options.workers, options.max_pending);
+    pool.setMaxThreadCount(this->options.workers);
+    pool.setExpiryTimeout(-1);   // Workers, and the OpenMP teams they start, stay alive
+    // Cores are split between the workers instead of every request taking them all
+    threadsPerWorker = std::max(1, omp_get_max_threads() / this->options.workers);
+    budgetBytes = options.memory_mb > 0 ? options.memory_mb * MEGABYTE
+                                        : static_cast<double>(available_memory_bytes());
+    if (budgetBytes <= 0) budgetBytes = std::numeric_limits<double>::infinity();
+}
+
+HyperbolicityServer::~HyperbolicityServer() {
+    // Workers use the graphs; they have to finish before the members go
+    pool.waitForDone();
+}
+
+bool HyperbolicityServer::listen(QString* error) {
+    localServer = new QLocalServer(this);
+    localServer->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!localServer->listen(options.name)) {
+        // A socket file left by a server that died is removed; a live one is kept
+        QLocalSocket probe;
+        probe.connectToServer(options.name);
+        if (probe.waitForConnected(1000)) {
+            *error = QString("Another server is listening on %1").arg(options.name);
+            return false;
+        }
+        QLocalServer::removeServer(options.name);
+        if (!localServer->listen(options.name)) {
+            *error = localServer->errorString();
+            return false;
+        }
+    }
+    connect(localServer, &QLocalServer::newConnection, this, [this]() {
+        while (QLocalSocket* socket = localServer->nextPendingConnection()) attach(socket, false);
+    });
+
+    if (options.port > 0) {
+        if (options.token.isEmpty()) {
+            *error = "--port needs a token (--token-file): every local user can reach the port";
+            return false;
+        }
+        tcpServer = new QTcpServer(this);
+        if (!tcpServer->listen(QHostAddress::LocalHost, options.port)) {
+            *error = tcpServer->errorString();
+            return false;
+        }
+        connect(tcpServer, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket* socket = tcpServer->nextPendingConnection()) attach(socket, true);
+        });
+    }
+
+    std::cout << "Listening on " << localServer->fullServerName().toStdString();
+    if (tcpServer) std::cout << " and 127.0.0.1:" << options.port;
+    std::cout << " with " << options.workers << " worker(s) of " << threadsPerWorker << " thread(s)" << std::endl;
+    return true;
+}
+
+template <class Socket>
+void HyperbolicityServer::attach(Socket* socket, bool needsToken) {
+    socket->setProperty(NEEDS_TOKEN, needsToken);
+    connect(socket, &Socket::readyRead, this, [this, socket]() {
+        while (socket->canReadLine()) {
+            QByteArray line = socket->readLine().trimmed();
+            if (!line.isEmpty()) handleLine(socket, line);
+        }
+        if (socket->bytesAvailable() > MAX_REQUEST_BYTES) {
+            QJsonObject response;
+            response["ok"] = false;
+            response["error"] = "Request too long";
+            reply(socket, response);
+            socket->close();
+        }
+    });
+    connect(socket, &Socket::disconnected, socket, &QObject::deleteLater);
+}
+
+void HyperbolicityServer::handleLine(QIODevice* socket, const QByteArray& line) {
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+    QJsonObject request = document.object();
+    QJsonObject response;
+    if (request.contains("id")) response["id"] = request.value("id");
+
+    const QString op = request.value("op").toString();
+    if (socket->property(NEEDS_TOKEN).toBool()) {
+        // Nothing else is read from the connection until the token matched
+        const bool ok = op == "auth" && tokenMatches(request.value("token").toString().toUtf8(), options.token);
+        response["ok"] = ok;
+        if (!ok) response["error"] = "Authentication required: send {\"op\": \"auth\", \"token\": ...} first";
+        reply(socket, response);
+        if (ok) socket->setProperty(NEEDS_TOKEN, false);
+        else socket->close();
+        return;
+    }
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        response["ok"] = false;
+        response["error"] = "Invalid JSON: " + parseError.errorString();
+        reply(socket, response);
+        return;
+    }
+
+    // Cheap requests are answered on the event loop
+    if (op == "ping" || op == "auth" || op == "stats" || op == "graphs" || op == "unload" || op == "shutdown") {
+        response["ok"] = true;
+        if (op == "stats") {
+            response["stats"] = statistics();
+        } else if (op == "graphs") {
+            response["graphs"] = statistics().value("graphs");
+        } else if (op == "unload") {
+            QMutexLocker locker(&graphsMutex);
+            // Requests already running keep their copy until they finish
+            const bool removed = graphs.remove(request.value("graph").toString()) > 0;
+            response["ok"] = removed;
+            if (!removed) response["error"] = "Unknown graph";
+        } else if (op == "shutdown") {
+            QTimer::singleShot(0, QCoreApplication::instance(), &QCoreApplication::quit);
+        }
+        ++served;
+        reply(socket, response);
+        return;
+    }
+
+    QJsonObject (HyperbolicityServer::*handler)(const QJsonObject&) = nullptr;
+    if (op == "load") handler = &HyperbolicityServer::load;
+    else if (op == "compute") handler = &HyperbolicityServer::compute;
+    else if (op == "edit") handler = &HyperbolicityServer::edit;
+    else if (op == "distance") handler = &HyperbolicityServer::distance;
+    if (!handler) {
+        response["ok"] = false;
+        response["error"] = QString("Unknown op \"%1\"").arg(op);
+        reply(socket, response);
+        return;
+    }
+
+    // Admission control: refuse rather than let the queue grow without bound
+    if (pending >= options.max_pending) {
+        ++rejected;
+        response["ok"] = false;
+        response["busy"] = true;
+        response["error"] = "Server busy, retry later";
+        reply(socket, response);
+        return;
+    }
+
+    ++pending;
+    QPointer<QIODevice> target(socket);
+    pool.start([this, target, handler, request, response]() {
+        omp_set_num_threads(threadsPerWorker);
+        QElapsedTimer timer;
+        timer.start();
+        QJsonObject out = response;
+        try {
+            const QJsonObject body = (this->*handler)(request);
+            for (auto it = body.begin(); it != body.end(); ++it) out.insert(it.key(), it.value());
+            out["ok"] = true;
+        } catch (const ServerBusy& e) {
+            out["ok"] = false;
+            out["busy"] = true;
+            out["error"] = QString::fromStdString(e.what());
+        } catch (const std::bad_alloc&) {
+            out["ok"] = false;
+            out["error"] = "Out of memory";
+        } catch (const std::exception& e) {
+            out["ok"] = false;
+            out["error"] = QString::fromStdString(e.what());
+        }
+        out["elapsed_us"] = static_cast<long long>(timer.nsecsElapsed() / 1000);
+
+        QMetaObject::invokeMethod(this, [this, target, out]() {
+            --pending;
+            ++served;
+            if (target) reply(target, out);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void HyperbolicityServer::reply(QIODevice* socket, const QJsonObject& response) {
+    socket->write(QJsonDocument(response).toJson(QJsonDocument::Compact));
+    socket->write("\n");
+}
+
+QJsonObject HyperbolicityServer::statistics() {
+    QJsonObject stats;
+    stats["workers"] = options.workers;
+    stats["threads_per_worker"] = threadsPerWorker;
+    stats["max_pending"] = options.max_pending;
+    stats["pending"] = pending;
+    stats["served"] = served;
+    stats["rejected"] = rejected;
+    {
+        QMutexLocker locker(&budgetMutex);
+        if (std::isfinite(budgetBytes)) stats["memory_budget_mb"] = budgetBytes / MEGABYTE;
+        stats["memory_reserved_mb"] = reservedBytes / MEGABYTE;
+    }
+
+    QJsonArray list;
+    QMutexLocker locker(&graphsMutex);
+    for (auto it = graphs.constBegin(); it != graphs.constEnd(); ++it) {
+        // A graph being edited is reported without waiting for the edit
+        LoadedGraph& loaded = *it.value();
+        if (!loaded.lock.tryLockForRead()) {
+            QJsonObject busy;
+            busy["graph"] = it.key();
+            busy["path"] = loaded.path;
+            list.append(busy);
+            continue;
+        }
+        list.append(graphSummary(it.key(), loaded));
+        loaded.lock.unlock();
+    }
+    stats["graphs"] = list;
+    return stats;
+}
+
+static QJsonObject graphSummary(const QString& name, const HyperbolicityServer::LoadedGraph& loaded) {
+    QJsonObject summary;
+    summary["graph"] = name;
+    summary["path"] = loaded.path;
+    summary["vertices"] = static_cast<int>(loaded.graph->nodes.size());
+    long long entries = 0;
+    for (const auto& neighbours : loaded.adj_list) entries += neighbours.size();
+    summary["edges"] = entries / 2;   // Every edge is stored in both directions
+    return summary;
+}
+
+std::shared_ptr<HyperbolicityServer::LoadedGraph> HyperbolicityServer::findGraph(const QString& name) {
+    QMutexLocker locker(&graphsMutex);
+    std::shared_ptr<LoadedGraph> loaded = graphs.value(name);
+    if (!loaded) {
+        throw std::invalid_argument(QString("Graph \"%1\" is not loaded").arg(name).toStdString());
+    }
+    return loaded;
+}
+
+double HyperbolicityServer::reserveMemory(LoadedGraph& loaded, const QString& method, ComputeOptions& options) {
+    // Built before taking the budget lock, so planning under it is cheap
+    loaded.cache.forGraph(loaded.graph.get(), options.vertex_order);
+
+    QMutexLocker locker(&budgetMutex);
+    const double left = budgetBytes - reservedBytes;
+    ComputeOptions planned = options;
+    if (method == "Auto") {
+        const double limit = options.memory_budget_mb > 0 ? std::min(options.memory_budget_mb * MEGABYTE, left) : left;
+        if (!(limit > 0)) throw ServerBusy("Memory budget in use by other computes, retry later");
+        planned.memory_budget_mb = limit / MEGABYTE;
+    }
+    const ComputePlan plan = planComputation(loaded.graph.get(), planned, &loaded.cache);
+
+    double bytes = -1.0;
+    if (method == "Auto") {
+        if (plan.chosen < 0) {
+            if (reservedBytes > 0) throw ServerBusy("No method fits in the memory left, retry later");
+            throw std::runtime_error("No method fits in the memory budget.");
+        }
+        bytes = plan.candidates[plan.chosen].bytes;
+        // computeHyperbolicity plans again and picks the same candidate
+        options.memory_budget_mb = planned.memory_budget_mb;
+    } else {
+        // Local runs cut their balls from the same matrix as the exact method
+        const QString engine = method.startsWith("Local Hyperbolicity") ? QString("Exact Algorithm") : method;
+        for (const PlanCandidate& candidate : plan.candidates) {
+            if (candidate.method == engine && (engine != "Log Approximation" ||
+                                               candidate.use_distance_oracle == options.use_distance_oracle)) {
+                bytes = candidate.bytes;
+            }
+        }
+        if (bytes > budgetBytes) {
+            throw std::runtime_error(QString("%1 needs about %2 MB, more than the server's memory budget")
+                                         .arg(method).arg(bytes / MEGABYTE, 0, 'f', 0).toStdString());
+        }
+        if (bytes > left) throw ServerBusy("Not enough memory left for this compute, retry later");
+    }
+    bytes = std::max(0.0, bytes);
+    reservedBytes += bytes;
+    return bytes;
+}
+
+void HyperbolicityServer::releaseMemory(double bytes) {
+    QMutexLocker locker(&budgetMutex);
+    reservedBytes = std::max(0.0, reservedBytes - bytes);
+}
+
+// --- Requests ---
+QJsonObject HyperbolicityServer::load(const QJsonObject& request) {
+    const QString path = QFileInfo(requiredString(request, "path")).absoluteFilePath();
+    const QString name = request.value("graph").toString(path);
+
+    if (!request.value("reload").toBool()) {
+        QMutexLocker locker(&graphsMutex);
+        std::shared_ptr<LoadedGraph> existing = graphs.value(name);
+        if (existing && existing->path == path) {
+            locker.unlock();
+            QReadLocker read(&existing->lock);
+            QJsonObject summary = graphSummary(name, *existing);
+            summary["cached"] = true;
+            return summary;
+        }
+    }
+
+    auto loaded = std::make_shared<LoadedGraph>();
+    loaded->path = path;
+    loaded->graph.reset(loadGraph(path));
+    loaded->reindex();
+    QJsonObject summary = graphSummary(name, *loaded);
+    summary["cached"] = false;
+
+    QMutexLocker locker(&graphsMutex);
+    graphs.insert(name, loaded);
+    return summary;
+}
+
+QJsonObject HyperbolicityServer::compute(const QJsonObject& request) {
+    std::shared_ptr<LoadedGraph> loaded = findGraph(requiredString(request, "graph"));
+    const QString method = request.value("method").toString("Auto");
+    if (!SERVED_METHODS.contains(method)) {
+        throw std::invalid_argument(QString("Unknown method \"%1\"").arg(method).toStdString());
+    }
+    const QJsonObject optionsJson = request.value("options").toObject();
+    const bool incremental = request.value("incremental").toBool();
+    if (incremental && !DynamicSession::supports(method)) {
+        throw std::invalid_argument("Incremental updates support the exact and Factor-2 methods only");
+    }
+    // Object keys are kept sorted, so equal options give equal keys
+    const QString key = method + (incremental ? "\n+\n" : "\n-\n") +
+                        QString::fromUtf8(QJsonDocument(optionsJson).toJson(QJsonDocument::Compact));
+
+    QReadLocker read(&loaded->lock);
+    QJsonObject response;
+    response["graph"] = request.value("graph");
+    {
+        QMutexLocker locker(&loaded->resultsMutex);
+        auto it = loaded->results.constFind(key);
+        if (it != loaded->results.constEnd()) {
+            response["cached"] = true;
+            response["result"] = it.value();
+            return response;
+        }
+    }
+
+    QMutexLocker cacheLocker(&loaded->cacheMutex);
+    {
+        // Another worker may have finished the same request meanwhile
+        QMutexLocker locker(&loaded->resultsMutex);
+        auto it = loaded->results.constFind(key);
+        if (it != loaded->results.constEnd()) {
+            response["cached"] = true;
+            response["result"] = it.value();
+            return response;
+        }
+    }
+
+    ComputeOptions options = computeOptionsFromJson(optionsJson);
+    // Memory charged by the run below, released however it ends
+    struct Reservation {
+        HyperbolicityServer* server;
+        double bytes;
+        ~Reservation() { server->releaseMemory(bytes); }
+    } reservation{this, 0.0};
+    HyperResult result;
+    if (incremental) {
+        if (!loaded->session || loaded->sessionKey != key) {
+            reservation.bytes = reserveMemory(*loaded, method, options);
+            loaded->session.reset();
+            loaded->session = std::make_unique<DynamicSession>(loaded->graph.get(), method, options);
+            loaded->sessionKey = key;
+        }
+        result = loaded->session->result();
+    } else {
+        reservation.bytes = reserveMemory(*loaded, method, options);
+        result = computeHyperbolicity(loaded->graph.get(), method, loaded->path, options, &loaded->cache);
+    }
+    cacheLocker.unlock();
+
+    const QJsonObject line = QJsonDocument::fromJson(resultJsonLine(result, loaded->path)).object();
+    {
+        QMutexLocker locker(&loaded->resultsMutex);
+        loaded->results.insert(key, line);
+    }
+    response["cached"] = false;
+    response["result"] = line;
+    return response;
+}
+
+QJsonObject HyperbolicityServer::edit(const QJsonObject& request) {
+    std::shared_ptr<LoadedGraph> loaded = findGraph(requiredString(request, "graph"));
+    QVector<Edge> edits;
+    for (const QJsonValue& value : request.value("edges").toArray()) {
+        const QJsonObject edge = value.toObject();
+        Edge e{requiredString(edge, "source"), requiredString(edge, "target"), INF};
+        // A missing or null weight removes the edge
+        if (!edge.value("weight").isNull() && !edge.value("weight").isUndefined()) {
+            e.weight = edge.value("weight").toDouble(-1.0);
+            if (!(e.weight >= 0.0) || std::isinf(e.weight)) {
+                throw std::invalid_argument("Edge weights must be finite and non-negative");
+            }
+        }
+        if (e.source == e.target) throw std::invalid_argument("Self-loops are not supported");
+        edits.append(e);
+    }
+    if (edits.isEmpty()) throw std::invalid_argument("Missing \"edges\"");
+
+    // Computes hold the read lock for their whole run. Waiting here would
+    // also stall every later request on the graph behind this writer.
+    if (!loaded->lock.tryLockForWrite()) {
+        throw ServerBusy("Graph is in use by a compute, retry the edit later");
+    }
+    struct Unlock {
+        QReadWriteLock& lock;
+        ~Unlock() { lock.unlock(); }
+    } unlock{loaded->lock};
+    QMutexLocker cacheLocker(&loaded->cacheMutex);
+    QJsonObject response;
+    if (loaded->session) {
+        // The session repairs its distances and delta_r in place
+        const HyperResult& result = loaded->session->applyEdits(edits);
+        response["result"] = QJsonDocument::fromJson(resultJsonLine(result, loaded->path)).object();
+    } else {
+        for (const Edge& e : edits) loaded->graph->setEdge(e.source, e.target, e.weight);
+    }
+    loaded->cache.invalidate();
+    loaded->reindex();
+    {
+        QMutexLocker locker(&loaded->resultsMutex);
+        loaded->results.clear();
+    }
+
+    QJsonObject summary = graphSummary(request.value("graph").toString(), *loaded);
+    for (auto it = summary.begin(); it != summary.end(); ++it) response.insert(it.key(), it.value());
+    return response;
+}
+
+QJsonObject HyperbolicityServer::distance(const QJsonObject& request) {
+    std::shared_ptr<LoadedGraph> loaded = findGraph(requiredString(request, "graph"));
+    const QString source = requiredString(request, "source");
+
+    QReadLocker read(&loaded->lock);
+    const int s = nodeIndex(*loaded, source);
+    std::vector<int> targets;
+    for (const QJsonValue& value : request.value("targets").toArray()) {
+        targets.push_back(nodeIndex(*loaded, value.toString()));
+    }
+
+    // Rows of earlier runs when the cache is free; a compute holding it for
+    // minutes must not stall queries, which then cost one Dijkstra run
+    std::vector<double> row;
+    bool cached = false;
+    if (loaded->cacheMutex.tryLock()) {
+        cached = cachedDistanceRow(loaded->graph.get(), s, loaded->cache, row);
+        loaded->cacheMutex.unlock();
+    }
+    if (!cached) row = ShortestPath(loaded->adj_list).compute_single_source(s);
+
+    QJsonObject distances;
+    if (targets.empty()) {
+        for (int v = 0; v < static_cast<int>(row.size()); ++v) {
+            distances.insert(loaded->graph->nodes[v], distanceValue(row[v]));
+        }
+    } else {
+        for (int t : targets) distances.insert(loaded->graph->nodes[t], distanceValue(row[t]));
+    }
+
+    QJsonObject response;
+    response["graph"] = request.value("graph");
+    response["source"] = source;
+    response["cached"] = cached;
+    response["distances"] = distances;
+    return response;
+}
+
+int runServer(const QStringList& arguments) {
+    ServerOptions options;
+    for (int a = 1; a < arguments.size(); ++a) {
+        const QString& flag = arguments[a];
+        const bool hasValue = a + 1 < arguments.size() && !arguments[a + 1].startsWith("--");
+        if (flag == "--serve") {
+            if (hasValue) options.name = arguments[++a];
+        } else if (flag == "--port" && hasValue) {
+            options.port = arguments[++a].toInt();
+        } else if (flag == "--token-file" && hasValue) {
+            QFile file(arguments[++a]);
+            if (!file.open(QIODevice::ReadOnly)) {
+                std::cerr << "Cannot read token file: " << file.errorString().toStdString() << std::endl;
+                return 1;
+            }
+            options.token = file.readLine().trimmed();
+        } else if (flag == "--memory-mb" && hasValue) {
+            options.memory_mb = arguments[++a].toDouble();
+        } else if (flag == "--workers" && hasValue) {
+            options.workers = arguments[++a].toInt();
+        } else if (flag == "--max-pending" && hasValue) {
+            options.max_pending = arguments[++a].toInt();
+        } else {
+            std::cerr << "Usage: hyperbolicity --serve [NAME] [--port N --token-file FILE] [--workers N]"
+                         " [--max-pending N] [--memory-mb N]" << std::endl;
+            return 2;
+        }
+    }
+
+    HyperbolicityServer server(options);
+    QString error;
+    if (!server.listen(&error)) {
+        std::cerr << "Cannot start server: " << error.toStdString() << std::endl;
+        return 1;
+    }
+    return QCoreApplication::exec();
+}
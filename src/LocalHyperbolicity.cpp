@@ -0,0 +1,209 @@
+#include "LocalHyperbolicity.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+#include <omp.h>
+
+// Balls at least this large run one at a time with every thread on the
+// kernels; smaller ones are spread across threads, one ball per thread.
+constexpr size_t PARALLEL_BALL_SIZE = 512;
+
+// Bases evaluated in one batched pass: up to MAX_BALL_BATCH, as long as
+// their Gromov product planes stay within BALL_BATCH_BYTES
+constexpr int MAX_BALL_BATCH = 8;
+constexpr size_t BALL_BATCH_BYTES = size_t(64) << 20;
+
+LocalHyperbolicity::LocalHyperbolicity(const std::vector<std::vector<double>>& dist_matrix,
+                                       const std::vector<std::vector<std::pair<int, double>>>& adj_list)
+    : distances(dist_matrix.size()), adj_list(adj_list) {
+    if (dist_matrix.size() != adj_list.size()) {
+        throw std::invalid_argument("LocalHyperbolicity: distance matrix and graph differ in size.");
+    }
+    for (size_t i = 0; i < dist_matrix.size(); ++i) distances[i] = dist_matrix[i].data();
+}
+
+LocalHyperbolicity::LocalHyperbolicity(const double* dist_matrix,
+                                       const std::vector<std::vector<std::pair<int, double>>>& adj_list)
+    : distances(adj_list.size()), adj_list(adj_list) {
+    const size_t n = adj_list.size();
+    for (size_t i = 0; i < n; ++i) distances[i] = dist_matrix + i * n;
+}
+
+std::vector<int> LocalHyperbolicity::ball(int center, const LocalOptions& options,
+                                          std::vector<int>& seen, int stamp) const {
+    std::vector<int> members;
+    if (options.kind == BallKind::Radius) {
+        const double* row = distances[center];
+        for (size_t u = 0; u < distances.size(); ++u) {
+            if (row[u] <= options.size) members.push_back(u);
+        }
+        return members;
+    }
+
+    // Breadth-first, level by level, up to the hop limit
+    const int hops = static_cast<int>(std::floor(options.size));
+    members.push_back(center);
+    seen[center] = stamp;
+    size_t level_begin = 0;
+    for (int h = 0; h < hops && level_begin < members.size(); ++h) {
+        const size_t level_end = members.size();
+        for (size_t q = level_begin; q < level_end; ++q) {
+            for (const auto& [v, weight] : adj_list[members[q]]) {
+                if (seen[v] != stamp) {
+                    seen[v] = stamp;
+                    members.push_back(v);
+                }
+            }
+        }
+        level_begin = level_end;
+    }
+    std::sort(members.begin(), members.end());
+    return members;
+}
+
+LocalHyperbolicity::BallValue LocalHyperbolicity::evaluate(const std::vector<int>& ball, int center,
+                                                           const LocalOptions& options) const {
+    BallValue value;
+    const int m = ball.size();
+    // Three points or fewer always satisfy the four-point condition with delta 0
+    if (m < 4) return value;
+
+    // The ball's block of the global matrix, and eccentricities within the ball
+    std::vector<double> block(static_cast<size_t>(m) * m);
+    std::vector<double> eccentricity(m, 0.0);
+    int local_center = 0;
+    for (int a = 0; a < m; ++a) {
+        const double* row = distances[ball[a]];
+        double* out = &block[static_cast<size_t>(a) * m];
+        for (int b = 0; b < m; ++b) {
+            out[b] = row[ball[b]];
+            eccentricity[a] = std::max(eccentricity[a], out[b]);
+        }
+        if (ball[a] == center) local_center = a;
+    }
+
+    HyperbolicityCalculator calc(block.data(), m);
+    calc.set_max_min_backend(options.max_min_backend);
+    calc.set_matrix_memory(options.memory);
+
+    BaseWitness witness;
+    const double delta_center = calc.compute_for_base(local_center, &witness);
+    value.delta = delta_center;
+    value.bases = 1;
+    // delta <= 2 * delta_r for any base r
+    const double bound = 2 * delta_center;
+
+    // Every quadruple through r has delta <= d(r, x) / 2 for one of its
+    // vertices x, so delta_r <= ecc(r) / 2. Bases in decreasing eccentricity
+    // meet large deltas early, and the first one with ecc(r) / 2 <= delta
+    // ends the search.
+    std::vector<int> order;
+    order.reserve(m - 1);
+    for (int a = 0; a < m; ++a) {
+        if (a != local_center) order.push_back(a);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return eccentricity[a] > eccentricity[b]; });
+
+    const size_t plane_bytes = 2 * sizeof(double) * static_cast<size_t>(m) * m;
+    const int batch = static_cast<int>(std::clamp<size_t>(BALL_BATCH_BYTES / plane_bytes, 1, MAX_BALL_BATCH));
+    std::vector<BaseWitness> batch_witnesses;
+    size_t next = 0;
+    while (next < order.size() && value.delta < bound && eccentricity[order[next]] / 2 > value.delta) {
+        std::vector<int> bases;
+        for (; next < order.size() && bases.size() < static_cast<size_t>(batch) &&
+               eccentricity[order[next]] / 2 > value.delta; ++next) {
+            bases.push_back(order[next]);
+        }
+        std::vector<double> deltas = calc.compute_for_bases(bases, &batch_witnesses);
+        value.bases += bases.size();
+        for (size_t b = 0; b < bases.size(); ++b) {
+            if (deltas[b] > value.delta) {
+                value.delta = deltas[b];
+                witness = batch_witnesses[b];
+            }
+        }
+    }
+
+    if (value.delta > 0.0) {
+        value.witness = BaseWitness{ball[witness.r], ball[witness.i], ball[witness.j], ball[witness.k]};
+    }
+    return value;
+}
+
+LocalProfile LocalHyperbolicity::compute(const LocalOptions& options) const {
+    if (options.size < 0 || std::isnan(options.size)) {
+        throw std::invalid_argument("LocalHyperbolicity: ball size must be non-negative.");
+    }
+    const int n = distances.size();
+    LocalProfile profile;
+    profile.delta.assign(n, 0.0);
+    profile.ball_size.assign(n, 0);
+    profile.witness.assign(n, BaseWitness{});
+    if (n == 0) return profile;
+
+    // --- Balls ---
+    std::vector<std::vector<int>> balls(n);
+    #pragma omp parallel
+    {
+        std::vector<int> seen(options.kind == BallKind::Hops ? n : 0, -1);
+        #pragma omp for schedule(dynamic, 64)
+        for (int v = 0; v < n; ++v) {
+            balls[v] = ball(v, options, seen, v);
+            profile.ball_size[v] = balls[v].size();
+        }
+    }
+
+    // Vertices with equal balls next to each other; each group is one evaluation
+    std::vector<int> by_ball(n);
+    std::iota(by_ball.begin(), by_ball.end(), 0);
+    std::sort(by_ball.begin(), by_ball.end(), [&](int a, int b) {
+        if (balls[a].size() != balls[b].size()) return balls[a].size() > balls[b].size();
+        if (balls[a] != balls[b]) return balls[a] < balls[b];
+        return a < b;
+    });
+    std::vector<int> group_begin;
+    for (int g = 0; g < n; ++g) {
+        if (g == 0 || balls[by_ball[g]] != balls[by_ball[g - 1]]) group_begin.push_back(g);
+    }
+    const int groups = group_begin.size();
+    group_begin.push_back(n);
+    profile.distinct_balls = groups;
+
+    // --- Evaluation, largest balls first ---
+    std::vector<BallValue> values(groups);
+    auto run_group = [&](int g) {
+        int center = by_ball[group_begin[g]];
+        values[g] = evaluate(balls[center], center, options);
+    };
+
+    int g = 0;
+    for (; g < groups && balls[by_ball[group_begin[g]]].size() >= PARALLEL_BALL_SIZE; ++g) {
+        run_group(g);
+    }
+
+    std::exception_ptr failure;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int s = g; s < groups; ++s) {
+        try {
+            run_group(s);
+        } catch (...) {
+            #pragma omp critical
+            failure = std::current_exception();
+        }
+    }
+    if (failure) std::rethrow_exception(failure);
+
+    for (int s = 0; s < groups; ++s) {
+        const int size = balls[by_ball[group_begin[s]]].size();
+        profile.bases_evaluated += values[s].bases;
+        if (size >= 4 && values[s].bases < size) ++profile.settled_early;
+        for (int q = group_begin[s]; q < group_begin[s + 1]; ++q) {
+            profile.delta[by_ball[q]] = values[s].delta;
+            profile.witness[by_ball[q]] = values[s].witness;
+        }
+    }
+    return profile;
+}
@@ -1,4 +1,6 @@
 #include "LogApproximation.h"
+#include "DistanceOracle.h"
+#include "ShortestPath.h"
 #include <vector>
 #include <cmath>
 #include <limits>
@@ -11,6 +13,30 @@
 
 constexpr double INF = std::numeric_limits<double>::infinity();
 
+// Running maximum of |d_G - d_T| with its pair; one per thread, merged at the
+// end. Ties keep the smallest (i, j) so the pair does not depend on scheduling.
+namespace {
+struct Distortion {
+    double value = 0.0;
+    int i = -1;
+    int j = -1;
+
+    void offer(double diff, int a, int b) {
+        if (diff > value || (diff == value && i >= 0 && std::make_pair(a, b) < std::make_pair(i, j))) {
+            value = diff;
+            i = a;
+            j = b;
+        }
+    }
+    void merge(const Distortion& other) {
+        if (other.i >= 0) offer(other.value, other.i, other.j);
+    }
+};
+} // namespace
+
+// Stand-in for the matrix reference in oracle mode
+static const std::vector<std::vector<double>> NO_MATRIX;
+
 // --- MODIFIED Constructor ---
 LogApproxHyperbolicity::LogApproxHyperbolicity(
     const std::vector<std::vector<double>>& dist_matrix,
@@ -22,19 +48,45 @@ LogApproxHyperbolicity::LogApproxHyperbolicity(
         n = 0;
     } else {
         n = distances.size();
-        if (n > 0 && (distances[0].size() != n || original_adj_list.size() != n)) {
+        if (n > 0 && (static_cast<int>(distances[0].size()) != n || static_cast<int>(original_adj_list.size()) != n)) {
              throw std::invalid_argument("LogApproxHyperbolicity: Matrix/Adjacency list size mismatch or not square.");
         }
     }
-     if (n != original_adj_list.size()){
+     if (n != static_cast<int>(original_adj_list.size())){
           throw std::invalid_argument("LogApproxHyperbolicity: Distance matrix size and adjacency list size do not match.");
      }
 }
 
+// --- Oracle Constructor ---
+LogApproxHyperbolicity::LogApproxHyperbolicity(
+    const DistanceOracle& dist_oracle,
+    const std::vector<std::vector<std::pair<int, double>>>& graph_adj_list)
+    : distances(NO_MATRIX),
+      original_adj_list(graph_adj_list),
+      oracle(&dist_oracle),
+      n(graph_adj_list.size())
+{
+    if (dist_oracle.size() != n) {
+        throw std::invalid_argument("LogApproxHyperbolicity: Oracle size and adjacency list size do not match.");
+    }
+}
+
+std::vector<double> LogApproxHyperbolicity::base_distances(int base_node) const {
+    if (oracle) {
+        ShortestPath sp(original_adj_list);
+        return sp.compute_single_source(base_node);
+    }
+    // Ensure distances from base_node are valid
+    if (base_node >= static_cast<int>(distances.size())) {
+         throw std::runtime_error("Base node index out of bounds for distance matrix.");
+    }
+    return distances[base_node];
+}
+
 // --- Chepoi-Dragan Approximation Tree Construction ---
 // Implementation based on "A Note on Distance Approximating Trees in Graphs"
 ApproxTree LogApproxHyperbolicity::construct_approximation_tree() const {
-    if (n == 0) return ApproxTree{0};
+    if (n == 0) return ApproxTree{};
 
     ApproxTree result_tree;
     result_tree.num_nodes = n;
@@ -46,13 +98,10 @@ ApproxTree LogApproxHyperbolicity::construct_approximation_tree() const {
     std::vector<int> node_level(n, -1);
     int max_level = 0;
 
-    // Ensure distances from base_node are valid
-    if (base_node >= distances.size()) {
-         throw std::runtime_error("Base node index out of bounds for distance matrix.");
-    }
+    std::vector<double> base_row = base_distances(base_node);
 
     for (int i = 0; i < n; ++i) {
-        double dist = distances[base_node][i];
+        double dist = base_row[i];
         if (dist == INF || dist < 0) {
              // Handle disconnected graph or invalid distances if necessary
              // For now, assume graph is connected and distances are valid
@@ -60,7 +109,7 @@ ApproxTree LogApproxHyperbolicity::construct_approximation_tree() const {
              continue; // Skip nodes unreachable from base_node
         }
         int level = static_cast<int>(std::round(dist)); // Use distances from base node for levels
-        if (level >= levels.size()) {
+        if (level >= static_cast<int>(levels.size())) {
             levels.resize(level + 1);
         }
         levels[level].push_back(i);
@@ -95,7 +144,7 @@ ApproxTree LogApproxHyperbolicity::construct_approximation_tree() const {
                     current_component.push_back(u);
 
                      // Bounds check for original_adj_list
-                     if (u < 0 || u >= original_adj_list.size()) continue;
+                     if (u < 0 || u >= static_cast<int>(original_adj_list.size())) continue;
 
                     // Explore neighbors *within the same level k*
                     for (const auto& edge : original_adj_list[u]) {
@@ -129,13 +178,13 @@ ApproxTree LogApproxHyperbolicity::construct_approximation_tree() const {
     std::vector<std::map<int, int>> component_parent_rep(max_level + 1);
 
     for (int k = 1; k <= max_level; ++k) {
-        for (int comp_idx = 0; comp_idx < levels_components[k].size(); ++comp_idx) {
+        for (size_t comp_idx = 0; comp_idx < levels_components[k].size(); ++comp_idx) {
             int parent_rep = -1;
             bool parent_found = false;
             // Find the parent component representative in level k-1
             for (int node_in_comp : levels_components[k][comp_idx]) {
                  // Bounds check
-                 if (node_in_comp < 0 || node_in_comp >= original_adj_list.size()) continue;
+                 if (node_in_comp < 0 || node_in_comp >= static_cast<int>(original_adj_list.size())) continue;
 
                 for (const auto& edge : original_adj_list[node_in_comp]) {
                     int neighbor = edge.first;
@@ -176,7 +225,7 @@ ApproxTree LogApproxHyperbolicity::construct_approximation_tree() const {
         }
          // Connect components within level 0 (should only be one if graph connected from base_node)
          if (k == 1) {
-              for(int comp_idx_k0 = 0; comp_idx_k0 < levels_components[0].size(); ++comp_idx_k0){
+              for(size_t comp_idx_k0 = 0; comp_idx_k0 < levels_components[0].size(); ++comp_idx_k0){
                    int rep_k0 = component_representatives[0][comp_idx_k0];
                     for (int node_in_comp_k0 : levels_components[0][comp_idx_k0]) {
                          if (node_in_comp_k0 != rep_k0 && rep_k0 != -1) {
@@ -200,7 +249,7 @@ std::vector<double> LogApproxHyperbolicity::bfs_tree(int source, const ApproxTre
     if (source < 0 || source >= tree.num_nodes) {
         throw std::out_of_range("LogApproxHyperbolicity::bfs_tree: Source node index out of range.");
     }
-    if (tree.adj_list.size() != tree.num_nodes) {
+    if (static_cast<int>(tree.adj_list.size()) != tree.num_nodes) {
          throw std::runtime_error("LogApproxHyperbolicity::bfs_tree: Tree adjacency list size mismatch.");
     }
 
@@ -221,7 +270,7 @@ std::vector<double> LogApproxHyperbolicity::bfs_tree(int source, const ApproxTre
         q.pop();
 
         // Check bounds for adjacency list access
-         if (u < 0 || u >= tree.adj_list.size()) {
+         if (u < 0 || u >= static_cast<int>(tree.adj_list.size())) {
              std::cerr << "Warning: Invalid node index " << u << " encountered during BFS." << std::endl;
              continue; // Skip this invalid node
          }
@@ -272,36 +321,72 @@ double LogApproxHyperbolicity::compute_approximate_hyperbolicity() {
      }
 
     // 1. Construct the approximation tree T
-    ApproxTree approx_tree = construct_approximation_tree(); // Calls the *new* implementation
+    return compute_approximate_hyperbolicity(construct_approximation_tree());
+}
 
+double LogApproxHyperbolicity::compute_approximate_hyperbolicity(const ApproxTree& approx_tree) {
+    if (n <= 1) {
+        return 0.0;
+    }
 
      // Basic check after construction
       if (approx_tree.num_nodes != n) {
            throw std::runtime_error("LogApproxHyperbolicity: Constructed tree node count does not match original graph.");
       }
 
+    if (oracle) {
+        return std::max(0.0, 4.0 * max_distortion_from_oracle(approx_tree, witness_pair));
+    }
+
     // 2. Compute all-pairs shortest paths (edge counts) within the tree T
     std::vector<std::vector<double>> tree_distances = compute_tree_distances(approx_tree);
+    if (distances.size() != static_cast<size_t>(n) || tree_distances.size() != static_cast<size_t>(n)) {
+        throw std::out_of_range("LogApproxHyperbolicity: Index out of bounds when comparing distances.");
+    }
 
     // 3. Find the maximum absolute difference 'm' between graph distances and tree distances
-    double max_diff = 0.0;
-    for (int i = 0; i < n; ++i) {
-        for (int j = 0; j < n; ++j) {
-             // Bounds check
-             if (i >= distances.size() || j >= distances[i].size() ||
-                 i >= tree_distances.size() || j >= tree_distances[i].size()) {
-                   throw std::out_of_range("LogApproxHyperbolicity: Index out of bounds when comparing distances.");
-             }
-
-            double dist_g = distances[i][j];
-            double dist_t = tree_distances[i][j];
-
-            if (dist_g != INF && dist_t != INF) {
-                 max_diff = std::max(max_diff, std::abs(dist_g - dist_t));
+    Distortion worst;
+    #pragma omp parallel
+    {
+        Distortion local;
+        #pragma omp for schedule(static) nowait
+        for (int i = 0; i < n; ++i) {
+            for (int j = i + 1; j < n; ++j) {
+                double dist_g = distances[i][j];
+                double dist_t = tree_distances[i][j];
+                if (dist_g != INF && dist_t != INF) local.offer(std::abs(dist_g - dist_t), i, j);
             }
         }
+        #pragma omp critical
+        worst.merge(local);
     }
+    witness_pair = {worst.i, worst.j};
 
     // 4. Return 4 * m as the approximation
-    return std::max(0.0, 4.0 * max_diff);
-}
\ No newline at end of file
+    return std::max(0.0, 4.0 * worst.value);
+}
+
+// --- Streaming comparison against the oracle ---
+double LogApproxHyperbolicity::max_distortion_from_oracle(const ApproxTree& tree,
+                                                          std::pair<int, int>& pair) const {
+    Distortion worst;
+
+    #pragma omp parallel
+    {
+        Distortion local;
+        #pragma omp for schedule(dynamic, 16) nowait
+        for (int i = 0; i < n; ++i) {
+            std::vector<double> tree_row = bfs_tree(i, tree);
+            for (int j = i + 1; j < n; ++j) {
+                double dist_t = tree_row[j];
+                if (dist_t == INF) continue;
+                double dist_g = oracle->query(i, j);
+                if (dist_g != INF) local.offer(std::abs(dist_g - dist_t), i, j);
+            }
+        }
+        #pragma omp critical
+        worst.merge(local);
+    }
+    pair = {worst.i, worst.j};
+    return worst.value;
+}
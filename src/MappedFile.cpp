@@ -0,0 +1,48 @@
+#include "MappedFile.h"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HYP_HAVE_MMAP 1
+#endif
+
+namespace fs = std::filesystem;
+
+MappedFile::MappedFile(const std::string& path) {
+    std::error_code ec;
+    const auto size = fs::file_size(path, ec);
+    if (ec) throw std::runtime_error("Cannot open " + path);
+    length = static_cast<size_t>(size);
+    if (length == 0) return;
+#ifdef HYP_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+            madvise(p, length, MADV_SEQUENTIAL);
+#endif
+            mapping = p;
+            data = static_cast<const char*>(p);
+            return;
+        }
+    }
+#endif
+    std::ifstream in(path, std::ios::binary);
+    fallback.resize(length);
+    in.read(&fallback[0], length);
+    if (!in) throw std::runtime_error("Cannot read " + path);
+    data = fallback.data();
+}
+
+MappedFile::~MappedFile() {
+#ifdef HYP_HAVE_MMAP
+    if (mapping) munmap(mapping, length);
+#endif
+}
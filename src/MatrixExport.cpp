@@ -0,0 +1,200 @@
+#include "MatrixExport.h"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+// Integers below this survive the round trip through int64 exactly
+constexpr double EXACT_INTEGER_LIMIT = 9007199254740992.0;   // 2^53
+
+// --- Row coding ---
+// Each value becomes one LEB128 varint token, read in this order:
+//   0            +infinity (other component)
+//   odd          integral value: (zigzag(value - previous integral value) << 1) | 1
+//   2            anything else; the 8 bytes of the double follow, little endian
+// Hop-count and integer-weighted distances along a row differ little from
+// their neighbours, so most of them take one or two bytes instead of eight.
+namespace {
+
+void put_varint(std::vector<unsigned char>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+void put_le(std::vector<unsigned char>& out, std::uint64_t value, int bytes) {
+    for (int b = 0; b < bytes; ++b) out.push_back(static_cast<unsigned char>(value >> (8 * b)));
+}
+
+bool get_varint(const unsigned char*& p, const unsigned char* end, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        unsigned char byte = *p++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+std::uint64_t get_le(const unsigned char* p, int bytes) {
+    std::uint64_t value = 0;
+    for (int b = 0; b < bytes; ++b) value |= static_cast<std::uint64_t>(p[b]) << (8 * b);
+    return value;
+}
+
+void encode_row(const double* row, int n, std::vector<unsigned char>& out) {
+    std::int64_t previous = 0;
+    for (int j = 0; j < n; ++j) {
+        double x = row[j];
+        if (x == INF) {
+            out.push_back(0);
+        } else if (x >= 0.0 && x < EXACT_INTEGER_LIMIT && x == std::floor(x)) {
+            std::int64_t delta = static_cast<std::int64_t>(x) - previous;
+            std::uint64_t zigzag = (static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63);
+            put_varint(out, (zigzag << 1) | 1);
+            previous = static_cast<std::int64_t>(x);
+        } else {
+            std::uint64_t bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            out.push_back(2);
+            put_le(out, bits, 8);
+        }
+    }
+}
+
+void decode_row(const unsigned char* p, const unsigned char* end, int n, double* row) {
+    std::int64_t previous = 0;
+    for (int j = 0; j < n; ++j) {
+        std::uint64_t token;
+        if (!get_varint(p, end, token)) throw std::runtime_error("Corrupt distance matrix row");
+        if (token == 0) {
+            row[j] = INF;
+        } else if (token & 1) {
+            std::uint64_t zigzag = token >> 1;
+            std::int64_t delta = static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+            previous += delta;
+            row[j] = static_cast<double>(previous);
+        } else if (token == 2 && end - p >= 8) {
+            std::uint64_t bits = get_le(p, 8);
+            std::memcpy(&row[j], &bits, sizeof(bits));
+            p += 8;
+        } else {
+            throw std::runtime_error("Corrupt distance matrix row");
+        }
+    }
+    if (p != end) throw std::runtime_error("Corrupt distance matrix row");
+}
+
+} // namespace
+
+// --- Writer ---
+DistanceMatrixWriter::DistanceMatrixWriter(const std::string& path, int n, MatrixFormat format)
+    : path(path), tmp_path(path + ".tmp"), n(n), format(format), written(n, 0) {
+    if (n < 0) throw std::invalid_argument("DistanceMatrixWriter: negative size.");
+    out.open(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot write " + tmp_path);
+
+    std::uint64_t count = n;
+    out.write(format == MatrixFormat::Raw ? RAW_MATRIX_MAGIC : COMPRESSED_MATRIX_MAGIC, sizeof(RAW_MATRIX_MAGIC));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    bytes = MATRIX_HEADER_BYTES;
+}
+
+DistanceMatrixWriter::~DistanceMatrixWriter() {
+    if (!finished) {
+        out.close();
+        std::error_code ec;
+        fs::remove(tmp_path, ec);
+    }
+}
+
+void DistanceMatrixWriter::write_row(int i, const double* row) {
+    if (i < 0 || i >= n) throw std::out_of_range("DistanceMatrixWriter: row index out of range.");
+
+    if (format == MatrixFormat::Raw) {
+        // Every row has a fixed place, so rows are written where they belong
+        const size_t row_bytes = static_cast<size_t>(n) * sizeof(double);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (written[i]) throw std::logic_error("DistanceMatrixWriter: row written twice.");
+        out.seekp(static_cast<std::streamoff>(MATRIX_HEADER_BYTES + static_cast<size_t>(i) * row_bytes));
+        out.write(reinterpret_cast<const char*>(row), row_bytes);
+        written[i] = 1;
+        bytes += row_bytes;
+        return;
+    }
+
+    // Encoded by the calling thread; only the append is serialised
+    std::vector<unsigned char> frame;
+    frame.reserve(8 + static_cast<size_t>(n) * 2);
+    frame.resize(8);
+    encode_row(row, n, frame);
+    const std::uint64_t payload = frame.size() - 8;
+    for (int b = 0; b < 4; ++b) {
+        frame[b] = static_cast<unsigned char>(static_cast<std::uint32_t>(i) >> (8 * b));
+        frame[4 + b] = static_cast<unsigned char>(payload >> (8 * b));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (written[i]) throw std::logic_error("DistanceMatrixWriter: row written twice.");
+    out.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+    written[i] = 1;
+    bytes += frame.size();
+}
+
+void DistanceMatrixWriter::finish() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int i = 0; i < n; ++i) {
+        if (!written[i]) throw std::logic_error("DistanceMatrixWriter: row " + std::to_string(i) + " missing.");
+    }
+    out.close();
+    if (!out) throw std::runtime_error("Cannot write " + tmp_path);
+    fs::rename(tmp_path, path);
+    finished = true;
+}
+
+// --- Reader ---
+std::vector<std::vector<double>> read_distance_matrix(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(RAW_MATRIX_MAGIC)];
+    std::uint64_t count = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!in) throw std::runtime_error("Not a distance matrix file: " + path);
+    const int n = static_cast<int>(count);
+    std::vector<std::vector<double>> matrix(n);
+
+    if (std::memcmp(magic, RAW_MATRIX_MAGIC, sizeof(magic)) == 0) {
+        for (int i = 0; i < n; ++i) {
+            matrix[i].resize(n);
+            in.read(reinterpret_cast<char*>(matrix[i].data()), static_cast<size_t>(n) * sizeof(double));
+        }
+        if (!in) throw std::runtime_error("Truncated distance matrix file: " + path);
+        return matrix;
+    }
+    if (std::memcmp(magic, COMPRESSED_MATRIX_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a distance matrix file: " + path);
+    }
+
+    std::vector<unsigned char> payload;
+    for (int rows = 0; rows < n; ++rows) {
+        unsigned char head[8];
+        in.read(reinterpret_cast<char*>(head), sizeof(head));
+        if (!in) throw std::runtime_error("Truncated distance matrix file: " + path);
+        const std::uint64_t i = get_le(head, 4);
+        payload.resize(get_le(head + 4, 4));
+        in.read(reinterpret_cast<char*>(payload.data()), payload.size());
+        if (!in || i >= count || !matrix[i].empty()) {
+            throw std::runtime_error("Corrupt distance matrix file: " + path);
+        }
+        matrix[i].resize(n);
+        decode_row(payload.data(), payload.data() + payload.size(), n, matrix[i].data());
+    }
+    return matrix;
+}
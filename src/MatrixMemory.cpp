@@ -0,0 +1,295 @@
+#include "MatrixMemory.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <omp.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// x86-64 and aarch64 (4 KB granule) PMD size; smaller buffers stay on the heap
+constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+
+namespace {
+
+std::atomic<size_t> huge_bytes{0};
+
+#ifdef __linux__
+// Start and length of each huge-page mapping, keyed by the pointer handed out
+struct Mapping {
+    void* base;
+    size_t length;
+    std::shared_ptr<HugePageUsage> usage;   // Run the mapping is charged to, if any
+};
+std::mutex mapping_mutex;
+std::unordered_map<void*, Mapping> mappings;
+
+void record_mapping(void* ptr, void* base, size_t length, const std::shared_ptr<HugePageUsage>& usage) {
+    {
+        std::lock_guard<std::mutex> lock(mapping_mutex);
+        mappings[ptr] = {base, length, usage};
+    }
+    huge_bytes.fetch_add(length);
+    if (usage) {
+        size_t now = usage->bytes.fetch_add(length) + length;
+        size_t peak = usage->peak.load();
+        while (now > peak && !usage->peak.compare_exchange_weak(peak, now)) {}
+    }
+}
+
+size_t round_up(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+// Hugetlb pool first; MAP_FAILED when the pool cannot cover the request
+void* map_explicit(size_t bytes, const std::shared_ptr<HugePageUsage>& usage) {
+#ifdef MAP_HUGETLB
+    size_t length = round_up(bytes, HUGE_PAGE_SIZE);
+    void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_NORESERVE, -1, 0);
+    if (p != MAP_FAILED) record_mapping(p, p, length, usage);
+    return p;
+#else
+    (void)bytes;
+    (void)usage;
+    return MAP_FAILED;
+#endif
+}
+
+// Over-maps by one huge page and trims both ends so that the buffer starts
+// on a huge-page boundary, then advises transparent huge pages
+void* map_transparent(size_t bytes, const std::shared_ptr<HugePageUsage>& usage) {
+    size_t length = round_up(bytes, HUGE_PAGE_SIZE);
+    void* raw = mmap(nullptr, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return MAP_FAILED;
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = round_up(start, HUGE_PAGE_SIZE);
+    if (aligned > start) munmap(raw, aligned - start);
+    size_t tail = (start + length + HUGE_PAGE_SIZE) - (aligned + length);
+    if (tail > 0) munmap(reinterpret_cast<void*>(aligned + length), tail);
+
+    void* p = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    madvise(p, length, MADV_HUGEPAGE);
+#endif
+    record_mapping(p, p, length, usage);
+    return p;
+}
+#endif
+
+} // namespace
+
+void* allocate_matrix_memory(size_t bytes, const MatrixMemoryConfig& config) {
+    if (bytes == 0) bytes = 1;
+#ifdef __linux__
+    if (config.huge_pages && bytes >= HUGE_PAGE_SIZE) {
+        void* p = config.explicit_huge_pages ? map_explicit(bytes, config.usage) : MAP_FAILED;
+        if (p == MAP_FAILED) p = map_transparent(bytes, config.usage);
+        if (p != MAP_FAILED) return p;
+    }
+#endif
+    return ::operator new(bytes);
+}
+
+void free_matrix_memory(void* ptr, size_t bytes) noexcept {
+    if (!ptr) return;
+    (void)bytes;
+#ifdef __linux__
+    // Buffers of any configuration come here, so look the pointer up
+    Mapping mapping{nullptr, 0, nullptr};
+    {
+        std::lock_guard<std::mutex> lock(mapping_mutex);
+        auto it = mappings.find(ptr);
+        if (it != mappings.end()) {
+            mapping = it->second;
+            mappings.erase(it);
+        }
+    }
+    if (mapping.base) {
+        munmap(mapping.base, mapping.length);
+        huge_bytes.fetch_sub(mapping.length);
+        if (mapping.usage) mapping.usage->bytes.fetch_sub(mapping.length);
+        return;
+    }
+#endif
+    ::operator delete(ptr);
+}
+
+size_t huge_page_bytes_in_use() {
+    return huge_bytes.load();
+}
+
+// --- Thread pinning ---
+#ifdef __linux__
+namespace {
+
+std::mutex pin_mutex;
+cpu_set_t process_mask;            // Affinity before any pinning; all OpenMP threads inherit it
+bool have_process_mask = false;
+std::vector<int> cpu_claims;       // Pinned threads per CPU, over every live ThreadPinning
+
+} // namespace
+#endif
+
+ThreadPinning::ThreadPinning(bool pin) {
+#ifdef __linux__
+    if (!pin) return;
+    const int threads = omp_get_max_threads();
+    {
+        std::lock_guard<std::mutex> lock(pin_mutex);
+        if (!have_process_mask) {
+            CPU_ZERO(&process_mask);
+            if (sched_getaffinity(0, sizeof(process_mask), &process_mask) != 0) return;
+            have_process_mask = true;
+            cpu_claims.assign(CPU_SETSIZE, 0);
+        }
+        std::vector<int> allowed;
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &process_mask)) allowed.push_back(c);
+        }
+        if (allowed.empty()) return;
+        // Least claimed CPU for each thread, lowest id on a tie
+        for (int t = 0; t < threads; ++t) {
+            int best = allowed[0];
+            for (int c : allowed) {
+                if (cpu_claims[c] < cpu_claims[best]) best = c;
+            }
+            ++cpu_claims[best];
+            cpus.push_back(best);
+        }
+    }
+
+    saved.assign(static_cast<size_t>(threads) * sizeof(cpu_set_t), 0);
+    #pragma omp parallel num_threads(threads)
+    {
+        const int t = omp_get_thread_num();
+        cpu_set_t* before = reinterpret_cast<cpu_set_t*>(&saved[t * sizeof(cpu_set_t)]);
+        sched_getaffinity(0, sizeof(cpu_set_t), before);
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(cpus[t], &mask);
+        sched_setaffinity(0, sizeof(mask), &mask);
+    }
+#else
+    (void)pin;
+#endif
+}
+
+ThreadPinning::~ThreadPinning() {
+#ifdef __linux__
+    if (cpus.empty()) return;
+    #pragma omp parallel num_threads(static_cast<int>(cpus.size()))
+    {
+        const int t = omp_get_thread_num();
+        sched_setaffinity(0, sizeof(cpu_set_t), reinterpret_cast<cpu_set_t*>(&saved[t * sizeof(cpu_set_t)]));
+    }
+    std::lock_guard<std::mutex> lock(pin_mutex);
+    for (int c : cpus) --cpu_claims[c];
+#endif
+}
+
+// --- Hardware counters ---
+#ifdef __linux__
+static int open_counter(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // pid 0, cpu -1: the calling thread on any CPU
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+static uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+static long long read_counter(int fd) {
+    uint64_t value = 0;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) return 0;
+    return static_cast<long long>(value);
+}
+#endif
+
+MemoryCounters::~MemoryCounters() {
+    close_all();
+}
+
+void MemoryCounters::close_all() {
+#ifdef __linux__
+    for (int fd : tlb_fds) if (fd >= 0) close(fd);
+    for (int fd : node_fds) if (fd >= 0) close(fd);
+    for (int fd : miss_fds) if (fd >= 0) close(fd);
+#endif
+    tlb_fds.clear();
+    node_fds.clear();
+    miss_fds.clear();
+}
+
+void MemoryCounters::start() {
+    close_all();
+    usage->peak.store(usage->bytes.load());
+#ifdef __linux__
+    // Counters are per thread, so every thread of the OpenMP pool opens its
+    // own; the pool threads persist into the parallel loops that follow
+    int threads = omp_get_max_threads();
+    tlb_fds.assign(threads, -1);
+    node_fds.assign(threads, -1);
+    miss_fds.assign(threads, -1);
+    #pragma omp parallel num_threads(threads)
+    {
+        int t = omp_get_thread_num();
+        tlb_fds[t] = open_counter(PERF_TYPE_HW_CACHE,
+            cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+        node_fds[t] = open_counter(PERF_TYPE_HW_CACHE,
+            cache_event(PERF_COUNT_HW_CACHE_NODE, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+        miss_fds[t] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        for (int fd : {tlb_fds[t], node_fds[t], miss_fds[t]}) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+#endif
+}
+
+MemoryMetrics MemoryCounters::stop() {
+    MemoryMetrics metrics;
+    metrics.huge_page_bytes = usage->peak.load();
+#ifdef __linux__
+    bool any = false;
+    for (int fd : tlb_fds) {
+        if (fd < 0) continue;
+        any = true;
+        metrics.tlb_misses += read_counter(fd);
+    }
+    for (int fd : node_fds) {
+        if (fd < 0) continue;
+        any = true;
+        metrics.remote_accesses += read_counter(fd);
+    }
+    for (int fd : miss_fds) {
+        if (fd < 0) continue;
+        any = true;
+        metrics.cache_misses += read_counter(fd);
+    }
+    metrics.available = any;
+#endif
+    close_all();
+    return metrics;
+}
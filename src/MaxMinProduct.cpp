@@ -0,0 +1,259 @@
+#include "MaxMinProduct.h"
+#include "MatrixMemory.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <unordered_set>
+#include <omp.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+// Up to this many distinct values every level is exact; above it values are
+// grouped into quantile buckets.
+constexpr int MAX_EXACT_LEVELS = 512;
+constexpr int BUCKET_LEVELS = 64;
+// Level of a pair with nothing left to look for; every real level is below it
+constexpr std::uint16_t SETTLED = 0xffff;
+static_assert(MAX_EXACT_LEVELS < SETTLED && BUCKET_LEVELS < SETTLED, "levels must fit a uint16_t");
+
+// Auto selection, from single-base timings of bench/maxmin_crossover.cpp
+// (ring plus n/2 chords, one thread; levels = distinct Gromov products):
+//   hops, ~20 levels:        bitset/dense 0.94 at n = 400, 1.12 at 600, 2.6 at 2400
+//   int 1..10, ~100 levels:  0.77 at n = 600, 1.13 at 1200, 2.3 at 2400
+//   real, > 10000 levels:    bucket mode stays behind dense at every n tried
+// The crossover grows about as the square root of the level count, so the
+// threshold kernel is chosen when every level is exact and
+// n >= AUTO_CROSSOVER_PER_ROOT_LEVEL * sqrt(levels) (never below AUTO_CROSSOVER_N).
+constexpr int AUTO_CROSSOVER_N = 400;
+constexpr double AUTO_CROSSOVER_PER_ROOT_LEVEL = 100.0;
+constexpr int AUTO_MAX_LEVELS = MAX_EXACT_LEVELS;
+
+static inline int lowest_bit(std::uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// Distinct finite values in ascending order, or empty if there are more than cap
+static std::vector<double> distinct_values(const std::vector<const double*>& A, int n, int cap) {
+    std::unordered_set<double> seen;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            double v = A[i][j];
+            if (v == -INF) continue;
+            if (seen.insert(v).second && static_cast<int>(seen.size()) > cap) return {};
+        }
+    }
+    std::vector<double> levels(seen.begin(), seen.end());
+    std::sort(levels.begin(), levels.end());
+    return levels;
+}
+
+// Ascending bucket floors taken from quantiles of a sample; the first floor is
+// the global minimum so every finite entry falls into some bucket.
+static std::vector<double> quantile_levels(const std::vector<const double*>& A, int n, int buckets) {
+    double min_val = INF;
+    std::vector<double> sample;
+    const size_t sample_size = 1 << 16;
+    std::mt19937_64 rng(12345);
+    std::uniform_int_distribution<int> pick(0, n - 1);
+
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            if (A[i][j] != -INF) min_val = std::min(min_val, A[i][j]);
+        }
+    }
+    if (min_val == INF) return {};
+
+    for (size_t s = 0; s < sample_size * 4 && sample.size() < sample_size; ++s) {
+        double v = A[pick(rng)][pick(rng)];
+        if (v != -INF) sample.push_back(v);
+    }
+    std::sort(sample.begin(), sample.end());
+
+    std::vector<double> levels = {min_val};
+    for (int b = 1; b < buckets && !sample.empty(); ++b) {
+        double q = sample[sample.size() * b / buckets];
+        if (q > levels.back()) levels.push_back(q);
+    }
+    return levels;
+}
+
+void threshold_max_min_product(const std::vector<const double*>& A, const std::vector<double*>& C, int n,
+                               const MatrixMemoryConfig& memory) {
+    if (n == 0) return;
+
+    // --- 1. Threshold levels ---
+    std::vector<double> levels = distinct_values(A, n, MAX_EXACT_LEVELS);
+    bool exact = true;
+    if (levels.empty()) {
+        levels = quantile_levels(A, n, BUCKET_LEVELS);
+        exact = false;
+    }
+    const int L = levels.size();
+    if (L == 0) {
+        // No finite entries at all
+        for (int i = 0; i < n; ++i) std::fill(C[i], C[i] + n, -INF);
+        return;
+    }
+    auto level_of = [&](double v) {
+        return static_cast<int>(std::upper_bound(levels.begin(), levels.end(), v) - levels.begin()) - 1;
+    };
+
+    // --- 2. Row entries grouped by level (counting sort per row) ---
+    const int words = (n + 63) / 64;
+    // Uninitialised: first touched by the thread that sorts the row
+    MatrixBuffer<std::uint32_t> order(static_cast<size_t>(n) * n, HugePageAllocator<std::uint32_t>(memory));
+    MatrixBuffer<std::uint32_t> offsets(static_cast<size_t>(n) * (L + 1), HugePageAllocator<std::uint32_t>(memory));
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; ++i) {
+        std::uint32_t* off = &offsets[static_cast<size_t>(i) * (L + 1)];
+        std::uint32_t* ord = &order[static_cast<size_t>(i) * n];
+        std::vector<int> lvl(n);
+        std::vector<std::uint32_t> count(L + 1, 0);
+        for (int k = 0; k < n; ++k) {
+            lvl[k] = A[i][k] == -INF ? -1 : level_of(A[i][k]);
+            if (lvl[k] >= 0) ++count[lvl[k] + 1];
+        }
+        for (int l = 0; l < L; ++l) count[l + 1] += count[l];
+        std::copy(count.begin(), count.end(), off);
+        for (int k = 0; k < n; ++k) {
+            if (lvl[k] >= 0) ord[count[lvl[k]]++] = k;
+        }
+    }
+
+    // --- 3. Bitsets at the lowest threshold: every finite entry ---
+    // rows[i] bit k   <=>  A[i][k] >= t
+    // cols[j] bit k   <=>  A[k][j] >= t
+    // Column words are owned by the thread handling that block of 64 rows.
+    std::vector<std::uint64_t> rows(static_cast<size_t>(n) * words, 0);
+    std::vector<std::uint64_t> cols(static_cast<size_t>(n) * words, 0);
+
+    #pragma omp parallel for schedule(static)
+    for (int kw = 0; kw < words; ++kw) {
+        int k_end = std::min(n, (kw + 1) * 64);
+        for (int k = kw * 64; k < k_end; ++k) {
+            const std::uint32_t* off = &offsets[static_cast<size_t>(k) * (L + 1)];
+            const std::uint32_t* ord = &order[static_cast<size_t>(k) * n];
+            std::uint64_t bit_k = std::uint64_t(1) << (k & 63);
+            for (std::uint32_t p = off[0]; p < off[L]; ++p) {
+                int j = ord[p];
+                rows[static_cast<size_t>(k) * words + (j >> 6)] |= std::uint64_t(1) << (j & 63);
+                cols[static_cast<size_t>(j) * words + kw] |= bit_k;
+            }
+        }
+    }
+
+    // --- 4. Initial lower bounds from the trivial witnesses k = i and k = j ---
+    // due[i * n + j] is the level at which pair (i, j) next looks for a
+    // witness (SETTLED once C[i][j] is final) and pending[i * L + l] counts the
+    // pairs of row i due at level l, so a level only scans the rows it
+    // concerns. Two bytes per pair, where a queue of pairs would take eight.
+    MatrixBuffer<std::uint16_t> due(static_cast<size_t>(n) * n, HugePageAllocator<std::uint16_t>(memory));
+    MatrixBuffer<std::uint32_t> pending(static_cast<size_t>(n) * L, HugePageAllocator<std::uint32_t>(memory));
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; ++i) {
+        std::uint16_t* due_i = &due[static_cast<size_t>(i) * n];
+        std::uint32_t* pending_i = &pending[static_cast<size_t>(i) * L];
+        std::fill(pending_i, pending_i + L, 0);
+        for (int j = 0; j < n; ++j) {
+            double lb = std::max(std::min(A[i][i], A[i][j]), std::min(A[i][j], A[j][j]));
+            C[i][j] = lb;
+            int start = lb == -INF ? 0 : (exact ? level_of(lb) + 1 : level_of(lb));
+            due_i[j] = start < L ? static_cast<std::uint16_t>(start) : SETTLED;
+            if (start < L) ++pending_i[start];
+        }
+    }
+
+    // --- 5. Level-synchronous sweep with witness jumping ---
+    // A pair due at level l asks for any k with min(A[i][k], A[k][j]) >= t_l.
+    // The witness found gives a value w, so the pair jumps straight past w.
+    // Each row is handled by one thread, which alone updates its due entries.
+    for (int l = 0; l < L; ++l) {
+        #pragma omp parallel for schedule(dynamic, 16)
+        for (int i = 0; i < n; ++i) {
+            std::uint32_t* pending_i = &pending[static_cast<size_t>(i) * L];
+            std::uint32_t left = pending_i[l];
+            if (left == 0) continue;
+            pending_i[l] = 0;
+            std::uint16_t* due_i = &due[static_cast<size_t>(i) * n];
+            const std::uint64_t* r = &rows[static_cast<size_t>(i) * words];
+
+            for (int j = 0; left > 0; ++j) {
+                if (due_i[j] != l) continue;
+                --left;
+                due_i[j] = SETTLED;
+                const std::uint64_t* c = &cols[static_cast<size_t>(j) * words];
+
+                int w = 0;
+                while (w < words && (r[w] & c[w]) == 0) ++w;
+                if (w == words) continue;  // No witness at this threshold: C[i][j] is final
+
+                int k = w * 64 + lowest_bit(r[w] & c[w]);
+                double val = std::min(A[i][k], A[k][j]);
+                int val_level = level_of(val);
+
+                if (exact || val_level > l) {
+                    C[i][j] = std::max(C[i][j], val);
+                    int next = exact ? val_level + 1 : val_level;
+                    if (next < L) {
+                        due_i[j] = static_cast<std::uint16_t>(next);
+                        ++pending_i[next];
+                    }
+                } else {
+                    // Bucket mode, witness inside this bucket: every k outside the
+                    // intersection is below t_l, so a scan of it gives the exact max.
+                    double best = C[i][j];
+                    for (; w < words; ++w) {
+                        std::uint64_t bits = r[w] & c[w];
+                        while (bits) {
+                            int kk = w * 64 + lowest_bit(bits);
+                            bits &= bits - 1;
+                            best = std::max(best, std::min(A[i][kk], A[kk][j]));
+                        }
+                    }
+                    C[i][j] = best;
+                }
+            }
+        }
+
+        // Raise the threshold: drop the entries of this level from the bitsets
+        if (l + 1 < L) {
+            #pragma omp parallel for schedule(static)
+            for (int kw = 0; kw < words; ++kw) {
+                int k_end = std::min(n, (kw + 1) * 64);
+                for (int k = kw * 64; k < k_end; ++k) {
+                    const std::uint32_t* off = &offsets[static_cast<size_t>(k) * (L + 1)];
+                    const std::uint32_t* ord = &order[static_cast<size_t>(k) * n];
+                    std::uint64_t keep_k = ~(std::uint64_t(1) << (k & 63));
+                    for (std::uint32_t p = off[l]; p < off[l + 1]; ++p) {
+                        int j = ord[p];
+                        rows[static_cast<size_t>(k) * words + (j >> 6)] &= ~(std::uint64_t(1) << (j & 63));
+                        cols[static_cast<size_t>(j) * words + kw] &= keep_k;
+                    }
+                }
+            }
+        }
+    }
+}
+
+MaxMinBackend resolve_max_min_backend(MaxMinBackend requested, const std::vector<const double*>& A, int n) {
+    if (requested != MaxMinBackend::Auto) return requested;
+    if (n < AUTO_CROSSOVER_N) return MaxMinBackend::Dense;
+    const std::vector<double> levels = distinct_values(A, n, AUTO_MAX_LEVELS);
+    if (levels.empty() || n < AUTO_CROSSOVER_PER_ROOT_LEVEL * std::sqrt(static_cast<double>(levels.size()))) {
+        return MaxMinBackend::Dense;
+    }
+    return MaxMinBackend::ThresholdBitset;
+}
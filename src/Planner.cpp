@@ -0,0 +1,228 @@
+#include "Planner.h"
+#include "Hyperbolicity.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// --- Calibration ---
+// Single-core costs fitted by bench/planner_calibration.cpp to the
+// cyclic_graph_{100,1000}_nodes runs (integer weights 1-10, m = 1.5 n) of
+// every engine:
+//   one Dijkstra row       SSSP_NS * (n + entries) * log2 n
+//   one base, Dense        DENSE_NS * n^3 (Gromov products included)
+//   one base, Bitset       BITSET_NS * n^3 * levels / 64
+//   base heuristic         HEURISTIC_NS * n^2
+//   Log tree + distortion  LOG_NS * n^2
+//   pruned labels          ~LABEL_ENTRIES_PER_ROOT * sqrt(n) entries per vertex,
+//                          LABEL_NS each; LABEL_PAIR_NS per distortion pair
+constexpr double SSSP_NS = 5.2;
+constexpr double DENSE_NS = 0.67;
+constexpr double BITSET_NS = 0.52;
+constexpr double HEURISTIC_NS = 2.0;
+constexpr double LOG_NS = 10.0;
+constexpr double LABEL_ENTRIES_PER_ROOT = 1.5;
+constexpr double LABEL_NS = 350.0;
+constexpr double LABEL_PAIR_NS = 8.0;
+constexpr double MAX_AVG_LABEL = 1024;          // DistanceOracle::build_labels default
+constexpr double LANDMARKS = 16;                // LANDMARK_FALLBACK_COUNT in backend.cpp
+constexpr double SHARD_STARTUP_S = 2.0;         // Worker processes, job files, first claims
+
+// Threads seldom scale perfectly on these memory-bound kernels
+constexpr double PARALLEL_EFFICIENCY = 0.75;
+// Bitset levels only pay off from this size on (AUTO_CROSSOVER_N)
+constexpr int BITSET_MIN_N = 400;
+
+// Memory, in bytes
+constexpr double GRAPH_BYTES_PER_ITEM = 160.0;  // Qt graph, adjacency and cache per vertex or entry
+constexpr double LABEL_ENTRY_BYTES = 12.0;      // uint32 hub + double distance
+constexpr size_t PEAK_RESET_SLACK = size_t(4) << 20;   // RSS growth between the reset and the first read
+
+namespace {
+
+double cube(double n) { return n * n * n; }
+
+struct Sizes {
+    double vertices = 0;
+    double entries = 0;
+    double largest = 0;
+    double sum_squares = 0;
+};
+
+Sizes sizes_of(const GraphProfile& profile) {
+    Sizes s;
+    for (size_t c = 0; c < profile.component_vertices.size(); ++c) {
+        const double n = profile.component_vertices[c];
+        s.vertices += n;
+        s.entries += c < profile.component_entries.size() ? profile.component_entries[c] : 0;
+        s.largest = std::max(s.largest, n);
+        s.sum_squares += n * n;
+    }
+    return s;
+}
+
+int accuracy_rank(PlanEngine engine) {
+    switch (engine) {
+    case PlanEngine::Exact:
+    case PlanEngine::ExactSharded: return 0;
+    case PlanEngine::Factor2MultiBase: return 1;
+    case PlanEngine::Factor2: return 2;
+    case PlanEngine::Log: return 3;
+    case PlanEngine::LogOracle: return 3;
+    }
+    return 4;
+}
+
+} // namespace
+
+std::vector<PlanEstimate> estimate_plans(const GraphProfile& profile, const PlanBudget& budget) {
+    const Sizes s = sizes_of(profile);
+    const double speedup = std::max(1.0, budget.threads * PARALLEL_EFFICIENCY);
+    const int count = profile.component_vertices.size();
+
+    // Threshold bitsets beat the dense kernel when the distances take few
+    // values; Auto then uses them on every component large enough
+    const bool bitset_helps = profile.distance_levels > 0 &&
+                              BITSET_NS * profile.distance_levels / 64.0 < DENSE_NS;
+    const MaxMinBackend kernel = bitset_helps ? MaxMinBackend::Auto : MaxMinBackend::Dense;
+
+    // Per-component sums, in single-core nanoseconds
+    double apsp_ns = 0, one_base_ns = 0, exact_base_ns = 0, heuristic_ns = 0, log_ns = 0;
+    double label_build_ns = 0, label_pairs_ns = 0, label_bytes = 0;
+    for (int c = 0; c < count; ++c) {
+        const double n = profile.component_vertices[c];
+        const double entries = c < static_cast<int>(profile.component_entries.size()) ? profile.component_entries[c] : 0;
+        apsp_ns += SSSP_NS * n * (n + entries) * std::log2(std::max(2.0, n));
+        const double base_ns = bitset_helps && n >= BITSET_MIN_N
+            ? BITSET_NS * cube(n) * profile.distance_levels / 64.0
+            : DENSE_NS * cube(n);
+        one_base_ns += base_ns;
+        exact_base_ns += n * base_ns;
+        heuristic_ns += HEURISTIC_NS * n * n;
+        log_ns += LOG_NS * n * n;
+
+        const double label = LABEL_ENTRIES_PER_ROOT * std::sqrt(n);
+        if (label <= MAX_AVG_LABEL) {
+            label_build_ns += LABEL_NS * label * n;
+            label_bytes += LABEL_ENTRY_BYTES * label * n;
+        } else {
+            // Labels give up; landmark rows instead
+            label_build_ns += LABEL_NS * MAX_AVG_LABEL * n + LANDMARKS * SSSP_NS * (n + entries) * std::log2(n);
+            label_bytes += LANDMARKS * sizeof(double) * n;
+        }
+        label_pairs_ns += LABEL_PAIR_NS * n * n / 2;
+    }
+
+    const double graph_bytes = GRAPH_BYTES_PER_ITEM * (s.vertices + s.entries);
+    // Results share the cached distance matrices instead of copying them, so
+    // each matrix is counted once
+    const double matrices_bytes = sizeof(double) * s.sum_squares;
+    const double planes_bytes = 2 * sizeof(double) * s.largest * s.largest;   // Gromov products and their product
+    // The threshold kernel adds its own buffers for one base at a time
+    // (threshold_max_min_product): entry order and due levels per pair, level
+    // offsets and pending counts per row and level, and row and column
+    // bitsets. Gromov products of integral distances take up to twice as
+    // many values as the distances.
+    double threshold_bytes = 0;
+    if (bitset_helps && s.largest >= BITSET_MIN_N) {
+        const double n = s.largest;
+        const double levels = 2.0 * profile.distance_levels + 1;
+        const double words = std::ceil(n / 64);
+        threshold_bytes = sizeof(std::uint32_t) * n * n + sizeof(std::uint16_t) * n * n +
+                          sizeof(std::uint32_t) * n * (levels + 1) + sizeof(std::uint32_t) * n * levels +
+                          2 * sizeof(std::uint64_t) * n * words;
+    }
+    const double kernel_bytes = planes_bytes + threshold_bytes;
+    const double k = std::max(1, budget.multi_bases);
+    // compute_for_bases holds at most BATCH_MEMORY_BYTES of planes at once
+    const double batch = std::min(k, std::max(1.0, std::floor(BATCH_MEMORY_BYTES / std::max(1.0, planes_bytes))));
+    const double seconds_per_ns = 1e-9 / speedup;
+
+    std::vector<PlanEstimate> plans;
+    auto add = [&](PlanEngine engine, MaxMinBackend backend, double ns, double bytes, double disk = 0.0) {
+        PlanEstimate plan;
+        plan.engine = engine;
+        plan.kernel = backend;
+        plan.seconds = ns * seconds_per_ns;
+        if (engine == PlanEngine::ExactSharded) plan.seconds += SHARD_STARTUP_S;
+        plan.bytes = graph_bytes + bytes;
+        plan.disk_bytes = disk;
+        plan.fits_time = budget.seconds <= 0 || plan.seconds <= budget.seconds;
+        plan.fits_memory = plan.bytes <= budget.bytes;
+        plans.push_back(plan);
+    };
+
+    add(PlanEngine::Exact, kernel, apsp_ns + exact_base_ns, matrices_bytes + kernel_bytes);
+    if (budget.allow_disk) {
+        // Rows stream to disk; each worker holds only its kernel buffers
+        add(PlanEngine::ExactSharded, kernel, apsp_ns + exact_base_ns,
+            std::max(1, budget.shard_workers) * kernel_bytes, sizeof(double) * s.vertices * s.vertices);
+    }
+    add(PlanEngine::Factor2MultiBase, kernel, apsp_ns + heuristic_ns + k * one_base_ns,
+        matrices_bytes + batch * planes_bytes + threshold_bytes);
+    add(PlanEngine::Factor2, kernel, apsp_ns + heuristic_ns + one_base_ns, matrices_bytes + kernel_bytes);
+    add(PlanEngine::Log, MaxMinBackend::Dense, apsp_ns + log_ns,
+        matrices_bytes + sizeof(double) * s.largest * s.largest);   // Tree distances
+    // Labels are built on one thread; the distortion pairs run in parallel
+    add(PlanEngine::LogOracle, MaxMinBackend::Dense, label_build_ns * speedup + label_pairs_ns, label_bytes);
+    return plans;
+}
+
+int choose_plan(const std::vector<PlanEstimate>& plans) {
+    int best = -1;
+    for (int p = 0; p < static_cast<int>(plans.size()); ++p) {
+        const PlanEstimate& plan = plans[p];
+        if (!plan.fits_memory || !plan.fits_time) continue;
+        if (best < 0 || accuracy_rank(plan.engine) < accuracy_rank(plans[best].engine) ||
+            (accuracy_rank(plan.engine) == accuracy_rank(plans[best].engine) && plan.seconds < plans[best].seconds)) {
+            best = p;
+        }
+    }
+    if (best >= 0) return best;
+
+    // Over the time budget whatever runs: the fastest that fits in memory
+    for (int p = 0; p < static_cast<int>(plans.size()); ++p) {
+        if (plans[p].fits_memory && (best < 0 || plans[p].seconds < plans[best].seconds)) best = p;
+    }
+    return best;
+}
+
+// --- Memory probes ---
+namespace {
+
+// Value in kB of the "key:" line of a /proc file, in bytes; 0 if missing
+size_t proc_kilobytes(const char* path, const std::string& key) {
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, key.size(), key) == 0) {
+            return static_cast<size_t>(std::stoull(line.substr(key.size()))) * 1024;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+size_t available_memory_bytes() {
+    return proc_kilobytes("/proc/meminfo", "MemAvailable:");
+}
+
+PeakMemory::PeakMemory() {
+    // "5" resets the peak RSS (VmHWM) to the current RSS
+    {
+        std::ofstream out("/proc/self/clear_refs");
+        out << "5";
+    }
+    baseline = proc_kilobytes("/proc/self/status", "VmRSS:");
+    // Without the reset the peak stays at its lifetime high
+    tracked = baseline > 0 &&
+              proc_kilobytes("/proc/self/status", "VmHWM:") <= baseline + PEAK_RESET_SLACK;
+}
+
+size_t PeakMemory::added_bytes() const {
+    if (!tracked) return 0;
+    const size_t peak = proc_kilobytes("/proc/self/status", "VmHWM:");
+    return peak > baseline ? peak - baseline : 0;
+}
@@ -0,0 +1,411 @@
+#include "ShardedExact.h"
+#include "MatrixExport.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <omp.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HYP_HAVE_MMAP 1
+#elif defined(_WIN32)
+#include <process.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// A worker refreshes its claim this often; coordinator leases must be longer
+constexpr int HEARTBEAT_SECONDS = 10;
+
+ShardJob::ShardJob(std::string directory) : dir(std::move(directory)) {}
+
+// --- Job description ---
+std::uint64_t ShardJob::fingerprint(const std::vector<std::vector<std::pair<int, double>>>& adj_list) {
+    // FNV-1a over n and every (neighbour, weight) entry, neighbours in sorted order
+    std::uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](std::uint64_t value) {
+        for (int byte = 0; byte < 8; ++byte) {
+            hash ^= (value >> (8 * byte)) & 0xffu;
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(adj_list.size());
+    for (const auto& list : adj_list) {
+        std::vector<std::pair<int, double>> sorted = list;
+        std::sort(sorted.begin(), sorted.end());
+        mix(sorted.size());
+        for (const auto& [v, weight] : sorted) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &weight, sizeof(bits));
+            mix(static_cast<std::uint64_t>(v));
+            mix(bits);
+        }
+    }
+    return hash;
+}
+
+std::string ShardJob::distance_path() const {
+    return (fs::path(dir) / "distances.bin").string();
+}
+
+std::string ShardJob::queue_path(int shard, const std::string& state) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "shard-%05d.", shard);
+    return (fs::path(dir) / "queue" / (name + state)).string();
+}
+
+std::string ShardJob::checkpoint_path(int shard) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "shard-%05d.txt", shard);
+    return (fs::path(dir) / "checkpoints" / name).string();
+}
+
+std::pair<int, int> ShardJob::shard_range(int shard) const {
+    int first = shard * job.shard_size;
+    return {first, std::min(job.nodes, first + job.shard_size)};
+}
+
+bool ShardJob::open() {
+    std::ifstream in(fs::path(dir) / "job.txt");
+    if (!in) return false;
+    ShardJobInfo loaded;
+    std::string key;
+    bool complete = false;
+    while (in >> key) {
+        if (key == "nodes") in >> loaded.nodes;
+        else if (key == "shard_size") in >> loaded.shard_size;
+        else if (key == "shards") in >> loaded.shard_count;
+        else if (key == "fingerprint") in >> std::hex >> loaded.fingerprint >> std::dec;
+        else if (key == "end") complete = true;
+        else in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    if (!complete || loaded.shard_size <= 0 || !fs::exists(distance_path())) return false;
+    job = loaded;
+    return true;
+}
+
+void ShardJob::create(const std::vector<std::vector<double>>& dist_matrix, std::uint64_t fingerprint,
+                      int shard_size) {
+    if (shard_size <= 0) throw std::invalid_argument("ShardJob::create: shard size must be positive.");
+    const int n = dist_matrix.size();
+
+    // job.txt goes first and comes back last, so a half-written job is never resumed
+    fs::create_directories(dir);
+    fs::remove(fs::path(dir) / "job.txt");
+    for (const char* sub : {"queue", "checkpoints"}) {
+        fs::remove_all(fs::path(dir) / sub);
+        fs::create_directories(fs::path(dir) / sub);
+    }
+
+    DistanceMatrixWriter out(distance_path(), n, MatrixFormat::Raw);
+    for (int i = 0; i < n; ++i) {
+        if (dist_matrix[i].size() != static_cast<size_t>(n)) {
+            throw std::invalid_argument("ShardJob::create: distance matrix must be square.");
+        }
+        out.write_row(i, dist_matrix[i].data());
+    }
+    out.finish();
+
+    job.nodes = n;
+    job.shard_size = shard_size;
+    job.shard_count = (n + shard_size - 1) / shard_size;
+    job.fingerprint = fingerprint;
+    for (int s = 0; s < job.shard_count; ++s) {
+        std::ofstream(queue_path(s, "todo"));
+    }
+
+    std::string job_tmp = (fs::path(dir) / "job.txt.tmp").string();
+    {
+        std::ofstream out(job_tmp, std::ios::trunc);
+        out << "nodes " << job.nodes << "\n"
+            << "shard_size " << job.shard_size << "\n"
+            << "shards " << job.shard_count << "\n"
+            << "fingerprint " << std::hex << job.fingerprint << std::dec << "\n"
+            << "end\n";
+        if (!out) throw std::runtime_error("Cannot write " + job_tmp);
+    }
+    fs::rename(job_tmp, fs::path(dir) / "job.txt");
+}
+
+// --- Work queue ---
+// Shard id from "shard-00012.<state>", or -1
+static int shard_of(const std::string& name) {
+    if (name.compare(0, 6, "shard-") != 0) return -1;
+    size_t dot = name.find('.');
+    if (dot == std::string::npos || dot <= 6) return -1;
+    for (size_t c = 6; c < dot; ++c) {
+        if (!std::isdigit(static_cast<unsigned char>(name[c]))) return -1;
+    }
+    return std::stoi(name.substr(6, dot - 6));
+}
+
+static bool has_suffix(const std::string& name, const std::string& suffix) {
+    return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int ShardJob::claim(const std::string& worker) {
+    std::vector<int> waiting;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(fs::path(dir) / "queue", ec)) {
+        std::string name = entry.path().filename().string();
+        if (has_suffix(name, ".todo") && shard_of(name) >= 0) waiting.push_back(shard_of(name));
+    }
+    std::sort(waiting.begin(), waiting.end());
+
+    // Losing a race for one shard just moves on to the next
+    for (int shard : waiting) {
+        std::error_code rename_ec;
+        fs::rename(queue_path(shard, "todo"), queue_path(shard, "claim." + worker), rename_ec);
+        if (!rename_ec) {
+            heartbeat(shard, worker);
+            return shard;
+        }
+    }
+    return -1;
+}
+
+bool ShardJob::heartbeat(int shard, const std::string& worker) {
+    std::error_code ec;
+    fs::last_write_time(queue_path(shard, "claim." + worker), fs::file_time_type::clock::now(), ec);
+    return !ec;
+}
+
+void ShardJob::complete(int shard, const std::string& worker) {
+    std::error_code ec;
+    fs::rename(queue_path(shard, "claim." + worker), queue_path(shard, "done"), ec);
+    if (ec) {
+        // The claim was requeued meanwhile; the checkpoint is complete anyway
+        fs::rename(queue_path(shard, "todo"), queue_path(shard, "done"), ec);
+    }
+}
+
+int ShardJob::requeue_stale(double lease_seconds) {
+    const auto now = fs::file_time_type::clock::now();
+    int requeued = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(fs::path(dir) / "queue", ec)) {
+        std::string name = entry.path().filename().string();
+        int shard = shard_of(name);
+        if (shard < 0 || name.find(".claim.") == std::string::npos) continue;
+
+        std::error_code time_ec;
+        auto stamp = fs::last_write_time(entry.path(), time_ec);
+        if (time_ec) continue;
+        double age = std::chrono::duration<double>(now - stamp).count();
+        if (age <= lease_seconds) continue;
+
+        std::error_code rename_ec;
+        fs::rename(entry.path(), queue_path(shard, "todo"), rename_ec);
+        if (!rename_ec) ++requeued;
+    }
+    return requeued;
+}
+
+ShardProgress ShardJob::progress() const {
+    ShardProgress p;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(fs::path(dir) / "queue", ec)) {
+        std::string name = entry.path().filename().string();
+        if (shard_of(name) < 0) continue;
+        if (has_suffix(name, ".todo")) ++p.todo;
+        else if (has_suffix(name, ".done")) ++p.done;
+        else if (name.find(".claim.") != std::string::npos) ++p.claimed;
+    }
+    return p;
+}
+
+// --- Checkpoints ---
+void ShardJob::record(int shard, double delta, const BaseWitness& witness) {
+    std::string path = checkpoint_path(shard);
+    std::FILE* out = std::fopen(path.c_str(), "a");
+    if (!out) throw std::runtime_error("Cannot append to " + path);
+    std::fprintf(out, "%d %.17g %d %d %d\n", witness.r, delta, witness.i, witness.j, witness.k);
+    std::fflush(out);
+#ifdef HYP_HAVE_MMAP
+    fsync(fileno(out));  // A base can take minutes; do not lose it to a power cut
+#endif
+    std::fclose(out);
+}
+
+std::map<int, CheckpointEntry> ShardJob::checkpoint(int shard) const {
+    std::map<int, CheckpointEntry> done;
+    std::ifstream in(checkpoint_path(shard), std::ios::binary);
+    if (!in) return done;
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+
+    // Only newline-terminated lines count: a crash may have cut the last one
+    size_t start = 0;
+    for (size_t end; (end = text.find('\n', start)) != std::string::npos; start = end + 1) {
+        CheckpointEntry entry;
+        BaseWitness& w = entry.witness;
+        std::istringstream line(text.substr(start, end - start));
+        if (line >> w.r >> entry.delta >> w.i >> w.j >> w.k && w.r >= 0 && w.r < job.nodes) {
+            done[w.r] = entry;
+        }
+    }
+    return done;
+}
+
+std::vector<double> ShardJob::base_deltas() const {
+    std::vector<double> deltas(job.nodes, std::numeric_limits<double>::quiet_NaN());
+    for (int s = 0; s < job.shard_count; ++s) {
+        for (const auto& [r, entry] : checkpoint(s)) deltas[r] = entry.delta;
+    }
+    return deltas;
+}
+
+std::vector<BaseWitness> ShardJob::base_witnesses() const {
+    std::vector<BaseWitness> witnesses(job.nodes);
+    for (int s = 0; s < job.shard_count; ++s) {
+        for (const auto& [r, entry] : checkpoint(s)) witnesses[r] = entry.witness;
+    }
+    return witnesses;
+}
+
+// --- Mapped distance matrix ---
+MappedDistanceMatrix::MappedDistanceMatrix(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(RAW_MATRIX_MAGIC)];
+    std::uint64_t count = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!in || std::memcmp(magic, RAW_MATRIX_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a distance matrix file: " + path);
+    }
+    n = static_cast<int>(count);
+    const size_t expected = MATRIX_HEADER_BYTES + static_cast<size_t>(n) * n * sizeof(double);
+    if (fs::file_size(path) != expected) {
+        throw std::runtime_error("Truncated distance matrix file: " + path);
+    }
+
+#ifdef HYP_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        void* p = mmap(nullptr, expected, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p != MAP_FAILED) {
+            mapping = p;
+            mapped_length = expected;
+            values = reinterpret_cast<const double*>(static_cast<const char*>(p) + MATRIX_HEADER_BYTES);
+            return;
+        }
+    }
+#endif
+    fallback.resize(static_cast<size_t>(n) * n);
+    in.read(reinterpret_cast<char*>(fallback.data()), fallback.size() * sizeof(double));
+    if (!in) throw std::runtime_error("Cannot read " + path);
+    values = fallback.data();
+}
+
+MappedDistanceMatrix::~MappedDistanceMatrix() {
+#ifdef HYP_HAVE_MMAP
+    if (mapping) munmap(mapping, mapped_length);
+#endif
+}
+
+// --- Worker ---
+namespace {
+
+std::string default_worker_id() {
+    std::string host = "worker";
+    long pid = 0;
+#ifdef HYP_HAVE_MMAP
+    char name[256] = {0};
+    if (gethostname(name, sizeof(name) - 1) == 0 && name[0]) host = name;
+    pid = static_cast<long>(getpid());
+#elif defined(_WIN32)
+    if (const char* name = std::getenv("COMPUTERNAME")) host = name;
+    pid = static_cast<long>(_getpid());
+#endif
+    return host + "-" + std::to_string(pid);
+}
+
+// Worker ids end up in file names
+std::string sanitize_worker_id(std::string id) {
+    for (char& c : id) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_') c = '_';
+    }
+    return id;
+}
+
+// Keeps one claim alive while its bases are evaluated
+class Heartbeat {
+public:
+    Heartbeat(ShardJob& job, int shard, const std::string& worker)
+        : beat([this, &job, shard, worker] {
+              std::unique_lock<std::mutex> lock(mutex);
+              while (!wake.wait_for(lock, std::chrono::seconds(HEARTBEAT_SECONDS), [this] { return stopping; })) {
+                  if (!job.heartbeat(shard, worker)) lost = true;
+              }
+          }) {}
+    ~Heartbeat() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        beat.join();
+    }
+    bool claim_lost() const { return lost; }
+
+private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::atomic<bool> lost{false};
+    std::thread beat;  // Last: starts once the members above exist
+};
+
+} // namespace
+
+int run_shard_worker(const std::string& directory, const ShardWorkerOptions& options) {
+    ShardJob job(directory);
+    if (!job.open()) throw std::runtime_error("No shard job in " + directory);
+    if (options.threads > 0) omp_set_num_threads(options.threads);
+    const std::string worker = sanitize_worker_id(options.worker_id.empty() ? default_worker_id()
+                                                                             : options.worker_id);
+
+    MappedDistanceMatrix distances(job.distance_path());
+    if (distances.size() != job.info().nodes) {
+        throw std::runtime_error("Distance matrix does not match job.txt in " + directory);
+    }
+    HyperbolicityCalculator calc(distances.data(), distances.size());
+    calc.set_max_min_backend(options.max_min_backend);
+
+    int completed = 0;
+    for (int shard; (shard = job.claim(worker)) >= 0;) {
+        Heartbeat heartbeat(job, shard, worker);
+        std::map<int, CheckpointEntry> done = job.checkpoint(shard);
+        auto [first, last] = job.shard_range(shard);
+        for (int r = first; r < last && !heartbeat.claim_lost(); ++r) {
+            if (done.count(r)) continue;
+            BaseWitness witness;
+            double delta = calc.compute_for_base(r, &witness);
+            job.record(shard, delta, witness);
+        }
+        // A lost claim is finished by whoever holds it now
+        if (!heartbeat.claim_lost()) {
+            job.complete(shard, worker);
+            ++completed;
+        }
+    }
+    return completed;
+}
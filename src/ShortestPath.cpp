@@ -5,15 +5,19 @@
 #include <iostream>
 #include <unistd.h>
 #include <omp.h>
+#include <stdexcept>
+#include <atomic>
+#include <exception>
 
 constexpr double INF = std::numeric_limits<double>::infinity();
 
 ShortestPath::ShortestPath(const std::vector<std::vector<std::pair<int, double>>>& adj_list)
     : adjacency_list(adj_list) {}
 
-std::vector<double> ShortestPath::dijkstra(int source) const {
+// Fills dist in place, so a row allocated beforehand keeps its pages
+void ShortestPath::dijkstra(int source, std::vector<double>& dist) const {
     int n = adjacency_list.size();
-    std::vector<double> dist(n, INF);
+    dist.assign(n, INF);
     std::priority_queue<std::pair<double, int>, 
                         std::vector<std::pair<double, int>>, 
                         std::greater<>> pq;
@@ -34,19 +38,59 @@ std::vector<double> ShortestPath::dijkstra(int source) const {
             }
         }
     }
-    return dist;
 }
 
+std::vector<double> ShortestPath::compute_single_source(int source) const {
+    if (source < 0 || source >= static_cast<int>(adjacency_list.size())) {
+        throw std::out_of_range("ShortestPath: source index out of range.");
+    }
+    std::vector<double> dist;
+    dijkstra(source, dist);
+    return dist;
+}
 
 std::vector<std::vector<double>> ShortestPath::compute_all_pairs() {
     std::vector<std::vector<double>> dist_matrix;
     int n = adjacency_list.size();
     dist_matrix.resize(n);
 
+    // Rows are first touched in the static partition that consumers such as
+    // the Gromov product kernels read them in, so each lands on its reader's
+    // NUMA node; the searches themselves vary in length and are balanced
+    // dynamically, writing into those pages.
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; ++i) {
+        dist_matrix[i].assign(n, INF);
+    }
+
     #pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < n; ++i) {
-        dist_matrix[i] = dijkstra(i);
+        dijkstra(i, dist_matrix[i]);
     }
     
     return dist_matrix;
 }
+
+void ShortestPath::compute_all_pairs(const std::function<void(int, const std::vector<double>&)>& on_row) const {
+    int n = adjacency_list.size();
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+
+    // Exceptions may not leave the parallel region; the first one is kept
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < n; ++i) {
+        if (failed.load(std::memory_order_relaxed)) continue;
+        try {
+            std::vector<double> row;
+            dijkstra(i, row);
+            on_row(i, row);
+        } catch (...) {
+            #pragma omp critical
+            {
+                if (!error) error = std::current_exception();
+            }
+            failed = true;
+        }
+    }
+    if (error) std::rethrow_exception(error);
+}
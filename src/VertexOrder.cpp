@@ -0,0 +1,119 @@
+#include "VertexOrder.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Rounds of the George-Liu search for a pseudo-peripheral start vertex
+constexpr int PERIPHERAL_ROUNDS = 8;
+
+OrderLocality order_locality(const std::vector<std::vector<std::pair<int, double>>>& adj_list) {
+    OrderLocality locality;
+    long long entries = 0;
+    double total = 0.0;
+    for (size_t u = 0; u < adj_list.size(); ++u) {
+        for (const auto& [v, weight] : adj_list[u]) {
+            const int gap = std::abs(v - static_cast<int>(u));
+            total += gap;
+            locality.bandwidth = std::max(locality.bandwidth, gap);
+            ++entries;
+        }
+    }
+    locality.mean_gap = entries > 0 ? total / entries : 0.0;
+    return locality;
+}
+
+namespace {
+
+// Breadth-first levels from root; returns the vertices in visiting order and
+// leaves the level of each one in level (-1 = not reached)
+std::vector<int> bfs_levels(const std::vector<std::vector<std::pair<int, double>>>& adj_list, int root,
+                            std::vector<int>& level) {
+    std::vector<int> visited{root};
+    level[root] = 0;
+    for (size_t q = 0; q < visited.size(); ++q) {
+        const int u = visited[q];
+        for (const auto& [v, weight] : adj_list[u]) {
+            if (level[v] < 0) {
+                level[v] = level[u] + 1;
+                visited.push_back(v);
+            }
+        }
+    }
+    return visited;
+}
+
+// Start vertex with a long breadth-first spanning tree: repeatedly restart
+// from the smallest-degree vertex of the last level while the depth grows
+int pseudo_peripheral(const std::vector<std::vector<std::pair<int, double>>>& adj_list, int start,
+                      std::vector<int>& level) {
+    int root = start;
+    int depth = -1;
+    for (int round = 0; round < PERIPHERAL_ROUNDS; ++round) {
+        std::vector<int> visited = bfs_levels(adj_list, root, level);
+        const int last = level[visited.back()];
+        int candidate = visited.back();
+        for (int v : visited) {
+            if (level[v] == last && adj_list[v].size() < adj_list[candidate].size()) candidate = v;
+        }
+        for (int v : visited) level[v] = -1;
+        if (last <= depth) break;
+        depth = last;
+        root = candidate;
+    }
+    return root;
+}
+
+} // namespace
+
+std::vector<int> reverse_cuthill_mckee(const std::vector<std::vector<std::pair<int, double>>>& adj_list) {
+    const int n = adj_list.size();
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<int> level(n, -1);
+    std::vector<char> placed(n, 0);
+
+    // Components in turn, each from its smallest-degree unplaced vertex
+    std::vector<int> by_degree(n);
+    for (int v = 0; v < n; ++v) by_degree[v] = v;
+    std::stable_sort(by_degree.begin(), by_degree.end(),
+                     [&](int a, int b) { return adj_list[a].size() < adj_list[b].size(); });
+
+    std::vector<int> neighbours;
+    for (int start : by_degree) {
+        if (placed[start]) continue;
+        const int root = pseudo_peripheral(adj_list, start, level);
+        size_t head = order.size();
+        order.push_back(root);
+        placed[root] = 1;
+        for (; head < order.size(); ++head) {
+            neighbours.clear();
+            for (const auto& [v, weight] : adj_list[order[head]]) {
+                if (!placed[v]) {
+                    placed[v] = 1;
+                    neighbours.push_back(v);
+                }
+            }
+            std::stable_sort(neighbours.begin(), neighbours.end(),
+                             [&](int a, int b) { return adj_list[a].size() < adj_list[b].size(); });
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+std::vector<std::vector<std::pair<int, double>>> permute_adjacency(
+    const std::vector<std::vector<std::pair<int, double>>>& adj_list, const std::vector<int>& order) {
+    const int n = adj_list.size();
+    std::vector<int> new_id(n);
+    for (int i = 0; i < n; ++i) new_id[order[i]] = i;
+
+    std::vector<std::vector<std::pair<int, double>>> permuted(n);
+    for (int i = 0; i < n; ++i) {
+        const auto& neighbours = adj_list[order[i]];
+        permuted[i].reserve(neighbours.size());
+        for (const auto& [v, weight] : neighbours) permuted[i].emplace_back(new_id[v], weight);
+        // Ascending neighbour ids: relaxations walk the distance row forwards
+        std::sort(permuted[i].begin(), permuted[i].end());
+    }
+    return permuted;
+}
@@ -1,12 +1,22 @@
 #include "backend.h"
 #include "GraphParser.h"
+#include "GtfsLoader.h"
 #include "ShortestPath.h"
 #include "Hyperbolicity.h"
 #include "2Factor.h"
+#include "Eccentricity.h"
+#include "Components.h"
+#include "DistanceOracle.h"
 #include "LogApproximation.h"
+#include "DynamicHyperbolicity.h"
+#include "MatrixMemory.h"
+#include "ShardedExact.h"
+#include "MatrixExport.h"
+#include "LocalHyperbolicity.h"
+#include "Planner.h"
+#include "VertexOrder.h"
 #include <QFile>
 #include <QJsonDocument>
-#include <QPainter>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonValue>
@@ -14,7 +24,19 @@
 #include <QDir>  
 #include <iostream>
 #include <QCoreApplication>
+#include <QProcess>
+#include <QSysInfo>
+#include <QThread>
 #include <limits>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <exception>
+#include <functional>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <omp.h>
 #include <QDebug>
 
 
@@ -28,72 +50,233 @@ void Graph::addEdge(const QString& src, const QString& tgt, double weight) {
     adj[tgt][src] = weight;
 }
 
+void Graph::indexGraph() {
+    node_slots.clear();
+    for (int i = 0; i < nodes.size(); ++i) node_slots.insert(nodes[i], i);
+    edge_slots.clear();
+    edge_slots.reserve(edges.size());
+    for (int e = 0; e < edges.size(); ++e) edge_slots.insert(qMakePair(edges[e].source, edges[e].target), e);
+    indexed_edges = edges.size();
+}
+
+void Graph::removeEdgeSlot(int slot) {
+    const int last = edges.size() - 1;
+    if (slot != last) {
+        const QPair<QString, QString> moved(edges[last].source, edges[last].target);
+        edge_slots.remove(moved, last);
+        edge_slots.insert(moved, slot);
+        edges[slot] = edges[last];
+    }
+    edges.removeLast();
+}
+
+void Graph::setEdge(const QString& src, const QString& tgt, double weight) {
+    if (indexed_edges != edges.size() || node_slots.size() != nodes.size()) indexGraph();
+    for (const QString& name : {src, tgt}) {
+        if (!node_slots.contains(name)) {
+            node_slots.insert(name, nodes.size());
+            nodes.append(name);
+        }
+    }
+
+    for (const QPair<QString, QString>& key : {qMakePair(src, tgt), qMakePair(tgt, src)}) {
+        // Highest slot first, so moving the last entry never hits a slot still to remove
+        QList<int> entries = edge_slots.values(key);
+        std::sort(entries.begin(), entries.end(), std::greater<int>());
+        edge_slots.remove(key);
+        for (int slot : entries) removeEdgeSlot(slot);
+    }
+    adj[src].remove(tgt);
+    adj[tgt].remove(src);
+
+    if (weight != INF) {
+        // Both directions, as the CSV loader stores them
+        addEdge(src, tgt, weight);
+        edges.append({tgt, src, weight});
+        edge_slots.insert(qMakePair(src, tgt), edges.size() - 2);
+        edge_slots.insert(qMakePair(tgt, src), edges.size() - 1);
+    }
+    indexed_edges = edges.size();
+}
+
+// Copies a parsed graph, keeping the parser's node order
+static void fillGraph(Graph* graph, const GraphParser& parser) {
+    const auto& std_nodes = parser.get_nodes();
+    QVector<QString> names;
+    names.reserve(std_nodes.size());
+    for (const auto& node : std_nodes) {
+        QString qNode = QString::fromStdString(node);
+        names.append(qNode);
+        graph->nodes.append(qNode); // Maintain order using QList
+    }
+
+    // Edges are listed in both directions already
+    const auto& adj_list = parser.get_adjacency_list();
+    for (size_t i = 0; i < adj_list.size(); ++i) {
+        for (const auto& [j, weight] : adj_list[i]) {
+            graph->addEdge(names[i], names[j], weight);
+        }
+    }
+}
+
 Graph* loadGraph(const QString& filePath) {
-    Graph* graph = new Graph();
-    QFile file(filePath);
+    // Owned here until loading succeeded; the parsers throw on bad input
+    std::unique_ptr<Graph> owner(new Graph());
+    Graph* graph = owner.get();
+    QFileInfo info(filePath);
   
-     if (filePath.endsWith(".csv", Qt::CaseInsensitive)) {
-        GraphParser parser;
-        parser.parse(filePath.toStdString());
-        
-        // Preserve node order from parser
-        const auto& std_nodes = parser.get_nodes();
-        for (const auto& node : std_nodes) {
+    // A GTFS feed is opened through its folder or either of the files read from it
+    if (info.isDir() || info.fileName() == "stops.txt" || info.fileName() == "stop_times.txt") {
+        QString feedDir = info.isDir() ? info.absoluteFilePath() : info.absolutePath();
+        GtfsGraph feed = load_gtfs(feedDir.toStdString());
+
+        QVector<QString> names;
+        names.reserve(feed.nodes.size());
+        for (const auto& node : feed.nodes) {
             QString qNode = QString::fromStdString(node);
-            graph->nodes.append(qNode); // Maintain order using QList
-        }
-        
-        // Add edges (existing code)
-        const auto& adj_list = parser.get_adjacency_list();
-        for (size_t i = 0; i < adj_list.size(); ++i) {
-            QString src = QString::fromStdString(std_nodes[i]);
-            for (const auto& [j, weight] : adj_list[i]) {
-                QString dest = QString::fromStdString(std_nodes[j]);
-                graph->addEdge(src, dest, weight);
+            names.append(qNode);
+            graph->nodes.append(qNode);
+        }
+        // Both directions, as the CSV loader stores them
+        for (size_t u = 0; u < feed.nodes.size(); ++u) {
+            for (int e = feed.offsets[u]; e < feed.offsets[u + 1]; ++e) {
+                graph->addEdge(names[u], names[feed.targets[e]], feed.weights[e]);
             }
         }
+    }
+    else if (filePath.endsWith(".csv", Qt::CaseInsensitive)) {
+        GraphParser parser;
+        parser.parse(filePath.toStdString());
+        fillGraph(graph, parser);
     } 
     else if (filePath.endsWith(".json", Qt::CaseInsensitive)) {
-    if (!file.open(QIODevice::ReadOnly)) {
-        throw std::runtime_error("Cannot open file");
-    }
-    
-    QByteArray data = file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (!doc.isObject()) throw std::runtime_error("Invalid JSON format");
-    
-    QJsonObject root = doc.object();
-    QJsonArray edges = root.value(QLatin1String("edges")).toArray();
-    
-    for (const QJsonValue& edge_val : edges) {
-        QJsonObject edge = edge_val.toObject();
-        QString src = edge.value(QLatin1String("source")).toString();
-        QString dest = edge.value(QLatin1String("target")).toString();
-        double weight = edge.contains(QLatin1String("weight")) 
-                      ? edge.value(QLatin1String("weight")).toDouble() 
-                      : 1.0;
-        graph->addEdge(src, dest, weight);
-    }
-} else {
+        GraphParser parser;
+        parser.parse_json(filePath.toStdString());
+        fillGraph(graph, parser);
+    } else {
         throw std::runtime_error("Unsupported file format");
     }
-    return graph;
+    return owner.release();
 }
 
-HyperResult computeHyperbolicity(const Graph* graph, const QString& method, const QString& input_filename) {
-    HyperResult result;
-    auto overall_start_time = std::chrono::steady_clock::now();
+static BaseSelection parseBaseSelection(const QString& name) {
+    if (name == "Centrality") return BaseSelection::Centrality;
+    if (name == "Random") return BaseSelection::Random;
+    return BaseSelection::Eccentricity;
+}
 
-    
-    // Capture node order
-    result.node_order = graph->nodes.toVector();
-    
+static MaxMinBackend parseMaxMinBackend(const QString& name) {
+    if (name == "Dense") return MaxMinBackend::Dense;
+    if (name == "Threshold Bitset") return MaxMinBackend::ThresholdBitset;
+    return MaxMinBackend::Auto;
+}
+
+// Qt-free view of the request, safe to share between worker threads
+enum class Method { Exact, Factor2, Factor2MultiBase, Log, LocalHops, LocalRadius, Unknown };
+
+struct MethodSettings {
+    Method method = Method::Unknown;
+    int num_bases = 1;
+    BaseSelection base_selection = BaseSelection::Eccentricity;
+    unsigned int seed = 0;
+    MaxMinBackend max_min_backend = MaxMinBackend::Auto;
+    bool use_distance_oracle = false;
+    int local_hops = 2;
+    double local_radius = 2.0;
+    MatrixMemoryConfig memory;        // Placement of the kernel matrices of this run
+};
+
+static Method parseMethod(const QString& name) {
+    if (name == "Exact Algorithm") return Method::Exact;
+    if (name == "Factor-2 Approximation") return Method::Factor2;
+    if (name == "Factor-2 Multi-base Approximation") return Method::Factor2MultiBase;
+    if (name == "Log Approximation") return Method::Log;
+    if (name == "Local Hyperbolicity (k-hop balls)") return Method::LocalHops;
+    if (name == "Local Hyperbolicity (radius balls)") return Method::LocalRadius;
+    return Method::Unknown;
+}
+
+// Landmarks used when the exact labels would grow too large
+constexpr int LANDMARK_FALLBACK_COUNT = 16;
+// Distinct distances the planner still counts as few (MAX_EXACT_LEVELS)
+constexpr double PLANNER_MAX_LEVELS = 512;
+
+// Outcome of one method on one connected piece (local vertex ids)
+struct MethodOutcome {
+    double hyperbolicity = 0.0;
+    double lower_bound = 0.0;
+    double upper_bound = 0.0;
+    std::vector<int> bases;
+    std::vector<int> witness;     // Local ids, see HyperResult::witness
+
+    bool used_oracle = false;
+    bool oracle_exact = true;     // Labels, not landmark bounds
+    double oracle_build_ms = 0.0;
+    size_t oracle_bytes = 0;
+    double oracle_query_ns = 0.0;
+
+    bool reused_distances = false;
+    int reused_bases = 0;
+
+    LocalProfile local;           // Local methods only
+};
+
+// --- Per-graph cache ---
+// Everything the methods can share on one connected piece (local vertex ids)
+struct PieceCache {
+    std::vector<int> vertices;          // Global id of each local id; empty = the same ids
+    std::vector<std::vector<std::pair<int, double>>> adj_list;
+    // Eccentricity bounds on adj_list, built on first use (pieceEccentricity)
+    // and shared by the diameter summary and the Factor-2 base choice
+    std::unique_ptr<EccentricityEngine> eccentricity;
+
+    bool has_distances = false;
+    SharedDistances distance_matrix;
+    std::vector<double> base_deltas;    // delta_r per vertex, NaN = not evaluated yet
+    std::vector<BaseWitness> base_witnesses;
+
+    int heuristic_base = -1;            // Factor-2 base
+    std::map<std::tuple<int, int, unsigned int>, std::vector<int>> chosen_bases;  // (k, selection, seed)
+
+    bool has_log_tree = false;
+    ApproxTree log_tree;
+    bool has_log_value = false;
+    double log_value = 0.0;
+    std::pair<int, int> log_witness{-1, -1};
+};
+
+struct GraphCache {
+    const Graph* graph = nullptr;
+    int node_count = -1;
+    int edge_count = -1;
+    QString vertex_order;               // As requested (ComputeOptions::vertex_order)
+
+    // Renumbering of the pieces: "RCM" if any piece was renumbered, else "Input"
+    QString applied_order = "Input";
+    double order_ms = 0.0;
+    double edge_gap_before = 0.0;       // Mean |id(u) - id(v)| over adjacency entries
+    double edge_gap_after = 0.0;
+
+    // Filled in when a result first reports them (graphExtremes)
+    bool has_extremes = false;
+    double diameter = 0.0;
+    double radius = 0.0;
+    int eccentricity_searches = 0;
+
+    std::vector<PieceCache> pieces;     // One per connected component, largest first
+    // Piece and local id of each vertex, indexed by position in graph->nodes
+    std::vector<int> piece_of;
+    std::vector<int> local_of;
+};
+
+// Adjacency list in node order; edges are stored in both directions already
+static std::vector<std::vector<std::pair<int, double>>> adjacencyList(const Graph* graph) {
     // Create index mapping
     QMap<QString, int> node_indices;
     for (int i = 0; i < graph->nodes.size(); ++i) {
         node_indices[graph->nodes[i]] = i;
     }
-    
+
     // Build adjacency list
     std::vector<std::vector<std::pair<int, double>>> adj_list(graph->nodes.size());
     for (const Edge& edge : graph->edges) {
@@ -101,32 +284,491 @@ HyperResult computeHyperbolicity(const Graph* graph, const QString& method, cons
         int v = node_indices[edge.target];
         adj_list[u].emplace_back(v, edge.weight);
     }
-    //distance matrix
-    std::vector<std::vector<double>> distance_matrix; // Use local variable first
-    
-    // Compute distances
+    return adj_list;
+}
 
-    ShortestPath sp(adj_list);
-    distance_matrix = sp.compute_all_pairs(); 
-    result.distance_matrix = distance_matrix;
-    
+// Pieces at least this large are renumbered by the "Auto" vertex order when
+// that at least halves the mean id gap between neighbours; smaller ones fit
+// in cache whatever their order
+constexpr size_t REORDER_MIN_VERTICES = 2048;
+constexpr double REORDER_MIN_GAIN = 0.5;
+
+// Renumbers piece in reverse Cuthill-McKee order if vertex_order asks for it;
+// vertices then maps the new ids back to the graph's
+static bool reorderPiece(PieceCache& piece, const QString& vertex_order) {
+    const bool forced = vertex_order == "RCM";
+    if (!forced && (vertex_order != "Auto" || piece.adj_list.size() < REORDER_MIN_VERTICES)) return false;
+
+    std::vector<int> order = reverse_cuthill_mckee(piece.adj_list);
+    std::vector<std::vector<std::pair<int, double>>> permuted = permute_adjacency(piece.adj_list, order);
+    if (!forced && order_locality(permuted).mean_gap > REORDER_MIN_GAIN * order_locality(piece.adj_list).mean_gap) {
+        return false;
+    }
+
+    std::vector<int> global(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        global[i] = piece.vertices.empty() ? order[i] : piece.vertices[order[i]];
+    }
+    piece.vertices = std::move(global);
+    piece.adj_list = std::move(permuted);
+    return true;
+}
+
+static void buildGraphCache(GraphCache& cache, const Graph* graph, const QString& vertex_order) {
+    cache.graph = graph;
+    cache.node_count = graph->nodes.size();
+    cache.edge_count = graph->edges.size();
+    cache.vertex_order = vertex_order;
+
+    std::vector<std::vector<std::pair<int, double>>> adj_list = adjacencyList(graph);
+    cache.edge_gap_before = order_locality(adj_list).mean_gap;
+
+    ConnectedComponents cc(adj_list);
+    if (cc.count() <= 1) {
+        cache.pieces.resize(1);
+        cache.pieces[0].adj_list = std::move(adj_list);
+    } else {
+        const std::vector<GraphComponent>& parts = cc.components();
+        cache.pieces.resize(parts.size());
+        for (size_t c = 0; c < parts.size(); ++c) {
+            cache.pieces[c].vertices = parts[c].vertices;
+            cache.pieces[c].adj_list = parts[c].adj_list;
+        }
+    }
+
+    // --- Vertex order ---
+    // Locality is measured in the numbering the engines will run on
+    auto order_start = std::chrono::steady_clock::now();
+    double gap_sum = 0.0;
+    long long entries = 0;
+    for (PieceCache& piece : cache.pieces) {
+        if (reorderPiece(piece, vertex_order)) cache.applied_order = "RCM";
+        long long piece_entries = 0;
+        for (const auto& neighbours : piece.adj_list) piece_entries += neighbours.size();
+        gap_sum += order_locality(piece.adj_list).mean_gap * piece_entries;
+        entries += piece_entries;
+    }
+    cache.edge_gap_after = entries > 0 ? gap_sum / entries : 0.0;
+    cache.order_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - order_start).count();
+
+    cache.piece_of.assign(cache.node_count, -1);
+    cache.local_of.assign(cache.node_count, -1);
+    for (size_t p = 0; p < cache.pieces.size(); ++p) {
+        const PieceCache& piece = cache.pieces[p];
+        for (int l = 0; l < static_cast<int>(piece.adj_list.size()); ++l) {
+            const int v = piece.vertices.empty() ? l : piece.vertices[l];
+            cache.piece_of[v] = static_cast<int>(p);
+            cache.local_of[v] = l;
+        }
+    }
+}
+
+static EccentricityEngine& pieceEccentricity(PieceCache& piece) {
+    if (!piece.eccentricity) piece.eccentricity = std::make_unique<EccentricityEngine>(piece.adj_list);
+    return *piece.eccentricity;
+}
+
+// Diameter and radius, from whatever each piece already holds: an engine that
+// has run (the Factor-2 base choice), else the rows of its distance matrix,
+// else a handful of single-source searches
+static void graphExtremes(GraphCache& cache) {
+    if (cache.has_extremes) return;
+    cache.diameter = 0.0;
+    cache.radius = cache.node_count > 0 ? INF : 0.0;
+    cache.eccentricity_searches = 0;
+    for (PieceCache& piece : cache.pieces) {
+        if (piece.adj_list.empty()) continue;
+        if (piece.has_distances && !piece.eccentricity) {
+            const auto& dist = *piece.distance_matrix;
+            double diam = 0.0, rad = INF;
+            #pragma omp parallel for schedule(static) reduction(max:diam) reduction(min:rad)
+            for (int s = 0; s < static_cast<int>(dist.size()); ++s) {
+                double ecc = 0.0;
+                for (double d : dist[s]) {
+                    if (d != INF) ecc = std::max(ecc, d);
+                }
+                diam = std::max(diam, ecc);
+                rad = std::min(rad, ecc);
+            }
+            cache.diameter = std::max(cache.diameter, diam);
+            cache.radius = std::min(cache.radius, rad);
+        } else {
+            EccentricityEngine& engine = pieceEccentricity(piece);
+            cache.diameter = std::max(cache.diameter, engine.diameter());
+            cache.radius = std::min(cache.radius, engine.radius());
+            cache.eccentricity_searches += engine.searches_used();
+        }
+    }
+    cache.has_extremes = true;
+}
+
+// Largest distance found by a double sweep (a search from vertex 0, then one
+// from the farthest vertex it reached): a lower bound on the piece's diameter
+// that is usually exact, for two searches
+static double sweptDiameter(const PieceCache& piece) {
+    if (piece.adj_list.size() < 2) return 0.0;
+    ShortestPath sp(piece.adj_list);
+    int from = 0;
+    double diam = 0.0;
+    for (int sweep = 0; sweep < 2; ++sweep) {
+        std::vector<double> dist = sp.compute_single_source(from);
+        for (int v = 0; v < static_cast<int>(dist.size()); ++v) {
+            if (dist[v] != INF && dist[v] > diam) {
+                diam = dist[v];
+                from = v;
+            }
+        }
+    }
+    return diam;
+}
+
+ComputeCache::ComputeCache() = default;
+ComputeCache::~ComputeCache() = default;
+
+void ComputeCache::invalidate() {
+    state.reset();
+}
+
+GraphCache& ComputeCache::forGraph(const Graph* graph, const QString& vertex_order) {
+    if (!state || state->graph != graph || state->node_count != graph->nodes.size() ||
+        state->edge_count != graph->edges.size() || state->vertex_order != vertex_order) {
+        state = std::make_unique<GraphCache>();
+        buildGraphCache(*state, graph, vertex_order);
+    }
+    return *state;
+}
+
+GraphCache* ComputeCache::find(const Graph* graph) const {
+    if (!state || state->graph != graph || state->node_count != graph->nodes.size() ||
+        state->edge_count != graph->edges.size()) {
+        return nullptr;
+    }
+    return state.get();
+}
+
+// Witness vertices as a list, empty when the value has no witness (delta 0)
+static std::vector<int> witnessIds(const BaseWitness& w) {
+    if (w.r < 0 || (w.r == w.i && w.i == w.j && w.j == w.k)) return {};
+    return {w.r, w.i, w.j, w.k};
+}
+
+static std::vector<int> witnessIds(const std::pair<int, int>& pair) {
+    if (pair.first < 0) return {};
+    return {pair.first, pair.second};
+}
+
+static QStringList witnessNames(const std::vector<int>& ids, const QVector<QString>& names) {
+    QStringList witness;
+    for (int id : ids) witness.append(names[id]);
+    return witness;
+}
+
+// Runs the method on one connected piece, reusing and extending what earlier
+// runs left in its cache.
+static MethodOutcome runMethod(const MethodSettings& settings, PieceCache& piece) {
+    MethodOutcome out;
+    const auto& adj_list = piece.adj_list;
+
+    // The Log approximation only needs random-access distances, so it can run
+    // on the label oracle instead of an n x n matrix (unless one is cached)
+    if (settings.method == Method::Log && settings.use_distance_oracle && !piece.has_distances) {
+        DistanceOracle oracle(adj_list);
+        if (!oracle.build_labels()) {
+            oracle.build_landmarks(LANDMARK_FALLBACK_COUNT);
+        }
+        out.used_oracle = true;
+        out.oracle_exact = oracle.has_labels();
+        out.oracle_build_ms = oracle.build_ms();
+        out.oracle_bytes = oracle.memory_bytes();
+        out.oracle_query_ns = oracle.measure_query_ns();
+
+        LogApproxHyperbolicity log_approx(oracle, adj_list);
+        out.hyperbolicity = log_approx.compute_approximate_hyperbolicity();
+        out.witness = witnessIds(log_approx.distortion_witness());
+        return out;
+    }
+
+    out.reused_distances = piece.has_distances;
+    if (!piece.has_distances) {
+        ShortestPath sp(adj_list);
+        piece.distance_matrix = std::make_shared<const std::vector<std::vector<double>>>(sp.compute_all_pairs());
+        piece.base_deltas.assign(adj_list.size(), std::numeric_limits<double>::quiet_NaN());
+        piece.base_witnesses.assign(adj_list.size(), BaseWitness{});
+        piece.has_distances = true;
+    }
+    const auto& distance_matrix = *piece.distance_matrix;
+    const int n = distance_matrix.size();
+
+    if (settings.method == Method::Exact) {
+        for (double delta_r : piece.base_deltas) {
+            if (!std::isnan(delta_r)) ++out.reused_bases;
+        }
+        HyperbolicityCalculator exact_calc(distance_matrix);
+        exact_calc.set_max_min_backend(settings.max_min_backend);
+        exact_calc.set_matrix_memory(settings.memory);
+        out.hyperbolicity = exact_calc.compute_exact_hyperbolicity(piece.base_deltas, &piece.base_witnesses);
+        out.lower_bound = out.upper_bound = out.hyperbolicity;
+        out.witness = witnessIds(strongest_witness(piece.base_deltas, piece.base_witnesses));
+    } else if ((settings.method == Method::Factor2 || settings.method == Method::Factor2MultiBase) && n > 0) {
+        TwoFactorApproximation approx_calc(distance_matrix, pieceEccentricity(piece));
+        approx_calc.set_max_min_backend(settings.max_min_backend);
+        approx_calc.set_matrix_memory(settings.memory);
+        std::vector<int> bases;
+        if (settings.method == Method::Factor2) {
+            if (piece.heuristic_base < 0) piece.heuristic_base = approx_calc.select_base_heuristic();
+            bases = {piece.heuristic_base};
+        } else {
+            auto key = std::make_tuple(settings.num_bases, static_cast<int>(settings.base_selection), settings.seed);
+            auto found = piece.chosen_bases.find(key);
+            if (found == piece.chosen_bases.end()) {
+                // Ranked by graph id, so a seed picks the same bases whatever the vertex order
+                found = piece.chosen_bases.emplace(key, approx_calc.select_bases(settings.num_bases,
+                                                                                 settings.base_selection,
+                                                                                 settings.seed,
+                                                                                 piece.vertices)).first;
+            }
+            bases = found->second;
+        }
+        int known = 0;
+        for (int r : bases) {
+            if (!std::isnan(piece.base_deltas[r])) ++known;
+        }
+        MultiBaseResult mb = approx_calc.evaluate_bases(bases, piece.base_deltas, &piece.base_witnesses);
+        out.reused_bases = known;
+        out.lower_bound = mb.lower_bound;
+        out.upper_bound = mb.upper_bound;
+        out.hyperbolicity = mb.upper_bound;
+        out.bases = mb.bases;
+        out.witness = witnessIds(mb.witness);
+    } else if (settings.method == Method::Log) {
+        if (!piece.has_log_value) {
+            LogApproxHyperbolicity log_approx(distance_matrix, adj_list);
+            if (!piece.has_log_tree) {
+                piece.log_tree = log_approx.construct_approximation_tree();
+                piece.has_log_tree = true;
+            }
+            piece.log_value = log_approx.compute_approximate_hyperbolicity(piece.log_tree);
+            piece.log_witness = log_approx.distortion_witness();
+            piece.has_log_value = true;
+        }
+        out.hyperbolicity = piece.log_value;
+        out.witness = witnessIds(piece.log_witness);
+    } else if (settings.method == Method::LocalHops || settings.method == Method::LocalRadius) {
+        LocalOptions local_options;
+        local_options.kind = settings.method == Method::LocalHops ? BallKind::Hops : BallKind::Radius;
+        local_options.size = settings.method == Method::LocalHops ? settings.local_hops : settings.local_radius;
+        local_options.max_min_backend = settings.max_min_backend;
+        local_options.memory = settings.memory;
+        out.local = LocalHyperbolicity(distance_matrix, adj_list).compute(local_options);
+        // The least tree-like ball sets the value; it bounds delta from below
+        for (int v = 0; v < n; ++v) {
+            if (out.local.delta[v] > out.hyperbolicity) {
+                out.hyperbolicity = out.local.delta[v];
+                out.witness = witnessIds(out.local.witness[v]);
+            }
+        }
+        out.lower_bound = out.hyperbolicity;
+    }
+    return out;
+}
+
+// Components at least this large run one at a time with every thread on the
+// kernels; smaller ones are spread across threads, one component per thread.
+constexpr size_t PARALLEL_COMPONENT_SIZE = 512;
+
+// Runs in progress in this process (the service computes several at once).
+// The kernel keeps a single peak RSS per process, so PeakMemory only reports
+// for a run that had the process to itself from start to end.
+static std::atomic<int> active_runs{0};
+static std::atomic<long long> runs_started{0};
+
+struct ActiveRun {
+    ActiveRun() : started(++runs_started) { ++active_runs; }
+    ~ActiveRun() { --active_runs; }
+    bool alone() const { return active_runs.load() == 1 && runs_started.load() == started; }
+    const long long started;
+};
+
+HyperResult computeHyperbolicity(const Graph* graph, const QString& method, const QString& input_filename,
+                                 const ComputeOptions& options, ComputeCache* cache) {
+    if (method == "Auto") {
+        ComputePlan plan = planComputation(graph, options, cache);
+        if (plan.chosen < 0) {
+            throw std::runtime_error("No method fits in the memory budget.");
+        }
+        const PlanCandidate& pick = plan.candidates[plan.chosen];
+        ComputeOptions planned_options = options;
+        planned_options.max_min_backend = pick.max_min_backend;
+        planned_options.use_distance_oracle = pick.use_distance_oracle;
+        planned_options.measure_peak_memory = true;
+        HyperResult result = computeHyperbolicity(graph, pick.method, input_filename, planned_options, cache);
+        result.planned = true;
+        result.predicted_seconds = pick.seconds;
+        result.predicted_bytes = pick.bytes;
+        return result;
+    }
 
+    HyperResult result;
+    auto overall_start_time = std::chrono::steady_clock::now();
+    ActiveRun active;
+    // Resetting the peak RSS counter is a write to /proc, so only runs whose
+    // prediction is checked against it pay for it
+    std::unique_ptr<PeakMemory> peak_memory;
+    if (options.measure_peak_memory && active.alone()) peak_memory = std::make_unique<PeakMemory>();
+
+    MethodSettings settings;
+    settings.method = parseMethod(method);
+    settings.num_bases = options.num_bases;
+    settings.base_selection = parseBaseSelection(options.base_selection);
+    settings.seed = options.seed;
+    settings.max_min_backend = parseMaxMinBackend(options.max_min_backend);
+    settings.use_distance_oracle = options.use_distance_oracle;
+    settings.local_hops = options.local_hops;
+    settings.local_radius = options.local_radius;
+    settings.memory.huge_pages = options.huge_pages;
+    if (settings.method == Method::LocalRadius && !(options.local_radius >= 0)) {
+        throw std::invalid_argument("Local hyperbolicity: the ball radius must be non-negative.");
+    }
+    if (settings.method == Method::LocalHops && options.local_hops < 0) {
+        throw std::invalid_argument("Local hyperbolicity: the hop count must be non-negative.");
+    }
+
+    // Pins this caller's OpenMP team for the run only
+    ThreadPinning pinning(options.pin_threads);
+    MemoryCounters counters;
+    settings.memory.usage = counters.huge_pages();
+    counters.start();
     
-    // Compute hyperbolicity
-    if (method == "Exact Algorithm") {
-        HyperbolicityCalculator exact_calc(result.distance_matrix);
-        double delta_r = exact_calc.compute_exact_hyperbolicity();
-        result.hyperbolicity = delta_r;//delta_r;
-
-    } else if (method == "Factor-2 Approximation") {
-        TwoFactorApproximation approx_calc(result.distance_matrix);
-        result.hyperbolicity = approx_calc.compute_approximate_hyperbolicity();
-    } else if (method == "Log Approximation") {
-        LogApproxHyperbolicity log_approx(result.distance_matrix, adj_list);
-        result.hyperbolicity = log_approx.compute_approximate_hyperbolicity();
+    // Capture node order
+    result.method = method;
+    result.node_order = graph->nodes.toVector();
+
+    // Without a caller-owned cache everything is built for this run only
+    ComputeCache local_cache;
+    GraphCache& graph_cache = (cache ? cache : &local_cache)->forGraph(graph, options.vertex_order);
+    result.vertex_order = graph_cache.applied_order;
+    result.order_ms = graph_cache.order_ms;
+    result.edge_gap_before = graph_cache.edge_gap_before;
+    result.edge_gap_after = graph_cache.edge_gap_after;
+
+    std::vector<PieceCache>& pieces = graph_cache.pieces;
+    std::vector<MethodOutcome> outcomes;
+
+    if (pieces.size() <= 1) {
+        // Connected: one global distance matrix
+        const PieceCache& piece = pieces[0];
+        outcomes.push_back(runMethod(settings, pieces[0]));
+        auto global = [&piece](int v) { return piece.vertices.empty() ? v : piece.vertices[v]; };
+        // The cached matrix is shared; a renumbered piece says which node each row is
+        result.distance_matrix = piece.distance_matrix;
+        result.matrix_vertices = piece.vertices;
+        for (int r : outcomes[0].bases) {
+            result.bases.append(result.node_order[global(r)]);
+        }
+        std::vector<int> global_ids;
+        for (int v : outcomes[0].witness) global_ids.push_back(global(v));
+        result.witness = witnessNames(global_ids, result.node_order);
+    } else {
+        // Disconnected: a compact distance matrix and engine run per component,
+        // so memory is the sum of squared component sizes instead of n^2
+        const int count = pieces.size();
+        result.components.resize(count);
+        outcomes.resize(count);
+
+        auto run_part = [&](int c) {
+            ComponentResult& part_result = result.components[c];
+            part_result.vertices = pieces[c].vertices;
+            outcomes[c] = runMethod(settings, pieces[c]);
+            part_result.distance_matrix = pieces[c].distance_matrix;   // Shared, not copied
+            part_result.hyperbolicity = outcomes[c].hyperbolicity;
+        };
+
+        // Components come largest first
+        int c = 0;
+        for (; c < count && pieces[c].vertices.size() >= PARALLEL_COMPONENT_SIZE; ++c) {
+            run_part(c);
+        }
+
+        std::exception_ptr failure;
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int s = c; s < count; ++s) {
+            try {
+                run_part(s);
+            } catch (...) {
+                #pragma omp critical
+                failure = std::current_exception();
+            }
+        }
+        if (failure) std::rethrow_exception(failure);
+
+        for (int p = 0; p < count; ++p) {
+            for (int r : outcomes[p].bases) {
+                result.bases.append(result.node_order[pieces[p].vertices[r]]);
+            }
+        }
+        // The witness comes from the component that sets delta
+        int top = 0;
+        for (int p = 1; p < count; ++p) {
+            if (outcomes[p].hyperbolicity > outcomes[top].hyperbolicity) top = p;
+        }
+        std::vector<int> global_ids;
+        for (int v : outcomes[top].witness) global_ids.push_back(pieces[top].vertices[v]);
+        result.witness = witnessNames(global_ids, result.node_order);
+    }
+
+    // Local profile in node order
+    if (settings.method == Method::LocalHops || settings.method == Method::LocalRadius) {
+        const int n = result.node_order.size();
+        result.local_ball = settings.method == Method::LocalHops ? "hops" : "radius";
+        result.local_size = settings.method == Method::LocalHops ? settings.local_hops : settings.local_radius;
+        result.local_delta.assign(n, 0.0);
+        result.local_ball_size.assign(n, 0);
+        for (size_t p = 0; p < pieces.size(); ++p) {
+            const LocalProfile& local = outcomes[p].local;
+            for (size_t v = 0; v < local.delta.size(); ++v) {
+                const int id = pieces[p].vertices.empty() ? v : pieces[p].vertices[v];
+                result.local_delta[id] = local.delta[v];
+                result.local_ball_size[id] = local.ball_size[v];
+            }
+        }
+    }
+
+    // delta of a disconnected graph is the largest delta over its components
+    result.hyperbolicity = 0.0;
+    result.reused_distances = true;
+    for (const MethodOutcome& out : outcomes) {
+        result.hyperbolicity = std::max(result.hyperbolicity, out.hyperbolicity);
+        result.lower_bound = std::max(result.lower_bound, out.lower_bound);
+        result.upper_bound = std::max(result.upper_bound, out.upper_bound);
+        result.reused_distances = result.reused_distances && out.reused_distances;
+        result.reused_bases += out.reused_bases;
+        result.local_distinct_balls += out.local.distinct_balls;
+        result.local_settled_early += out.local.settled_early;
+        result.local_bases += out.local.bases_evaluated;
+        if (out.used_oracle) {
+            result.used_distance_oracle = true;
+            result.oracle_exact = result.oracle_exact && out.oracle_exact;
+            result.oracle_build_ms += out.oracle_build_ms;
+            result.oracle_bytes += out.oracle_bytes;
+            // Latency of the largest piece is the representative one
+            if (result.oracle_query_ns == 0.0) result.oracle_query_ns = out.oracle_query_ns;
+        }
     }
     // --- End Hyperbolicity Algorithm Computation ---
 
+    // After the run, so they come from its distance rows where it made some
+    graphExtremes(graph_cache);
+    result.diameter = graph_cache.diameter;
+    result.radius = graph_cache.radius;
+    result.eccentricity_searches = graph_cache.eccentricity_searches;
+
+    MemoryMetrics metrics = counters.stop();
+    result.memory_counters = metrics.available;
+    result.tlb_misses = metrics.tlb_misses;
+    result.remote_accesses = metrics.remote_accesses;
+    result.cache_misses = metrics.cache_misses;
+    result.huge_page_bytes = metrics.huge_page_bytes;
+    result.peak_bytes = peak_memory && active.alone() ? peak_memory->added_bytes() : 0;
 
     // --- Calculate and store TOTAL duration in MICROSECONDS ---
     auto overall_end_time = std::chrono::steady_clock::now(); // Use steady_clock
@@ -137,89 +779,540 @@ HyperResult computeHyperbolicity(const Graph* graph, const QString& method, cons
     return result;
 }
 
+ComputePlan planComputation(const Graph* graph, const ComputeOptions& options, ComputeCache* cache,
+                            bool allow_sharded) {
+    ComputeCache local_cache;
+    const GraphCache& graph_cache = (cache ? cache : &local_cache)->forGraph(graph, options.vertex_order);
+
+    GraphProfile profile;
+    for (const PieceCache& piece : graph_cache.pieces) {
+        long long entries = 0;
+        for (const auto& neighbours : piece.adj_list) entries += neighbours.size();
+        profile.component_vertices.push_back(piece.adj_list.size());
+        profile.component_entries.push_back(entries);
+    }
+    // Integral weights: at most diameter + 1 distinct distances
+    bool integral = true;
+    for (const Edge& edge : graph->edges) {
+        if (edge.weight != std::floor(edge.weight)) {
+            integral = false;
+            break;
+        }
+    }
+    if (integral) {
+        // An estimate is enough here, so no bounding run unless one is cached
+        double diameter = 0.0;
+        if (graph_cache.has_extremes) {
+            diameter = graph_cache.diameter;
+        } else {
+            for (const PieceCache& piece : graph_cache.pieces) diameter = std::max(diameter, sweptDiameter(piece));
+        }
+        if (diameter + 1 <= PLANNER_MAX_LEVELS) profile.distance_levels = static_cast<int>(diameter) + 1;
+    }
+
+    ComputePlan plan;
+    plan.threads = omp_get_max_threads();
+    plan.budget_seconds = std::max(0.0, options.time_budget_s);
+    plan.budget_bytes = options.memory_budget_mb > 0 ? options.memory_budget_mb * 1024.0 * 1024.0
+                                                     : static_cast<double>(available_memory_bytes());
+    if (plan.budget_bytes <= 0) plan.budget_bytes = std::numeric_limits<double>::infinity();
+
+    PlanBudget budget;
+    budget.seconds = plan.budget_seconds;
+    budget.bytes = plan.budget_bytes;
+    budget.threads = plan.threads;
+    budget.multi_bases = options.num_bases;
+    budget.shard_workers = options.shard_workers;
+    // A shard job holds one distance matrix, so only connected graphs qualify
+    budget.allow_disk = allow_sharded && profile.component_vertices.size() <= 1;
+
+    std::vector<PlanEstimate> estimates = estimate_plans(profile, budget);
+    for (const PlanEstimate& estimate : estimates) {
+        PlanCandidate candidate;
+        switch (estimate.engine) {
+        case PlanEngine::Exact: candidate.method = "Exact Algorithm"; break;
+        case PlanEngine::ExactSharded: candidate.method = "Exact Algorithm (Sharded)"; break;
+        case PlanEngine::Factor2MultiBase: candidate.method = "Factor-2 Multi-base Approximation"; break;
+        case PlanEngine::Factor2: candidate.method = "Factor-2 Approximation"; break;
+        case PlanEngine::Log:
+        case PlanEngine::LogOracle: candidate.method = "Log Approximation"; break;
+        }
+        candidate.max_min_backend = estimate.kernel == MaxMinBackend::Dense ? "Dense"
+                                  : estimate.kernel == MaxMinBackend::ThresholdBitset ? "Threshold Bitset"
+                                  : "Auto";
+        candidate.use_distance_oracle = estimate.engine == PlanEngine::LogOracle;
+        candidate.seconds = estimate.seconds;
+        candidate.bytes = estimate.bytes;
+        candidate.disk_bytes = estimate.disk_bytes;
+        candidate.fits_time = estimate.fits_time;
+        candidate.fits_memory = estimate.fits_memory;
+        plan.candidates.append(candidate);
+    }
+    plan.chosen = choose_plan(estimates);
+    return plan;
+}
+
+QVector<HyperResult> compareAllMethods(const Graph* graph, const QString& input_filename,
+                                       const ComputeOptions& options, ComputeCache* cache) {
+    ComputeCache local_cache;
+    ComputeCache* shared = cache ? cache : &local_cache;
 
+    // The matrix is computed anyway, so the Log run reads it instead of an oracle
+    ComputeOptions shared_options = options;
+    shared_options.use_distance_oracle = false;
 
+    QVector<HyperResult> results;
+    for (const QString& method : {QString("Factor-2 Approximation"), QString("Exact Algorithm"),
+                                  QString("Log Approximation")}) {
+        results.append(computeHyperbolicity(graph, method, input_filename, shared_options, shared));
+    }
+    return results;
+}
 
-QPixmap drawGraph(const Graph* graph, const QSize& size) {
-    QPixmap pixmap(size);
-    pixmap.fill(Qt::white);
-    QPainter painter(&pixmap);
-    painter.setRenderHint(QPainter::Antialiasing, true);
 
-    // QList<QString> nodeList = graph->nodes.values();
-    QList<QString> nodeList = graph->nodes; 
-    std::sort(nodeList.begin(), nodeList.end());
-    if (nodeList.size() > 50) nodeList = nodeList.mid(0, 50);
+// --- Sharded exact ---
+// Claims not refreshed for this long go back to the queue (workers refresh every 10 s)
+constexpr double SHARD_LEASE_SECONDS = 60.0;
+constexpr int SHARD_POLL_MS = 1000;
+// Automatic shard size: a few shards per worker keeps the load balanced and
+// bounds the work lost with a worker
+constexpr int SHARDS_PER_WORKER = 8;
+// Give up once this many worker processes have failed
+constexpr int MAX_WORKER_FAILURES = 3;
 
-    const int n = nodeList.size();
-    const QPoint center(size.width()/2, size.height()/2);
-    const int radius = std::min(size.width(), size.height())/2 - 50;
-    QMap<QString, QPoint> positions;
+HyperResult computeShardedExact(const Graph* graph, const QString& jobDir, const ComputeOptions& options,
+                                const std::atomic<bool>* cancel) {
+    ActiveRun active;
+    HyperResult result;
+    auto start_time = std::chrono::steady_clock::now();
+    result.method = "Exact Algorithm (Sharded)";
+    result.node_order = graph->nodes.toVector();
+    result.job_dir = jobDir;
 
-    for (int i = 0; i < n; ++i) {
-        double angle = 2 * M_PI * i / n;
-        positions[nodeList[i]] = QPoint(
-            center.x() + static_cast<int>(radius * cos(angle)),
-            center.y() + static_cast<int>(radius * sin(angle))
-        );
+    std::vector<std::vector<std::pair<int, double>>> adj_list = adjacencyList(graph);
+    const int n = adj_list.size();
+    const int workers = std::max(1, options.shard_workers);
+    if (ConnectedComponents(adj_list).count() > 1) {
+        throw std::runtime_error("Sharded exact runs need a connected graph; use the exact method, "
+                                 "which evaluates every component on its own");
     }
+    EccentricityEngine ecc_engine(adj_list);
+    result.diameter = ecc_engine.diameter();
+    result.radius = ecc_engine.radius();
+    result.eccentricity_searches = ecc_engine.searches_used();
 
-    painter.setPen(QPen(Qt::gray, 2));
-    for (const Edge& edge : graph->edges) {
-        if (positions.contains(edge.source) && positions.contains(edge.target)) {
-            painter.drawLine(positions[edge.source], positions[edge.target]);
+    // Resume when the directory holds a job for this very graph, else start over
+    ShardJob job(jobDir.toStdString());
+    const std::uint64_t fingerprint = ShardJob::fingerprint(adj_list);
+    if (job.open() && job.info().fingerprint == fingerprint && job.info().nodes == n) {
+        result.reused_distances = true;
+        result.shards_resumed = job.progress().done;
+        for (double delta_r : job.base_deltas()) {
+            if (!std::isnan(delta_r)) ++result.bases_resumed;
+        }
+    } else {
+        ShortestPath sp(adj_list);
+        int shard_size = options.shard_size;
+        if (shard_size <= 0) {
+            shard_size = std::max(1, (n + workers * SHARDS_PER_WORKER - 1) / (workers * SHARDS_PER_WORKER));
         }
+        job.create(sp.compute_all_pairs(), fingerprint, shard_size);
     }
-//-------------------
-    // Draw edges with weights
-    painter.setPen(QPen(Qt::gray, 2));
-    QFont weightFont = painter.font();
-    weightFont.setPointSize(10);
-    painter.setFont(weightFont);
+    result.shards = job.info().shard_count;
 
-    for (const Edge& edge : graph->edges) {
-        if (positions.contains(edge.source) && positions.contains(edge.target)) {
-            QPoint p1 = positions[edge.source];
-            QPoint p2 = positions[edge.target];
-            
-            // Draw edge line
-            painter.drawLine(p1, p2);
-
-            // Only draw weight once per edge pair (A-B and B-A)
-            if (nodeList.indexOf(edge.source) < nodeList.indexOf(edge.target)) {
-                // Calculate midpoint with offset
-                QPoint midpoint = (p1 + p2) / 2;
-                QPoint textOffset(10, -5);
-                
-                // Draw weight background
-                painter.setBrush(QColor(255, 255, 255, 200));  // Semi-transparent white
-                painter.setPen(Qt::NoPen);
-                QRect textRect = painter.boundingRect(QRect(), Qt::AlignCenter, 
-                    QString::number(edge.weight, 'f', 2));
-                textRect.moveTo(midpoint + textOffset);
-                painter.drawRect(textRect);
-                
-                // Draw weight text
-                painter.setPen(Qt::darkBlue);
-                painter.drawText(midpoint + textOffset, 
-                    QString::number(edge.weight, 'f', 2));
-                
-                // Reset pen for next edge
-                painter.setPen(QPen(Qt::gray, 2));
+    // Local workers are this executable in worker mode, sharing the cores
+    struct Worker {
+        std::unique_ptr<QProcess> process;
+        bool reaped = false;
+    };
+    std::vector<Worker> local;
+    const int threads = std::max(1, QThread::idealThreadCount() / workers);
+    int failures = 0;
+    auto launch = [&]() {
+        QStringList arguments = {"--shard-worker", jobDir,
+                                 "--worker-id", QString("%1-%2-%3").arg(QSysInfo::machineHostName())
+                                                    .arg(QCoreApplication::applicationPid()).arg(local.size()),
+                                 "--kernel", options.max_min_backend,
+                                 "--threads", QString::number(threads)};
+        Worker worker;
+        worker.process = std::make_unique<QProcess>();
+        worker.process->start(QCoreApplication::applicationFilePath(), arguments);
+        if (!worker.process->waitForStarted()) {
+            throw std::runtime_error("Cannot start shard worker: " + worker.process->errorString().toStdString());
+        }
+        local.push_back(std::move(worker));
+    };
+
+    while (true) {
+        // Local workers die with their QProcess; checkpoints stay for a resume
+        if (cancel && cancel->load()) {
+            throw std::runtime_error("Sharded run cancelled; choose the same job directory to resume it");
+        }
+        result.shards_requeued += job.requeue_stale(SHARD_LEASE_SECONDS);
+        ShardProgress progress = job.progress();
+        if (progress.done >= result.shards) break;
+
+        int running = 0;
+        for (Worker& worker : local) {
+            if (worker.reaped) continue;
+            if (worker.process->state() != QProcess::NotRunning && !worker.process->waitForFinished(0)) {
+                ++running;
+                continue;
+            }
+            worker.reaped = true;
+            if (worker.process->exitStatus() != QProcess::NormalExit || worker.process->exitCode() != 0) {
+                QString error = QString::fromLocal8Bit(worker.process->readAllStandardError()).trimmed();
+                if (++failures >= MAX_WORKER_FAILURES) {
+                    throw std::runtime_error("Shard workers keep failing: " + error.toStdString());
+                }
             }
         }
+        // Waiting shards (new, or requeued from a lost worker) get fresh workers
+        for (int w = running; w < workers && w < running + progress.todo; ++w) {
+            launch();
+        }
+
+        // Remaining claims belong to live or not yet expired workers
+        QThread::msleep(SHARD_POLL_MS);
+    }
+
+    std::vector<double> base_deltas = job.base_deltas();
+    result.witness = witnessNames(witnessIds(strongest_witness(base_deltas, job.base_witnesses())), result.node_order);
+    result.hyperbolicity = 0.0;
+    for (double delta_r : base_deltas) {
+        if (std::isnan(delta_r)) {
+            throw std::runtime_error("Sharded job finished with bases missing from its checkpoints");
+        }
+        result.hyperbolicity = std::max(result.hyperbolicity, delta_r);
     }
-//-----------------------------
+    result.lower_bound = result.upper_bound = result.hyperbolicity;
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+    result.total_duration_ms = duration.count();
+    return result;
+}
 
-    const int nodeSize = 20;
-    painter.setBrush(Qt::lightGray);
-    painter.setPen(Qt::black);
-    for (auto it = positions.begin(); it != positions.end(); ++it) {
-        QPoint pos = it.value();
-        painter.drawEllipse(pos, nodeSize, nodeSize);
-        painter.drawText(QRect(pos.x()-nodeSize, pos.y()-nodeSize, 
-                            2*nodeSize, 2*nodeSize), Qt::AlignCenter, it.key());
+// --- Export ---
+qint64 exportDistanceMatrix(const Graph* graph, const QString& path, ComputeCache* cache) {
+    ActiveRun active;
+    const int n = graph->nodes.size();
+    const MatrixFormat format = path.endsWith(".bin", Qt::CaseInsensitive) ? MatrixFormat::Raw
+                                                                           : MatrixFormat::Compressed;
+    DistanceMatrixWriter writer(path.toStdString(), n, format);
+
+    GraphCache* cached = cache ? cache->find(graph) : nullptr;
+    bool have_all = cached && !cached->pieces.empty();
+    if (have_all) {
+        for (const PieceCache& piece : cached->pieces) have_all = have_all && piece.has_distances;
     }
 
-    return pixmap;
-}
\ No newline at end of file
+    if (have_all && cached->pieces.size() == 1 && cached->pieces[0].vertices.empty()) {
+        for (int i = 0; i < n; ++i) writer.write_row(i, (*cached->pieces[0].distance_matrix)[i].data());
+    } else if (have_all) {
+        // Rows are spread back out from the component (or renumbered)
+        // matrices; vertices of other components are at infinity
+        std::vector<int> piece_of(n), local_of(n);
+        for (size_t c = 0; c < cached->pieces.size(); ++c) {
+            const std::vector<int>& vertices = cached->pieces[c].vertices;
+            for (size_t l = 0; l < vertices.size(); ++l) {
+                piece_of[vertices[l]] = c;
+                local_of[vertices[l]] = l;
+            }
+        }
+        std::vector<double> row(n);
+        for (int i = 0; i < n; ++i) {
+            const PieceCache& piece = cached->pieces[piece_of[i]];
+            const std::vector<double>& local = (*piece.distance_matrix)[local_of[i]];
+            std::fill(row.begin(), row.end(), INF);
+            for (size_t l = 0; l < piece.vertices.size(); ++l) row[piece.vertices[l]] = local[l];
+            writer.write_row(i, row.data());
+        }
+    } else {
+        std::vector<std::vector<std::pair<int, double>>> adj_list = adjacencyList(graph);
+        ShortestPath sp(adj_list);
+        sp.compute_all_pairs([&writer](int i, const std::vector<double>& row) {
+            writer.write_row(i, row.data());
+        });
+    }
+    writer.finish();
+
+    QFile names(path + ".nodes");
+    if (!names.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        throw std::runtime_error("Cannot write " + names.fileName().toStdString());
+    }
+    for (const QString& node : graph->nodes) {
+        names.write(node.toUtf8());
+        names.write("\n");
+    }
+    return static_cast<qint64>(writer.bytes_written());
+}
+
+bool cachedDistanceRow(const Graph* graph, int source, const ComputeCache& cache, std::vector<double>& row) {
+    const GraphCache* cached = cache.find(graph);
+    if (!cached || source < 0 || source >= graph->nodes.size()) return false;
+    if (cached->piece_of[source] < 0) return false;
+    const PieceCache& piece = cached->pieces[cached->piece_of[source]];
+    if (!piece.has_distances) return false;
+    const std::vector<double>& local = (*piece.distance_matrix)[cached->local_of[source]];
+    // A connected graph in file order is one piece without a vertex list
+    if (piece.vertices.empty()) {
+        row = local;
+        return true;
+    }
+    row.assign(graph->nodes.size(), INF);
+    for (size_t l = 0; l < piece.vertices.size(); ++l) row[piece.vertices[l]] = local[l];
+    return true;
+}
+
+static QJsonArray jsonStrings(const QStringList& values) {
+    QJsonArray array;
+    for (const QString& value : values) array.append(value);
+    return array;
+}
+
+QByteArray resultJsonLine(const HyperResult& result, const QString& input_filename) {
+    QJsonObject line;
+    line["method"] = result.method;
+    if (!input_filename.isEmpty()) line["file"] = input_filename;
+    line["nodes"] = static_cast<int>(result.node_order.size());
+    line["hyperbolicity"] = result.hyperbolicity;
+    line["lower_bound"] = result.lower_bound;
+    // Local runs only bound delta from below; JSON has no infinity
+    if (result.local_ball.isEmpty()) line["upper_bound"] = result.upper_bound;
+    if (!result.bases.isEmpty()) line["bases"] = jsonStrings(result.bases);
+    if (!result.witness.isEmpty()) line["witness"] = jsonStrings(result.witness);
+    line["duration_us"] = result.total_duration_ms;
+    line["diameter"] = result.diameter;
+    line["radius"] = result.radius;
+    if (!result.components.empty()) line["components"] = static_cast<int>(result.components.size());
+    line["reused_distances"] = result.reused_distances;
+    line["reused_bases"] = result.reused_bases;
+    if (result.peak_bytes > 0) line["peak_bytes"] = static_cast<long long>(result.peak_bytes);
+    if (result.planned) {
+        QJsonObject plan;
+        plan["predicted_seconds"] = result.predicted_seconds;
+        plan["predicted_bytes"] = result.predicted_bytes;
+        line["plan"] = plan;
+    }
+
+    if (result.used_distance_oracle) {
+        QJsonObject oracle;
+        oracle["exact"] = result.oracle_exact;
+        oracle["build_ms"] = result.oracle_build_ms;
+        oracle["bytes"] = static_cast<long long>(result.oracle_bytes);
+        oracle["query_ns"] = result.oracle_query_ns;
+        line["distance_oracle"] = oracle;
+    }
+    if (result.incremental) {
+        QJsonObject incremental;
+        incremental["changed_pairs"] = static_cast<long long>(result.changed_pairs);
+        incremental["repaired_sources"] = result.repaired_sources;
+        incremental["recomputed_sources"] = result.recomputed_sources;
+        incremental["bases_patched"] = result.bases_patched;
+        incremental["bases_recomputed"] = result.bases_recomputed;
+        incremental["full_recompute"] = result.full_recompute;
+        line["incremental"] = incremental;
+    }
+    QJsonObject memory;
+    memory["huge_page_bytes"] = static_cast<long long>(result.huge_page_bytes);
+    if (result.memory_counters) {
+        memory["tlb_misses"] = result.tlb_misses;
+        memory["remote_accesses"] = result.remote_accesses;
+        memory["cache_misses"] = result.cache_misses;
+    }
+    line["memory"] = memory;
+    if (!result.vertex_order.isEmpty()) {
+        QJsonObject order;
+        order["vertex_order"] = result.vertex_order;
+        order["ms"] = result.order_ms;
+        order["edge_gap_before"] = result.edge_gap_before;
+        order["edge_gap_after"] = result.edge_gap_after;
+        line["order"] = order;
+    }
+    if (!result.local_ball.isEmpty()) {
+        QJsonObject local;
+        local["ball"] = result.local_ball;
+        local["size"] = result.local_size;
+        local["distinct_balls"] = result.local_distinct_balls;
+        local["settled_early"] = result.local_settled_early;
+        local["bases"] = result.local_bases;
+        QJsonArray vertices;
+        for (int v = 0; v < result.node_order.size(); ++v) {
+            QJsonObject vertex;
+            vertex["name"] = result.node_order[v];
+            vertex["delta"] = result.local_delta[v];
+            vertex["ball_size"] = result.local_ball_size[v];
+            vertices.append(vertex);
+        }
+        local["vertices"] = vertices;
+        line["local"] = local;
+    }
+    if (!result.job_dir.isEmpty()) {
+        QJsonObject sharded;
+        sharded["job_dir"] = result.job_dir;
+        sharded["shards"] = result.shards;
+        sharded["shards_resumed"] = result.shards_resumed;
+        sharded["bases_resumed"] = result.bases_resumed;
+        sharded["shards_requeued"] = result.shards_requeued;
+        line["sharded"] = sharded;
+    }
+    return QJsonDocument(line).toJson(QJsonDocument::Compact);
+}
+
+int runShardWorker(const QStringList& arguments) {
+    QString directory;
+    ShardWorkerOptions options;
+    for (int a = 1; a + 1 < arguments.size(); a += 2) {
+        const QString& flag = arguments[a];
+        const QString& value = arguments[a + 1];
+        if (flag == "--shard-worker") directory = value;
+        else if (flag == "--worker-id") options.worker_id = value.toStdString();
+        else if (flag == "--kernel") options.max_min_backend = parseMaxMinBackend(value);
+        else if (flag == "--threads") options.threads = value.toInt();
+    }
+    if (directory.isEmpty()) {
+        std::cerr << "Usage: hyperbolicity --shard-worker DIR [--worker-id ID] [--kernel NAME] [--threads N]"
+                  << std::endl;
+        return 2;
+    }
+    try {
+        int completed = run_shard_worker(directory.toStdString(), options);
+        std::cout << "Shard worker finished " << completed << " shard(s)" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Shard worker failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+
+
+// --- Incremental session ---
+bool DynamicSession::supports(const QString& method) {
+    Method m = parseMethod(method);
+    return m == Method::Exact || m == Method::Factor2 || m == Method::Factor2MultiBase;
+}
+
+DynamicSession::DynamicSession(Graph* graph, const QString& method, const ComputeOptions& options)
+    : graph(graph), method(method), pin_threads(options.pin_threads) {
+    auto start_time = std::chrono::steady_clock::now();
+    ActiveRun active;
+    ThreadPinning pinning(pin_threads);
+    Method m = parseMethod(method);
+    if (!supports(method)) {
+        throw std::invalid_argument("Incremental updates support the exact and Factor-2 methods only");
+    }
+
+    for (int i = 0; i < graph->nodes.size(); ++i) {
+        node_indices[graph->nodes[i]] = i;
+    }
+    std::vector<std::vector<std::pair<int, double>>> adj_list = adjacencyList(graph);
+
+    ShortestPath sp(adj_list);
+    std::vector<std::vector<double>> distance_matrix = sp.compute_all_pairs();
+
+    // Exact tracks every base; the Factor-2 methods keep the bases they would pick
+    std::vector<int> bases;
+    if (m != Method::Exact && !adj_list.empty()) {
+        // The matrix is at hand, so eccentricities are a scan of its rows
+        TwoFactorApproximation approx_calc(distance_matrix);
+        if (m == Method::Factor2) {
+            bases.push_back(approx_calc.select_base_heuristic());
+        } else {
+            bases = approx_calc.select_bases(options.num_bases, parseBaseSelection(options.base_selection),
+                                             options.seed);
+        }
+    }
+
+    engine = std::make_unique<DynamicHyperbolicity>(adj_list, bases);
+    MatrixMemoryConfig memory;
+    memory.huge_pages = options.huge_pages;
+    engine->set_matrix_memory(memory);
+    engine->initialize(parseMaxMinBackend(options.max_min_backend), std::move(distance_matrix));
+    refreshResult();
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+    current.total_duration_ms = duration.count();
+}
+
+DynamicSession::~DynamicSession() = default;
+
+const HyperResult& DynamicSession::applyEdits(const QVector<Edge>& edits) {
+    ActiveRun active;
+    std::vector<EdgeUpdate> batch;
+    for (const Edge& edit : edits) {
+        for (const QString& name : {edit.source, edit.target}) {
+            if (!node_indices.contains(name)) {
+                node_indices[name] = engine->add_vertex();
+            }
+        }
+        graph->setEdge(edit.source, edit.target, edit.weight);
+        batch.push_back({node_indices[edit.source], node_indices[edit.target], edit.weight});
+    }
+
+    ThreadPinning pinning(pin_threads);
+    DynamicUpdateStats stats = engine->apply(batch);
+    // Only rows with a changed distance can have a new eccentricity
+    eccentricity.resize(graph->nodes.size(), -1.0);
+    if (engine->all_changed()) {
+        eccentricity.assign(eccentricity.size(), -1.0);
+    } else {
+        for (const auto& [s, t] : engine->changed_pairs()) eccentricity[s] = eccentricity[t] = -1.0;
+    }
+    refreshResult();
+    current.incremental = true;
+    current.changed_pairs = stats.changed_pairs;
+    current.repaired_sources = stats.repaired_sources;
+    current.recomputed_sources = stats.recomputed_sources;
+    current.bases_patched = stats.bases_patched;
+    current.bases_recomputed = stats.bases_recomputed;
+    current.full_recompute = stats.full_recompute;
+    current.total_duration_ms = static_cast<long long>(stats.elapsed_ms * 1000.0);  // us, as elsewhere
+    return current;
+}
+
+const std::vector<std::vector<double>>& DynamicSession::distanceMatrix() const {
+    return engine->distance_matrix();
+}
+
+void DynamicSession::refreshResult() {
+    current = HyperResult();
+    current.node_order = graph->nodes.toVector();
+
+    // Diameter and radius from the per-row eccentricities (finite entries);
+    // rows marked -1, or new ones, are rescanned
+    const auto& dist = engine->distance_matrix();
+    eccentricity.resize(dist.size(), -1.0);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int s = 0; s < static_cast<int>(dist.size()); ++s) {
+        if (eccentricity[s] >= 0.0) continue;
+        double ecc = 0.0;
+        for (double d : dist[s]) {
+            if (d != INF) ecc = std::max(ecc, d);
+        }
+        eccentricity[s] = ecc;
+    }
+    current.radius = dist.empty() ? 0.0 : INF;
+    for (double ecc : eccentricity) {
+        current.diameter = std::max(current.diameter, ecc);
+        current.radius = std::min(current.radius, ecc);
+    }
+
+    const std::vector<double>& deltas = engine->base_deltas();
+    Method m = parseMethod(method);
+    current.witness = witnessNames(witnessIds(engine->max_base_witness()), current.node_order);
+    if (m == Method::Exact) {
+        current.hyperbolicity = engine->max_base_delta();
+        current.lower_bound = current.upper_bound = current.hyperbolicity;
+    } else if (!deltas.empty()) {
+        // delta_r <= delta <= 2 delta_r for every base
+        current.lower_bound = *std::max_element(deltas.begin(), deltas.end());
+        current.upper_bound = 2 * *std::min_element(deltas.begin(), deltas.end());
+        current.hyperbolicity = current.upper_bound;
+        for (int r : engine->tracked_bases()) {
+            current.bases.append(current.node_order[r]);
+        }
+    } else {
+        current.hyperbolicity = 0.0;
+    }
+}
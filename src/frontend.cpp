@@ -1,18 +1,36 @@
 #include "frontend.h"
 #include "backend.h"
+#include "GraphView.h"
 #include <QApplication>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QComboBox>
+#include <QSpinBox>
+#include <QCheckBox>
 #include <QPushButton>
-#include <QGraphicsView>
 #include <QLabel>
 #include <QTextEdit>
+#include <QStatusBar>
 #include <QFileDialog>
+#include <QInputDialog>
+#include <QFile>
+#include <QtConcurrent/QtConcurrent>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+
+struct ShardedRun {
+    HyperResult result;
+    QString error;     // Empty on success
+};
 
 HyperbolicityApp::HyperbolicityApp(QWidget *parent)
-    : QMainWindow(parent), graph(nullptr)
+    : QMainWindow(parent), graph(nullptr), computeCache(new ComputeCache()),
+      shardWatcher(new QFutureWatcher<ShardedRun>(this)), session(nullptr)
 {
+    connect(shardWatcher, &QFutureWatcher<ShardedRun>::finished, this, &HyperbolicityApp::shardedRunFinished);
+
     setWindowTitle("Hyperbolicity Calculator");
     resize(1200, 800);
 
@@ -28,12 +46,91 @@ HyperbolicityApp::HyperbolicityApp(QWidget *parent)
     QHBoxLayout *topLayout = new QHBoxLayout();
 
     algorithmSelector = new QComboBox(this);
+    algorithmSelector->addItem("Auto");
     algorithmSelector->addItem("Exact Algorithm");
     algorithmSelector->addItem("Factor-2 Approximation");
     algorithmSelector->addItem("Log Approximation");
+    algorithmSelector->addItem("Factor-2 Multi-base Approximation");
+    algorithmSelector->addItem("Exact Algorithm (Sharded)");
+    algorithmSelector->addItem("Local Hyperbolicity (k-hop balls)");
+    algorithmSelector->addItem("Local Hyperbolicity (radius balls)");
     topLayout->addWidget(algorithmSelector);
 
-    uploadButton = new QPushButton("Upload Graph File (CSV/JSON)", this);
+    // Multi-base options
+    numBasesSpin = new QSpinBox(this);
+    numBasesSpin->setRange(1, 64);
+    numBasesSpin->setValue(4);
+    numBasesSpin->setPrefix("Bases: ");
+    topLayout->addWidget(numBasesSpin);
+
+    // Sharded exact: local worker processes
+    shardWorkersSpin = new QSpinBox(this);
+    shardWorkersSpin->setRange(1, 64);
+    shardWorkersSpin->setValue(2);
+    shardWorkersSpin->setPrefix("Workers: ");
+    shardWorkersSpin->setToolTip("Sharded exact: worker processes started on this machine");
+    topLayout->addWidget(shardWorkersSpin);
+
+    // Local hyperbolicity: size of the k-hop balls
+    localHopsSpin = new QSpinBox(this);
+    localHopsSpin->setRange(0, 64);
+    localHopsSpin->setValue(2);
+    localHopsSpin->setPrefix("Hops: ");
+    localHopsSpin->setToolTip("Local hyperbolicity: k of the k-hop ball around each vertex");
+    topLayout->addWidget(localHopsSpin);
+
+    // Auto: budgets the planned method must fit
+    timeBudgetSpin = new QSpinBox(this);
+    timeBudgetSpin->setRange(0, 7 * 24 * 3600);
+    timeBudgetSpin->setValue(0);
+    timeBudgetSpin->setSingleStep(60);
+    timeBudgetSpin->setPrefix("Time: ");
+    timeBudgetSpin->setSuffix(" s");
+    timeBudgetSpin->setSpecialValueText("Time: no limit");
+    timeBudgetSpin->setToolTip("Auto: wall-clock budget for the chosen method");
+    topLayout->addWidget(timeBudgetSpin);
+
+    memoryBudgetSpin = new QSpinBox(this);
+    memoryBudgetSpin->setRange(0, 16 * 1024 * 1024);
+    memoryBudgetSpin->setValue(0);
+    memoryBudgetSpin->setSingleStep(1024);
+    memoryBudgetSpin->setPrefix("Memory: ");
+    memoryBudgetSpin->setSuffix(" MB");
+    memoryBudgetSpin->setSpecialValueText("Memory: free RAM");
+    memoryBudgetSpin->setToolTip("Auto: memory budget for the chosen method");
+    topLayout->addWidget(memoryBudgetSpin);
+
+    baseSelector = new QComboBox(this);
+    baseSelector->addItem("Eccentricity");
+    baseSelector->addItem("Centrality");
+    baseSelector->addItem("Random");
+    topLayout->addWidget(baseSelector);
+
+    // Max-min product kernel
+    kernelSelector = new QComboBox(this);
+    kernelSelector->addItem("Auto");
+    kernelSelector->addItem("Dense");
+    kernelSelector->addItem("Threshold Bitset");
+    kernelSelector->setToolTip("Max-min product kernel");
+    topLayout->addWidget(kernelSelector);
+
+    // Vertex numbering the engines run on
+    orderSelector = new QComboBox(this);
+    orderSelector->addItem("Auto");
+    orderSelector->addItem("RCM");
+    orderSelector->addItem("Input");
+    orderSelector->setToolTip("Vertex order: reverse Cuthill-McKee renumbering before APSP (Auto: large components only)");
+    topLayout->addWidget(orderSelector);
+
+    oracleCheck = new QCheckBox("Distance oracle", this);
+    oracleCheck->setToolTip("Log approximation: use landmark labels instead of a dense distance matrix");
+    topLayout->addWidget(oracleCheck);
+
+    pinThreadsCheck = new QCheckBox("Pin threads", this);
+    pinThreadsCheck->setToolTip("Bind each OpenMP thread to one CPU so matrix rows stay on its NUMA node");
+    topLayout->addWidget(pinThreadsCheck);
+
+    uploadButton = new QPushButton("Upload Graph File (CSV/JSON/GTFS)", this);
     topLayout->addWidget(uploadButton);
     connect(uploadButton, &QPushButton::clicked, this, &HyperbolicityApp::uploadFile);
 
@@ -41,15 +138,38 @@ HyperbolicityApp::HyperbolicityApp(QWidget *parent)
     topLayout->addWidget(computeButton);
     connect(computeButton, &QPushButton::clicked, this, &HyperbolicityApp::computeHyperbolicity);
 
+    compareButton = new QPushButton("Compare All", this);
+    compareButton->setToolTip("Exact, Factor-2 and Log on one shared distance matrix");
+    topLayout->addWidget(compareButton);
+    connect(compareButton, &QPushButton::clicked, this, &HyperbolicityApp::compareAllMethods);
+
+    editButton = new QPushButton("Apply Edge Edits", this);
+    editButton->setToolTip("Insert, reweight or remove edges and update delta incrementally");
+    topLayout->addWidget(editButton);
+    connect(editButton, &QPushButton::clicked, this, &HyperbolicityApp::applyEdgeEdits);
+
+    exportButton = new QPushButton("Export...", this);
+    exportButton->setToolTip("Distance matrix (compressed or raw binary) or the results so far as JSON lines");
+    topLayout->addWidget(exportButton);
+    connect(exportButton, &QPushButton::clicked, this, &HyperbolicityApp::exportData);
+
 
 
     mainLayout->addLayout(topLayout);
 
-    graphicsView = new QGraphicsView(this);
-    scene = new QGraphicsScene(this);
-    graphicsView->setScene(scene);
-    graphicsView->setMinimumHeight(400);
-    mainLayout->addWidget(graphicsView);
+    graphView = new GraphView(this);
+    graphView->setMinimumHeight(400);
+    mainLayout->addWidget(graphView);
+    // Emitted from the layout thread, queued onto this one. The message
+    // expires by itself, as a cancelled layout never reports finishing.
+    connect(graphView, &GraphView::layoutProgress, this, [this](int iteration) {
+        statusBar()->showMessage(QString("Laying out graph: iteration %1").arg(iteration), 3000);
+    });
+    connect(graphView, &GraphView::layoutFinished, this, [this](int nodes, int edges, double ms) {
+        statusBar()->clearMessage();
+        logText->append(QString("✅ Layout ready: %1 nodes, %2 edges in %3 s (scroll to zoom, drag to pan)")
+                        .arg(nodes).arg(edges).arg(QString::number(ms / 1000.0, 'f', 2)));
+    });
 
     resultLabel = new QLabel("Hyperbolicity: -", this);
     resultLabel->setStyleSheet("font-size: 16px; font-weight: bold;");
@@ -62,20 +182,20 @@ HyperbolicityApp::HyperbolicityApp(QWidget *parent)
 
 void HyperbolicityApp::uploadFile() {
     QString filePath = QFileDialog::getOpenFileName(this, "Open Graph File", "",
-                                                    "CSV Files (*.csv);;JSON Files (*.json)");
+                                                    "CSV Files (*.csv);;JSON Files (*.json);;GTFS Feeds (stops.txt stop_times.txt)");
     if (!filePath.isEmpty()) {
         logText->append(QString("✅ File Loaded: %1").arg(filePath));
         try {
-            if (graph) delete graph;
-            graph = loadGraph(filePath);
+            // Load first, so a file that fails to parse leaves the current graph in place
+            Graph* loaded = loadGraph(filePath);
+            resetSession();
+            computeCache->invalidate();
+            delete graph;
+            graph = loaded;
             currentGraphFilePath = filePath;
             
-            QSize viewSize = graphicsView->size();
-            QPixmap graphPixmap = drawGraph(graph, viewSize);
-            scene->clear();
-            scene->addPixmap(graphPixmap);
-            graphicsView->fitInView(scene->itemsBoundingRect(), Qt::KeepAspectRatio);
-            logText->append("✅ Graph Loaded Successfully");
+            graphView->setGraph(graph);
+            logText->append("✅ Graph Loaded Successfully. Computing layout...");
         } catch (std::exception &e) {
             logText->append(QString("❌ Error Loading Graph: %1").arg(e.what()));
         }
@@ -83,6 +203,13 @@ void HyperbolicityApp::uploadFile() {
 }
 
 void HyperbolicityApp::computeHyperbolicity() {
+    if (shardWatcher->isRunning()) {
+        // The button reads "Cancel" while a sharded run is going
+        shardCancel->store(true);
+        computeButton->setEnabled(false);
+        logText->append("⏳ Cancelling the sharded run...");
+        return;
+    }
     if (!graph) {
         logText->append("⚠️ Please upload a graph first!");
         return;
@@ -96,27 +223,458 @@ void HyperbolicityApp::computeHyperbolicity() {
                         .arg(method).arg(node_count));
         QApplication::processEvents(); // Allow UI to update
 
-        // Call the backend function (which now includes timing)
-        HyperResult result = ::computeHyperbolicity(graph, method, currentGraphFilePath);
+        HyperResult result;
+        ComputeOptions options = currentOptions();
+        ComputePlan plan;
+        if (method == "Auto") {
+            plan = planComputation(graph, options, computeCache, true);
+            logPlan(plan);
+            if (plan.chosen < 0) {
+                logText->append("❌ No method fits in the memory budget.");
+                return;
+            }
+            const PlanCandidate& pick = plan.candidates[plan.chosen];
+            method = pick.method;
+            options.max_min_backend = pick.max_min_backend;
+            options.use_distance_oracle = pick.use_distance_oracle;
+            options.measure_peak_memory = true;
+        }
+        if (method == "Local Hyperbolicity (radius balls)") {
+            bool ok = false;
+            options.local_radius = QInputDialog::getDouble(this, "Local Hyperbolicity",
+                                                           "Ball radius (graph distance):",
+                                                           options.local_radius, 0.0, 1e12, 3, &ok);
+            if (!ok) {
+                logText->append("⚠️ No ball radius given.");
+                return;
+            }
+        }
+        if (method == "Exact Algorithm (Sharded)") {
+            // Reusing a directory resumes its job; remote workers need it on a shared filesystem
+            QString jobDir = QFileDialog::getExistingDirectory(this, "Job Directory for Shards and Checkpoints");
+            if (jobDir.isEmpty()) {
+                logText->append("⚠️ No job directory chosen.");
+                return;
+            }
+            logText->append(QString("   Job directory: %1 (more workers: hyperbolicity --shard-worker \"%1\")")
+                            .arg(jobDir));
+            double predicted_seconds = 0.0, predicted_bytes = 0.0;
+            if (plan.chosen >= 0) {
+                predicted_seconds = plan.candidates[plan.chosen].seconds;
+                predicted_bytes = plan.candidates[plan.chosen].bytes;
+            }
+            shardCancel = std::make_shared<std::atomic<bool>>(false);
+            setShardedRunning(true);
+            const Graph* shardGraph = graph;
+            std::shared_ptr<std::atomic<bool>> cancel = shardCancel;
+            bool planned = plan.chosen >= 0;
+            shardWatcher->setFuture(QtConcurrent::run([shardGraph, jobDir, options, cancel, planned,
+                                                       predicted_seconds, predicted_bytes]() {
+                ShardedRun run;
+                try {
+                    run.result = computeShardedExact(shardGraph, jobDir, options, cancel.get());
+                    run.result.planned = planned;
+                    run.result.predicted_seconds = predicted_seconds;
+                    run.result.predicted_bytes = predicted_bytes;
+                } catch (std::exception &e) {
+                    run.error = e.what();
+                }
+                return run;
+            }));
+            return;
+        } else {
+            // Call the backend function (which now includes timing)
+            result = ::computeHyperbolicity(graph, method, currentGraphFilePath, options, computeCache);
+        }
 
-        // Display hyperbolicity result
-        resultLabel->setText(QString("Hyperbolicity: %1").arg(result.hyperbolicity));
+        if (plan.chosen >= 0) {
+            result.planned = true;
+            result.predicted_seconds = plan.candidates[plan.chosen].seconds;
+            result.predicted_bytes = plan.candidates[plan.chosen].bytes;
+        }
 
-        // *** LOG COMPLETION WITH TIME from HyperResult ***
-        logText->append(QString("✅ Computation Complete using [%1]. Hyperbolicity: %2")
-                        .arg(method).arg(result.hyperbolicity));
-        logText->append(QString("   Nodes: %1. Total Time: %5 s")
-                        .arg(result.node_order.size()) // Get n from result
-                        .arg(QString::number(result.total_duration_ms/1000000.0, 'f', 7))); // Get duration from result
-        logText->append("----------------------------------------");
+        showResult(result);
 
     } catch (std::exception &e) {
         logText->append(QString("❌ Error Computing Hyperbolicity: %1").arg(e.what()));
     }
 }
 
+void HyperbolicityApp::showResult(const HyperResult& result) {
+    // Display hyperbolicity result
+    resultLabel->setText(QString("Hyperbolicity: %1").arg(result.hyperbolicity));
+    logResult(result);
+    graphView->setHighlight(result.witness);
+    graphView->setVertexValues(result.node_order, result.local_delta);
+    logText->append("----------------------------------------");
+}
+
+void HyperbolicityApp::shardedRunFinished() {
+    ShardedRun run = shardWatcher->result();
+    setShardedRunning(false);
+    if (!run.error.isEmpty()) {
+        logText->append(QString("❌ Error Computing Hyperbolicity: %1").arg(run.error));
+        return;
+    }
+    showResult(run.result);
+}
+
+void HyperbolicityApp::setShardedRunning(bool running) {
+    computeButton->setText(running ? "Cancel Sharded Run" : "Compute Hyperbolicity");
+    computeButton->setEnabled(true);
+    uploadButton->setEnabled(!running);
+    compareButton->setEnabled(!running);
+    editButton->setEnabled(!running);
+    exportButton->setEnabled(!running);
+}
+
+
+
+ComputeOptions HyperbolicityApp::currentOptions() const {
+    ComputeOptions options;
+    options.num_bases = numBasesSpin->value();
+    options.base_selection = baseSelector->currentText();
+    options.max_min_backend = kernelSelector->currentText();
+    options.vertex_order = orderSelector->currentText();
+    options.use_distance_oracle = oracleCheck->isChecked();
+    options.pin_threads = pinThreadsCheck->isChecked();
+    options.shard_workers = shardWorkersSpin->value();
+    options.local_hops = localHopsSpin->value();
+    options.time_budget_s = timeBudgetSpin->value();
+    options.memory_budget_mb = memoryBudgetSpin->value();
+    return options;
+}
+
+void HyperbolicityApp::logResult(const HyperResult& result) {
+    resultLines.append(resultJsonLine(result, currentGraphFilePath));
+    // *** LOG COMPLETION WITH TIME from HyperResult ***
+    logText->append(QString("✅ Computation Complete using [%1]. Hyperbolicity: %2")
+                    .arg(result.method).arg(result.hyperbolicity));
+    logText->append(QString("   Nodes: %1. Total Time: %5 s")
+                    .arg(result.node_order.size()) // Get n from result
+                    .arg(QString::number(result.total_duration_ms/1000000.0, 'f', 7))); // Get duration from result
+    logText->append(QString("   Diameter: %1. Radius: %2 (%3 single-source searches)")
+                    .arg(result.diameter).arg(result.radius).arg(result.eccentricity_searches));
+    if (result.used_distance_oracle) {
+        logText->append(QString("   Distance oracle: built in %1 ms, %2 MB, %3 ns per query")
+                        .arg(result.oracle_build_ms, 0, 'f', 1)
+                        .arg(result.oracle_bytes / (1024.0 * 1024.0), 0, 'f', 2)
+                        .arg(result.oracle_query_ns, 0, 'f', 0));
+        if (!result.oracle_exact) {
+            logText->append("   ⚠️ Labels grew too large: landmark upper bounds replaced exact distances, "
+                            "so the value is an estimate, not the Log approximation guarantee.");
+        }
+    }
+    if (result.huge_page_bytes > 0 || result.memory_counters) {
+        QString counters = result.memory_counters
+            ? QString("%1 dTLB misses, %2 remote-node loads, %3 cache misses")
+                  .arg(result.tlb_misses).arg(result.remote_accesses).arg(result.cache_misses)
+            : QString("hardware counters unavailable");
+        logText->append(QString("   Memory: %1 MB on huge pages, %2")
+                        .arg(result.huge_page_bytes / (1024.0 * 1024.0), 0, 'f', 1)
+                        .arg(counters));
+    }
+    if (!result.vertex_order.isEmpty()) {
+        logText->append(QString("   Vertex order: %1 (mean edge gap %2 in the file, %3 as run; %4 ms)")
+                        .arg(result.vertex_order)
+                        .arg(result.edge_gap_before, 0, 'f', 1)
+                        .arg(result.edge_gap_after, 0, 'f', 1)
+                        .arg(result.order_ms, 0, 'f', 1));
+    }
+    if (result.shards > 0) {
+        logText->append(QString("   Shards: %1 (%2 resumed with %3 checkpointed bases, %4 requeued)")
+                        .arg(result.shards).arg(result.shards_resumed)
+                        .arg(result.bases_resumed).arg(result.shards_requeued));
+    }
+    if (result.reused_distances || result.reused_bases > 0) {
+        logText->append(QString("   Cache: %1, %2 base delta(s) reused")
+                        .arg(result.reused_distances ? "distances reused" : "distances computed")
+                        .arg(result.reused_bases));
+    }
+    if (!result.components.empty()) {
+        logText->append(QString("   Components: %1 (delta is the maximum over components)")
+                        .arg(result.components.size()));
+        const size_t shown = std::min<size_t>(result.components.size(), 10);
+        for (size_t c = 0; c < shown; ++c) {
+            logText->append(QString("     #%1: %2 nodes, delta %3")
+                            .arg(c + 1)
+                            .arg(result.components[c].vertices.size())
+                            .arg(result.components[c].hyperbolicity));
+        }
+        if (shown < result.components.size()) {
+            logText->append(QString("     ... %1 more").arg(result.components.size() - shown));
+        }
+    }
+    if (result.method.startsWith("Factor-2")) {
+        logText->append(QString("   Bounds: %1 <= delta <= %2")
+                        .arg(result.lower_bound).arg(result.upper_bound));
+        if (!result.bases.isEmpty()) {
+            logText->append(QString("   Bases: %1").arg(result.bases.join(", ")));
+        }
+    }
+    if (result.planned) {
+        QString actual_memory = result.peak_bytes > 0
+            ? QString("%1 MB peak").arg(QString::number(result.peak_bytes / (1024.0 * 1024.0), 'f', 1))
+            : QString("memory not measured");
+        logText->append(QString("   Plan: predicted %1 s, %2 MB; actual %3 s, %4")
+                        .arg(QString::number(result.predicted_seconds, 'g', 3))
+                        .arg(QString::number(result.predicted_bytes / (1024.0 * 1024.0), 'f', 1))
+                        .arg(QString::number(result.total_duration_ms / 1000000.0, 'g', 3))
+                        .arg(actual_memory));
+    }
+    logLocalProfile(result);
+    logWitness(result);
+}
+
+void HyperbolicityApp::logPlan(const ComputePlan& plan) {
+    QString time_budget = plan.budget_seconds > 0 ? QString("%1 s").arg(plan.budget_seconds) : QString("no time limit");
+    logText->append(QString("   Planner: %1 threads, budget %2 and %3 MB")
+                    .arg(plan.threads)
+                    .arg(time_budget)
+                    .arg(QString::number(plan.budget_bytes / (1024.0 * 1024.0), 'f', 0)));
+    for (int c = 0; c < plan.candidates.size(); ++c) {
+        const PlanCandidate& candidate = plan.candidates[c];
+        QString name = candidate.method;
+        if (candidate.use_distance_oracle) name += " (distance oracle)";
+        else if (candidate.method != "Log Approximation") name += QString(" [%1]").arg(candidate.max_min_backend);
+        QString fit = !candidate.fits_memory ? "over memory" : !candidate.fits_time ? "over time" : "fits";
+        QString disk = candidate.disk_bytes > 0
+            ? QString(", %1 MB on disk").arg(QString::number(candidate.disk_bytes / (1024.0 * 1024.0), 'f', 0))
+            : QString();
+        logText->append(QString("   %1 %2: %3 s, %4 MB%5 (%6)")
+                        .arg(c == plan.chosen ? "→" : " ")
+                        .arg(name)
+                        .arg(QString::number(candidate.seconds, 'g', 3))
+                        .arg(QString::number(candidate.bytes / (1024.0 * 1024.0), 'f', 1))
+                        .arg(disk)
+                        .arg(fit));
+    }
+}
 
+void HyperbolicityApp::logLocalProfile(const HyperResult& result) {
+    if (result.local_ball.isEmpty()) return;
+    QString ball = result.local_ball == "hops" ? QString("%1 hops").arg(result.local_size)
+                                              : QString("radius %1").arg(result.local_size);
+    logText->append(QString("   Balls: %1 (%2 distinct, %3 settled early, %4 bases evaluated)")
+                    .arg(ball)
+                    .arg(result.local_distinct_balls)
+                    .arg(result.local_settled_early)
+                    .arg(result.local_bases));
+
+    const int n = result.local_delta.size();
+    int tree_like = 0;
+    for (double delta : result.local_delta) {
+        if (delta == 0.0) ++tree_like;
+    }
+    logText->append(QString("   Tree-like balls (delta 0): %1 of %2. Colours: blue = 0, red = %3")
+                    .arg(tree_like).arg(n).arg(result.hyperbolicity));
+
+    // The vertices whose neighbourhoods are furthest from a tree
+    std::vector<int> order(n);
+    for (int v = 0; v < n; ++v) order[v] = v;
+    const int shown = std::min(n, 5);
+    std::partial_sort(order.begin(), order.begin() + shown, order.end(), [&](int a, int b) {
+        return result.local_delta[a] > result.local_delta[b];
+    });
+    for (int s = 0; s < shown && result.local_delta[order[s]] > 0.0; ++s) {
+        logText->append(QString("     %1: delta %2, %3 vertices in its ball")
+                        .arg(result.node_order[order[s]])
+                        .arg(result.local_delta[order[s]])
+                        .arg(result.local_ball_size[order[s]]));
+    }
+}
+
+void HyperbolicityApp::logWitness(const HyperResult& result) {
+    if (result.witness.size() == 4) {
+        logText->append(QString("   Witness: base r = %1, i = %2, j = %3, k = %4 (highlighted)")
+                        .arg(result.witness[0]).arg(result.witness[1]).arg(result.witness[2]).arg(result.witness[3]));
+    } else if (result.witness.size() == 2) {
+        logText->append(QString("   Most distorted pair: %1, %2 (highlighted)")
+                        .arg(result.witness[0]).arg(result.witness[1]));
+    }
+}
+
+void HyperbolicityApp::compareAllMethods() {
+    if (!graph) {
+        logText->append("⚠️ Please upload a graph first!");
+        return;
+    }
+    try {
+        logText->append("----------------------------------------");
+        logText->append(QString("⏳ Comparing Exact, Factor-2 and Log for graph with %1 nodes...")
+                        .arg(graph->nodes.size()));
+        QApplication::processEvents(); // Allow UI to update
+
+        QVector<HyperResult> results = ::compareAllMethods(graph, currentGraphFilePath, currentOptions(),
+                                                           computeCache);
+        long long total_us = 0;
+        for (const HyperResult& result : results) {
+            logResult(result);
+            total_us += result.total_duration_ms;
+        }
+        logText->append(QString("✅ Comparison Complete. Total Time: %1 s")
+                        .arg(QString::number(total_us / 1000000.0, 'f', 7)));
+        for (const HyperResult& result : results) {
+            logText->append(QString("   %1: %2").arg(result.method, -40).arg(result.hyperbolicity));
+            if (result.method == "Exact Algorithm") {
+                resultLabel->setText(QString("Hyperbolicity: %1").arg(result.hyperbolicity));
+                graphView->setHighlight(result.witness);
+                graphView->setVertexValues({}, {});
+            }
+        }
+        logText->append("----------------------------------------");
+    } catch (std::exception &e) {
+        logText->append(QString("❌ Error Comparing Methods: %1").arg(e.what()));
+    }
+}
+
+void HyperbolicityApp::resetSession() {
+    delete session;
+    session = nullptr;
+    sessionKey.clear();
+}
+
+void HyperbolicityApp::applyEdgeEdits() {
+    if (!graph) {
+        logText->append("⚠️ Please upload a graph first!");
+        return;
+    }
+    QString method = algorithmSelector->currentText();
+    if (!DynamicSession::supports(method)) {
+        logText->append(QString("⚠️ Edge edits are supported for the exact and Factor-2 methods, not [%1]").arg(method));
+        return;
+    }
+
+    bool ok = false;
+    QString text = QInputDialog::getMultiLineText(this, "Apply Edge Edits",
+                                                  "One edit per line: source,target,weight\n"
+                                                  "(weight \"inf\" or \"remove\" deletes the edge)",
+                                                  QString(), &ok);
+    if (!ok || text.trimmed().isEmpty()) return;
+
+    QVector<Edge> edits;
+    for (const QString& line : text.split('\n')) {
+        QStringList parts = line.split(',');
+        if (parts.size() != 3) {
+            if (!line.trimmed().isEmpty()) logText->append(QString("⚠️ Skipping malformed edit: %1").arg(line));
+            continue;
+        }
+        QString weight_text = parts[2].trimmed().toLower();
+        double weight = std::numeric_limits<double>::infinity();
+        if (weight_text != "inf" && weight_text != "remove") {
+            bool number = false;
+            weight = weight_text.toDouble(&number);
+            if (!number || weight < 0) {
+                logText->append(QString("⚠️ Skipping edit with invalid weight: %1").arg(line));
+                continue;
+            }
+        }
+        edits.append({parts[0].trimmed(), parts[1].trimmed(), weight});
+    }
+    if (edits.isEmpty()) return;
+
+    try {
+        ComputeOptions options = currentOptions();
+        QString key = QString("%1|%2|%3|%4").arg(method).arg(options.num_bases)
+                          .arg(options.base_selection).arg(options.max_min_backend);
+        if (!session || key != sessionKey) {
+            resetSession();
+            logText->append(QString("⏳ Building incremental state for [%1]...").arg(method));
+            QApplication::processEvents();
+            session = new DynamicSession(graph, method, options);
+            sessionKey = key;
+            logText->append(QString("   Initial state ready in %1 s. Hyperbolicity: %2")
+                            .arg(QString::number(session->result().total_duration_ms / 1000000.0, 'f', 7))
+                            .arg(session->result().hyperbolicity));
+        }
+
+        const HyperResult& result = session->applyEdits(edits);
+        computeCache->invalidate();  // The graph changed under it
+        resultLines.append(resultJsonLine(result, currentGraphFilePath));
+        resultLabel->setText(QString("Hyperbolicity: %1").arg(result.hyperbolicity));
+        logText->append(QString("✅ Applied %1 edge edit(s) using [%2]. Hyperbolicity: %3")
+                        .arg(edits.size()).arg(method).arg(result.hyperbolicity));
+        logText->append(QString("   Update Time: %1 s. Changed distances: %2")
+                        .arg(QString::number(result.total_duration_ms / 1000000.0, 'f', 7))
+                        .arg(result.changed_pairs));
+        logText->append(QString("   Rows patched: %1, rerun: %2. Bases patched: %3, recomputed: %4")
+                        .arg(result.repaired_sources).arg(result.recomputed_sources)
+                        .arg(result.bases_patched).arg(result.bases_recomputed));
+        if (result.full_recompute) {
+            logText->append("   The edits touched too much to repair: distances and bases were recomputed in full.");
+        }
+        if (method.startsWith("Factor-2")) {
+            logText->append(QString("   Bounds: %1 <= delta <= %2")
+                            .arg(result.lower_bound).arg(result.upper_bound));
+        }
+        logWitness(result);
+        logText->append("----------------------------------------");
+
+        graphView->setGraph(graph);
+        graphView->setHighlight(result.witness);
+    } catch (std::exception &e) {
+        resetSession();
+        logText->append(QString("❌ Error Applying Edits: %1").arg(e.what()));
+    }
+}
+
+void HyperbolicityApp::exportData() {
+    const QString matrixFilter = "Compressed Distance Matrix (*.hypd)";
+    const QString rawFilter = "Raw Distance Matrix (*.bin)";
+    const QString resultsFilter = "Results as JSON Lines (*.jsonl)";
+    QString selectedFilter;
+    QString path = QFileDialog::getSaveFileName(this, "Export", "",
+                                                matrixFilter + ";;" + rawFilter + ";;" + resultsFilter,
+                                                &selectedFilter);
+    if (path.isEmpty()) return;
+    if (!path.endsWith(".hypd", Qt::CaseInsensitive) && !path.endsWith(".bin", Qt::CaseInsensitive) &&
+        !path.endsWith(".jsonl", Qt::CaseInsensitive)) {
+        path += selectedFilter == rawFilter ? ".bin" : selectedFilter == resultsFilter ? ".jsonl" : ".hypd";
+    }
+
+    try {
+        if (path.endsWith(".jsonl", Qt::CaseInsensitive)) {
+            if (resultLines.isEmpty()) {
+                logText->append("⚠️ No results to export yet.");
+                return;
+            }
+            QFile file(path);
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+                throw std::runtime_error("Cannot write " + path.toStdString());
+            }
+            for (const QByteArray& line : resultLines) {
+                file.write(line);
+                file.write("\n");
+            }
+            logText->append(QString("✅ Exported %1 result(s) to %2").arg(resultLines.size()).arg(path));
+            return;
+        }
+
+        if (!graph) {
+            logText->append("⚠️ Please upload a graph first!");
+            return;
+        }
+        logText->append(QString("⏳ Exporting the distance matrix of %1 nodes...").arg(graph->nodes.size()));
+        QApplication::processEvents();
+        auto start = std::chrono::steady_clock::now();
+        qint64 bytes = exportDistanceMatrix(graph, path, computeCache);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        logText->append(QString("✅ Distance matrix exported to %1: %2 MB in %3 s (row order in %1.nodes)")
+                        .arg(path)
+                        .arg(QString::number(bytes / (1024.0 * 1024.0), 'f', 1))
+                        .arg(QString::number(seconds, 'f', 2)));
+    } catch (std::exception &e) {
+        logText->append(QString("❌ Error Exporting: %1").arg(e.what()));
+    }
+}
 
 HyperbolicityApp::~HyperbolicityApp() {
+    // The coordinator reads graph; stop it (workers keep their checkpoints) first
+    if (shardWatcher->isRunning()) {
+        shardCancel->store(true);
+        shardWatcher->waitForFinished();
+    }
+    delete session;
+    delete computeCache;
     if (graph) delete graph;
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #-------------------------------------------------
 # Project Configuration
 #-------------------------------------------------
-QT += core gui widgets
+QT += core gui widgets concurrent network
 TARGET = hyperbolicity
 CONFIG += c++17
 
@@ -20,10 +20,26 @@ INCLUDEPATH += ../include
 SOURCES += frontend.cpp \
            backend.cpp \
            GraphParser.cpp \
+           GtfsLoader.cpp \
+           MappedFile.cpp \
            Hyperbolicity.cpp \
            ShortestPath.cpp \
            2Factor.cpp \
            LogApproximation.cpp \
+           Eccentricity.cpp \
+           MaxMinProduct.cpp \
+           Components.cpp \
+           DistanceOracle.cpp \
+           DynamicHyperbolicity.cpp \
+           ForceLayout.cpp \
+           GraphView.cpp \
+           MatrixMemory.cpp \
+           ShardedExact.cpp \
+           MatrixExport.cpp \
+           LocalHyperbolicity.cpp \
+           Planner.cpp \
+           HyperbolicityServer.cpp \
+           VertexOrder.cpp \
            main.cpp
 
 #-------------------------------------------------
@@ -33,10 +49,26 @@ SOURCES += frontend.cpp \
 HEADERS += ../include/frontend.h \
            ../include/backend.h \
            ../include/GraphParser.h \
+           ../include/GtfsLoader.h \
+           ../include/MappedFile.h \
            ../include/Hyperbolicity.h \
            ../include/ShortestPath.h \
            ../include/2Factor.h \
-           ../include/LogApproximation.h
+           ../include/LogApproximation.h \
+           ../include/Eccentricity.h \
+           ../include/MaxMinProduct.h \
+           ../include/Components.h \
+           ../include/DistanceOracle.h \
+           ../include/DynamicHyperbolicity.h \
+           ../include/ForceLayout.h \
+           ../include/GraphView.h \
+           ../include/MatrixMemory.h \
+           ../include/ShardedExact.h \
+           ../include/MatrixExport.h \
+           ../include/LocalHyperbolicity.h \
+           ../include/Planner.h \
+           ../include/HyperbolicityServer.h \
+           ../include/VertexOrder.h
 
 #-------------------------------------------------
 # Platform-Specific Settings
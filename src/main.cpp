@@ -1,8 +1,23 @@
 #include <QApplication>
+#include <QCoreApplication>
+#include <cstring>
 #include "frontend.h"
+#include "backend.h"
+#include "HyperbolicityServer.h"
 
 int main(int argc, char *argv[])
 {
+    // Headless worker for sharded exact runs; no display needed
+    if (argc > 1 && std::strcmp(argv[1], "--shard-worker") == 0) {
+        QCoreApplication app(argc, argv);
+        return runShardWorker(app.arguments());
+    }
+    // Long-running service over a local socket; no display needed either
+    if (argc > 1 && std::strcmp(argv[1], "--serve") == 0) {
+        QCoreApplication app(argc, argv);
+        return runServer(app.arguments());
+    }
+
     QApplication app(argc, argv);
     HyperbolicityApp window;
     window.show();